@@ -298,6 +298,8 @@ $(MOC_SRC_FULL): $(GEN_SRC_PATH)/moc_%.cpp: $(SOURCES_PATH)/%.h
 	@$(QT_INSTALL_BINS)/moc -o $@ $<
 
 # Generate resource source.
+# The Tcl scripts are embedded as text, so they must trigger a rebuild.
+$(RES_SRC_FULL): $(wildcard $(RESOURCES_PATH)/tcl/*.tcl)
 $(RES_SRC_FULL): $(GEN_SRC_PATH)/qrc_%.cpp: $(RESOURCES_PATH)/%.qrc
 	@echo "Generating $(@F)..."
 	@mkdir -p $(@D)
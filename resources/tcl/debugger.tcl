@@ -0,0 +1,614 @@
+# Procs the debugger defines in openMSX for its own use when it connects.
+# The whole file is sent as a single command.
+
+# 'debug_bin2hex': the bytes of a binary string as hex digits
+proc debug_bin2hex { input } {
+  set result ""
+  foreach i [split $input {}] {
+    append result [format %02X [scan $i %c]] ""
+  }
+  return $result
+}
+
+# 'debug_hex2bin': the reverse of debug_bin2hex
+proc debug_hex2bin { input } {
+  set result ""
+  foreach {h l} [split $input {}] {
+    append result [binary format H2 $h$l] ""
+  }
+  return $result
+}
+
+# 'debug_memmapper': the selected slots, mapper segments and ROM blocks
+proc debug_memmapper { } {
+  set result ""
+  for { set page 0 } { $page < 4 } { incr page } {
+    set tmp [get_selected_slot $page]
+    append result [lindex $tmp 0] [lindex $tmp 1] "\n"
+    if { [lsearch [debug list] "MapperIO"] != -1} {
+      append result [debug read "MapperIO" $page] "\n"
+    } else {
+      append result "0\n"
+    }
+  }
+  for { set ps 0 } { $ps < 4 } { incr ps } {
+    if [machine_info issubslotted $ps] {
+      append result "1\n"
+      for { set ss 0 } { $ss < 4 } { incr ss } {
+        append result [get_mapper_size $ps $ss] "\n"
+      }
+    } else {
+      append result "0\n"
+      append result [get_mapper_size $ps 0] "\n"
+    }
+  }
+  for { set page 0 } { $page < 4 } { incr page } {
+    set tmp [get_selected_slot $page]
+    set ss [lindex $tmp 1]
+    if { $ss == "X" } { set ss 0 }
+    set device_list [machine_info slot [lindex $tmp 0] $ss $page]
+    set name "[lindex $device_list 0] romblocks"
+    if { [lsearch [debug list] $name] != -1} {
+      append result "[debug read $name [expr {$page * 0x4000}] ]\n"
+      append result "[debug read $name [expr {$page * 0x4000 + 0x2000}] ]\n"
+    } else {
+      append result "X\nX\n"
+    }
+  }
+  return $result
+}
+
+# 'debug_list_all_breaks': all breakpoints, watchpoints and conditions
+proc debug_list_all_breaks { } {
+  set result [debug list_bp]
+  append result [debug list_watchpoints]
+  append result [debug list_conditions]
+  return $result
+}
+
+# 'debug_list_break': the line of one breakpoint, watchpoint or condition
+proc debug_list_break { id } {
+  if {[string match bp#* $id]} {
+    set list [debug list_bp]
+  } elseif {[string match wp#* $id]} {
+    set list [debug list_watchpoints]
+  } else {
+    set list [debug list_conditions]
+  }
+  foreach line [split $list "\n"] {
+    if {[lindex [split $line] 0] eq $id} { return $line }
+  }
+  return ""
+}
+
+# 'debug_set_breaks': run a list of set commands, returns the new ids
+# (empty for the ones that failed)
+proc debug_set_breaks { cmds } {
+  set ids [list]
+  foreach cmd $cmds {
+    if {[catch {eval $cmd} id]} { set id "" }
+    lappend ids $id
+  }
+  return $ids
+}
+
+# 'debug_profile_*' procs for the sampling profiler: samples are
+# counted per 'pc:slot:subslot:segment' until they are fetched
+proc debug_profile_start { interval } {
+  global debug_profile_interval debug_profile_mapper
+  debug_profile_stop
+  set debug_profile_interval $interval
+  set debug_profile_mapper [expr {[lsearch [debug list] "MapperIO"] != -1}]
+  debug_profile_sample
+}
+proc debug_profile_sample { } {
+  global debug_profile_samples debug_profile_interval debug_profile_mapper debug_profile_after
+  set pc [reg pc]
+  set page [expr {$pc >> 14}]
+  set slot [get_selected_slot $page]
+  set seg [expr {$debug_profile_mapper ? [debug read "MapperIO" $page] : 0}]
+  incr debug_profile_samples($pc:[lindex $slot 0]:[lindex $slot 1]:$seg)
+  set debug_profile_after [after time $debug_profile_interval debug_profile_sample]
+}
+proc debug_profile_stop { } {
+  global debug_profile_after
+  if {[info exists debug_profile_after]} {
+    after cancel $debug_profile_after
+    unset debug_profile_after
+  }
+}
+proc debug_profile_fetch { } {
+  global debug_profile_samples
+  set result [array get debug_profile_samples]
+  array unset debug_profile_samples
+  return $result
+}
+
+# 'debug_iprof_*' procs for the instrumenting profiler: routine
+# entries push a frame on a shadow stack, frames are popped (and their
+# time is accumulated per call path) once the stack pointer passes them.
+# Only entries through a CALL or RST to the routine push a frame. On
+# other entries, such as a JP or a tail call, the word at SP is not a
+# return address. The time of such an entry stays with the frame that
+# jumped there, and it returns through that frame's return address.
+proc debug_iprof_start { addrs } {
+  global debug_iprof_bps debug_iprof_stack debug_iprof_stats
+  debug_iprof_stop
+  array unset debug_iprof_stats
+  set debug_iprof_stack [list]
+  set debug_iprof_bps [list]
+  foreach addr $addrs {
+    lappend debug_iprof_bps [debug set_bp $addr {} [list debug_iprof_enter $addr]]
+  }
+}
+proc debug_iprof_enter { addr } {
+  global debug_iprof_stack debug_iprof_ret
+  set sp [reg sp]
+  set ret [peek16 $sp]
+  if {![debug_iprof_called $addr $ret]} return
+  set now [machine_info time]
+  debug_iprof_unwind $sp $now
+  if {![info exists debug_iprof_ret($ret)]} {
+    set debug_iprof_ret($ret) [debug set_bp $ret {} debug_iprof_return]
+  }
+  set path "[lindex [lindex $debug_iprof_stack end] 0]/$addr"
+  lappend debug_iprof_stack [list $path $sp $now 0.0]
+}
+proc debug_iprof_called { addr ret } {
+  set op [peek [expr {($ret - 3) & 0xffff}]]
+  if {($op == 0xcd || ($op & 0xc7) == 0xc4) &&
+      [peek16 [expr {($ret - 2) & 0xffff}]] == $addr} { return 1 }
+  set op [peek [expr {($ret - 1) & 0xffff}]]
+  return [expr {($op & 0xc7) == 0xc7 && ($op & 0x38) == $addr}]
+}
+proc debug_iprof_return { } {
+  debug_iprof_unwind [expr {[reg sp] - 1}] [machine_info time]
+}
+proc debug_iprof_unwind { limit now } {
+  global debug_iprof_stack debug_iprof_stats
+  while {[llength $debug_iprof_stack]} {
+    lassign [lindex $debug_iprof_stack end] path sp start child
+    if {$sp > $limit} break
+    set debug_iprof_stack [lrange $debug_iprof_stack 0 end-1]
+    set incl [expr {$now - $start}]
+    if {[info exists debug_iprof_stats($path)]} {
+      lassign $debug_iprof_stats($path) calls tincl texcl tmax
+    } else {
+      lassign {0 0.0 0.0 0.0} calls tincl texcl tmax
+    }
+    set debug_iprof_stats($path) [list [incr calls] [expr {$tincl + $incl}]\
+      [expr {$texcl + $incl - $child}] [expr {max($tmax, $incl)}]]
+    if {[llength $debug_iprof_stack]} {
+      lset debug_iprof_stack end 3 [expr {[lindex $debug_iprof_stack end 3] + $incl}]
+    }
+  }
+}
+proc debug_iprof_stop { } {
+  global debug_iprof_bps debug_iprof_ret
+  if {[info exists debug_iprof_bps]} {
+    foreach id $debug_iprof_bps { catch {debug remove_bp $id} }
+    unset debug_iprof_bps
+  }
+  foreach {ret id} [array get debug_iprof_ret] { catch {debug remove_bp $id} }
+  array unset debug_iprof_ret
+}
+proc debug_iprof_fetch { } {
+  global debug_iprof_stats
+  set result ""
+  foreach path [array names debug_iprof_stats] {
+    append result $path " " $debug_iprof_stats($path) "\n"
+  }
+  return $result
+}
+
+# 'debug_heat_*' procs for the memory access heatmap: two range
+# watchpoints count the accesses per block of 2^shift bytes, the fetch
+# returns the shift along with the counts
+proc debug_heat_start { first last shift } {
+  global debug_heat_wps debug_heat_shift debug_heat_r debug_heat_w
+  debug_heat_stop
+  array unset debug_heat_r
+  array unset debug_heat_w
+  set debug_heat_shift $shift
+  set debug_heat_wps [list \
+    [debug set_watchpoint read_mem [list $first $last] {} {debug_heat_count r}] \
+    [debug set_watchpoint write_mem [list $first $last] {} {debug_heat_count w}]]
+}
+proc debug_heat_count { type } {
+  incr ::debug_heat_${type}([expr {$::wp_last_address >> $::debug_heat_shift}])
+}
+proc debug_heat_stop { } {
+  global debug_heat_wps
+  if {[info exists debug_heat_wps]} {
+    foreach id $debug_heat_wps { catch {debug remove_watchpoint $id} }
+    unset debug_heat_wps
+  }
+}
+proc debug_heat_fetch { } {
+  global debug_heat_shift debug_heat_r debug_heat_w
+  return [list $debug_heat_shift [array get debug_heat_r] [array get debug_heat_w]]
+}
+
+# 'debug_cov_*' procs for code coverage: a condition marks the
+# address of every executed instruction in a bitset per 16kB region
+proc debug_cov_start { } {
+  global debug_cov_bits debug_cov_dirty debug_cov_kind
+  debug_cov_stop
+  array unset debug_cov_bits
+  array unset debug_cov_dirty
+  array unset debug_cov_kind
+  set ::debug_cov_cond [debug set_condition {[debug_cov_hit]} {}]
+}
+proc debug_cov_stop { } {
+  if {[info exists ::debug_cov_cond]} {
+    catch {debug remove_condition $::debug_cov_cond}
+    unset ::debug_cov_cond
+  }
+}
+proc debug_cov_region_kind { ps ss page } {
+  if {$ss eq "X"} { set ss 0 }
+  if {[get_mapper_size $ps $ss] > 0} { return m }
+  set name "[lindex [machine_info slot $ps $ss $page] 0] romblocks"
+  if {[lsearch [debug list] $name] != -1} { return [list r $name] }
+  return p
+}
+proc debug_cov_hit { } {
+  set pc [reg pc]
+  set page [expr {$pc >> 14}]
+  set slot [get_selected_slot $page]
+  set id "[lindex $slot 0]:[lindex $slot 1]"
+  upvar #0 debug_cov_kind($id:$page) kind
+  if {![info exists kind]} { set kind [debug_cov_region_kind {*}$slot $page] }
+  switch -- [lindex $kind 0] {
+    m { set key $id:m[debug read MapperIO $page] }
+    r { set key $id:r[debug read [lindex $kind 1] $pc] }
+    default { set key $id:p$page }
+  }
+  upvar #0 debug_cov_bits($key) bits
+  if {![info exists bits]} { set bits [binary format x2048] }
+  set offset [expr {$pc & 0x3FFF}]
+  set i [expr {$offset >> 3}]
+  binary scan $bits @${i}cu byte
+  set mask [expr {1 << ($offset & 7)}]
+  if {!($byte & $mask)} {
+    set bits [binary format a*ca* [string range $bits 0 $i-1]\
+      [expr {$byte | $mask}] [string range $bits $i+1 end]]
+    set ::debug_cov_dirty($key) 1
+  }
+  return 0
+}
+proc debug_cov_fetch { } {
+  global debug_cov_bits debug_cov_dirty
+  set result ""
+  foreach key [array names debug_cov_dirty] {
+    binary scan $debug_cov_bits($key) H* hex
+    append result $key " " $hex "\n"
+  }
+  array unset debug_cov_dirty
+  return $result
+}
+
+# 'debug_frame_*' procs for the frame budget: every VBLANK
+# interrupt closes the record of the previous frame
+proc debug_frame_start { entry exit idle } {
+  debug_frame_stop
+  set ::debug_frame_records [list]
+  unset -nocomplain ::debug_frame_begin ::debug_frame_isrbegin
+  set ::debug_frame_bps [list [debug set_bp $entry {} debug_frame_isr]\
+    [debug set_bp $idle {} debug_frame_idle]]
+  if {$exit ne ""} {
+    lappend ::debug_frame_bps [debug set_bp $exit {} debug_frame_isr_exit]
+  }
+}
+proc debug_frame_stop { } {
+  if {[info exists ::debug_frame_bps]} {
+    foreach id $::debug_frame_bps { catch {debug remove_bp $id} }
+    unset ::debug_frame_bps
+  }
+}
+proc debug_frame_isr { } {
+  set now [machine_info time]
+  if {[debug read "VDP status regs" 0] & 0x80} {
+    if {[info exists ::debug_frame_begin]} {
+      lappend ::debug_frame_records [list [expr {$now - $::debug_frame_begin}]\
+        $::debug_frame_busy $::debug_frame_isr]
+    }
+    set ::debug_frame_begin $now
+    set ::debug_frame_busy -1
+    set ::debug_frame_isr 0.0
+  }
+  set ::debug_frame_isrbegin $now
+}
+proc debug_frame_isr_exit { } {
+  if {![info exists ::debug_frame_isrbegin] || ![info exists ::debug_frame_begin]} return
+  set ::debug_frame_isr [expr {$::debug_frame_isr + [machine_info time] - $::debug_frame_isrbegin}]
+  unset ::debug_frame_isrbegin
+}
+proc debug_frame_idle { } {
+  if {[info exists ::debug_frame_begin] && $::debug_frame_busy == -1} {
+    set ::debug_frame_busy [expr {[machine_info time] - $::debug_frame_begin}]
+  }
+}
+proc debug_frame_fetch { } {
+  set result $::debug_frame_records
+  set ::debug_frame_records [list]
+  return $result
+}
+
+# 'debug_io_*' procs for the I/O port profiler: counts are kept
+# per port (the low byte of the I/O address), the counts of the current
+# frame are folded into totals and peaks on every frame
+proc debug_io_start { values } {
+  global debug_io_wps debug_io_after debug_io_values debug_io_frames
+  debug_io_stop
+  array unset ::debug_io_cur
+  array unset ::debug_io_total
+  array unset ::debug_io_peak
+  set debug_io_values $values
+  set debug_io_frames 0
+  set debug_io_wps [list \
+    [debug set_watchpoint read_io {0 255} {} {debug_io_count r}] \
+    [debug set_watchpoint write_io {0 255} {} {debug_io_count w}]]
+  set debug_io_after [after frame debug_io_frame]
+}
+proc debug_io_count { type } {
+  set key $type:[expr {$::wp_last_address & 0xff}]
+  if {$::debug_io_values && $type eq "w"} { append key :$::wp_last_value }
+  incr ::debug_io_cur($key)
+}
+proc debug_io_fold { } {
+  global debug_io_cur debug_io_total debug_io_peak
+  incr ::debug_io_frames
+  foreach {key n} [array get debug_io_cur] {
+    incr debug_io_total($key) $n
+    if {![info exists debug_io_peak($key)] || $n > $debug_io_peak($key)} {
+      set debug_io_peak($key) $n
+    }
+  }
+  array unset debug_io_cur
+}
+proc debug_io_frame { } {
+  debug_io_fold
+  set ::debug_io_after [after frame debug_io_frame]
+}
+proc debug_io_stop { } {
+  global debug_io_wps debug_io_after
+  if {[info exists debug_io_wps]} {
+    foreach id $debug_io_wps { catch {debug remove_watchpoint $id} }
+    unset debug_io_wps
+  }
+  if {[info exists debug_io_after]} {
+    after cancel $debug_io_after
+    unset debug_io_after
+    debug_io_fold
+  }
+}
+proc debug_io_fetch { } {
+  global debug_io_total debug_io_peak
+  if {![info exists ::debug_io_frames]} { return 0 }
+  set result [list $::debug_io_frames]
+  foreach {key n} [array get debug_io_total] {
+    lappend result [list $key $n $debug_io_peak($key)]
+  }
+  set ::debug_io_frames 0
+  array unset debug_io_total
+  array unset debug_io_peak
+  return $result
+}
+
+# 'debug_ring_*' procs: a ring buffer of 'size' records in the global
+# array 'ring'. A fetch returns the number of records that were
+# overwritten since the previous fetch, followed by the records added since
+# then.
+proc debug_ring_start { ring size } {
+  upvar #0 $ring r
+  array unset r
+  array set r [list size $size next 0 read 0]
+}
+proc debug_ring_add { ring rec } {
+  upvar #0 $ring r
+  set r([expr {$r(next) % $r(size)}]) $rec
+  incr r(next)
+}
+proc debug_ring_fetch { ring } {
+  upvar #0 $ring r
+  if {![info exists r(next)]} { return 0 }
+  set first [expr {max($r(read), $r(next) - $r(size))}]
+  set result [list [expr {$first - $r(read)}]]
+  for {set i $first} {$i != $r(next)} {incr i} {
+    lappend result $r([expr {$i % $r(size)}])
+  }
+  set r(read) $r(next)
+  return $result
+}
+
+# 'debug_trace_*' procs for tracepoints: every hit stores a record in a
+# ring buffer of 'size' entries
+proc debug_trace_start { size } {
+  debug_trace_stop
+  debug_ring_start debug_trace_ring $size
+}
+proc debug_trace_add { id addr cond regs mem count } {
+  debug_trace_remove $id
+  set ::debug_trace_def($id) [list $regs $mem $count]
+  set ::debug_trace_bp($id) [debug set_bp $addr $cond [list debug_trace_hit $id]]
+}
+proc debug_trace_remove { id } {
+  if {[info exists ::debug_trace_bp($id)]} {
+    catch {debug remove_bp $::debug_trace_bp($id)}
+    unset ::debug_trace_bp($id)
+  }
+}
+proc debug_trace_stop { } {
+  foreach id [array names ::debug_trace_bp] { debug_trace_remove $id }
+}
+proc debug_trace_hit { id } {
+  lassign $::debug_trace_def($id) regs mem count
+  set rec [list $id [machine_info time] [reg pc]]
+  foreach r $regs { lappend rec [reg $r] }
+  if {$count > 0} {
+    set addr [expr {[expr $mem] & 0xffff}]
+    set count [expr {min($count, 0x10000 - $addr)}]
+    binary scan [debug read_block memory $addr $count] H* hex
+    lappend rec $hex
+  }
+  debug_ring_add debug_trace_ring $rec
+}
+proc debug_trace_fetch { } {
+  return [debug_ring_fetch debug_trace_ring]
+}
+
+# 'debug_itrace_*' procs for the instruction trace: a condition
+# stores a 32 byte binary record per instruction in a ring buffer, the
+# fetch returns the number of lost records and the new ones as one hex
+# string
+proc debug_itrace_start { size } {
+  debug_itrace_stop
+  debug_ring_start debug_itrace_ring $size
+  set ::debug_itrace_mapper [expr {[lsearch [debug list] "MapperIO"] != -1}]
+  set ::debug_itrace_cond [debug set_condition {[debug_itrace_step]} {}]
+}
+proc debug_itrace_record { } {
+  set regs [debug read_block "CPU regs" 0 24]
+  binary scan $regs @20Su pc
+  set page [expr {$pc >> 14}]
+  lassign [get_selected_slot $page] ps ss
+  set slot [expr {$ss eq "X" ? $ps | 0x80 : $ps | ($ss << 2)}]
+  set seg [expr {$::debug_itrace_mapper ? [debug read MapperIO $page] : 0}]
+  set op [debug read_block memory $pc [expr {min(4, 0x10000 - $pc)}]]
+  return [binary format a24a4ccx2 $regs $op $slot $seg]
+}
+proc debug_itrace_step { } {
+  debug_ring_add debug_itrace_ring [debug_itrace_record]
+  return 0
+}
+proc debug_itrace_stop { } {
+  if {[info exists ::debug_itrace_cond]} {
+    catch {debug remove_condition $::debug_itrace_cond}
+    unset ::debug_itrace_cond
+  }
+}
+proc debug_itrace_fetch { } {
+  set records [debug_ring_fetch debug_itrace_ring]
+  binary scan [join [lrange $records 1 end] {}] H* hex
+  return "[lindex $records 0] $hex"
+}
+
+# 'debug_step_*' procs for batched stepping: a condition counts
+# the instructions and breaks after the last one. Conditions are not
+# checked for the first instruction after 'debug cont', so the n-th
+# check comes after n instructions. With 'trace' set the registers
+# before every step are kept in the instruction trace record format.
+proc debug_step_n { n trace } {
+  debug_step_cancel
+  set ::debug_step_left $n
+  set ::debug_step_trace $trace
+  set ::debug_step_records {}
+  if {$trace} {
+    set ::debug_itrace_mapper [expr {[lsearch [debug list] "MapperIO"] != -1}]
+    append ::debug_step_records [debug_itrace_record]
+  }
+  if {$n == 1} {
+    debug step
+  } else {
+    set ::debug_step_cond [debug set_condition {[debug_step_check]} debug_step_done]
+    debug cont
+  }
+}
+proc debug_step_check { } {
+  if {[incr ::debug_step_left -1] == 0} { return 1 }
+  if {$::debug_step_trace} { append ::debug_step_records [debug_itrace_record] }
+  return 0
+}
+proc debug_step_done { } {
+  debug_step_cancel
+  debug break
+}
+proc debug_step_cancel { } {
+  if {[info exists ::debug_step_cond]} {
+    catch {debug remove_condition $::debug_step_cond}
+    unset ::debug_step_cond
+  }
+}
+proc debug_step_end { } {
+  debug_step_cancel
+  if {![info exists ::debug_step_records]} { return {} }
+  binary scan $::debug_step_records H* hex
+  set ::debug_step_records {}
+  return $hex
+}
+
+# 'debug_vwrite_*' procs for the VRAM write map: watchpoints on
+# the VDP ports mark written blocks per frame, and separately since the
+# last 'debug_vwrite_read' for the live view of the VDP data store
+proc debug_vwrite_start { shift } {
+  global debug_vwrite_wps debug_vwrite_after debug_vwrite_shift
+  debug_vwrite_stop
+  array unset ::debug_vwrite_cur
+  array unset ::debug_vwrite_pending
+  set debug_vwrite_shift $shift
+  set ::debug_vwrite_frames [list]
+  set ::debug_vwrite_full 1
+  set debug_vwrite_wps [list \
+    [debug set_watchpoint write_io 0x98 {} debug_vwrite_mark] \
+    [debug set_watchpoint write_io {0x99 0x9b} {} debug_vwrite_command]]
+  set debug_vwrite_after [after frame debug_vwrite_frame]
+}
+proc debug_vwrite_mark { } {
+  binary scan [debug read_block {VRAM pointer} 0 2] s pointer
+  set address [expr {([debug read {VDP regs} 14] << 14) | ($pointer & 0x3fff)}]
+  if {([debug read {VDP regs} 0] & 0x0a) == 0x0a} {
+    set address [expr {($address >> 1) | (($address & 1) << 16)}]
+  }
+  set block [expr {$address >> $::debug_vwrite_shift}]
+  set ::debug_vwrite_cur($block) 1
+  set ::debug_vwrite_pending($block) 1
+}
+proc debug_vwrite_command { } {
+  if {$::wp_last_address == 0x9b || $::wp_last_value == 0xae} {
+    set ::debug_vwrite_full 1
+  }
+}
+proc debug_vwrite_frame { } {
+  lappend ::debug_vwrite_frames [lsort -integer [array names ::debug_vwrite_cur]]
+  set ::debug_vwrite_frames [lrange $::debug_vwrite_frames end-999 end]
+  array unset ::debug_vwrite_cur
+  set ::debug_vwrite_after [after frame debug_vwrite_frame]
+}
+proc debug_vwrite_stop { } {
+  global debug_vwrite_wps debug_vwrite_after
+  if {[info exists debug_vwrite_wps]} {
+    foreach id $debug_vwrite_wps { catch {debug remove_watchpoint $id} }
+    unset debug_vwrite_wps
+  }
+  if {[info exists debug_vwrite_after]} {
+    after cancel $debug_vwrite_after
+    unset debug_vwrite_after
+  }
+}
+proc debug_vwrite_fetch { } {
+  set result $::debug_vwrite_frames
+  set ::debug_vwrite_frames [list]
+  return $result
+}
+proc debug_vwrite_read { vram size tail } {
+  if {$::debug_vwrite_full} {
+    set ::debug_vwrite_full 0
+    array unset ::debug_vwrite_pending
+    return [list all [debug_bin2hex [debug read_block $vram 0 $size]]$tail]
+  }
+  set blocks [lsort -integer [array names ::debug_vwrite_pending]]
+  array unset ::debug_vwrite_pending
+  set length [expr {1 << $::debug_vwrite_shift}]
+  set data {}
+  foreach block $blocks {
+    append data [debug read_block $vram [expr {$block << $::debug_vwrite_shift}] $length]
+  }
+  return [list $blocks [debug_bin2hex $data]$tail]
+}
+
+# 'debug_check_debuggables': for each name, whether that debuggable exists
+proc debug_check_debuggables { debuggables } {
+  set all_debuggables [debug list]
+  lmap x $debuggables {expr {[lsearch $all_debuggables $x] >= 0}}
+}
@@ -0,0 +1,69 @@
+#include "AccessHeatmap.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+// no periodic fetch, the counts are only transferred when stopping
+AccessHeatmap::AccessHeatmap(QObject* parent)
+	: PolledCollector("heat", 0, parent)
+{
+}
+
+void AccessHeatmap::start(uint16_t first, uint16_t last, int blockSize)
+{
+	int blockShift = 0;
+	while ((1 << blockShift) < blockSize) ++blockShift;
+	startCollecting(QString("%1 %2 %3").arg(first).arg(last).arg(blockShift));
+}
+
+void AccessHeatmap::clear()
+{
+	reads.clear();
+	writes.clear();
+	std::fill(std::begin(peakCount), std::end(peakCount), 0);
+	emit updated();
+}
+
+void AccessHeatmap::processReply(const QString& message)
+{
+	// reply is "shift {block count ...} {block count ...}" for reads and
+	// writes; a newer recording with another block size may have started
+	bool ok;
+	int blockShift = message.section(' ', 0, 0).toInt(&ok);
+	if (!ok || blockShift < 0 || blockShift > 16) return;
+	shift = blockShift;
+	reads.assign(0x10000 >> shift, 0);
+	writes.assign(0x10000 >> shift, 0);
+	std::fill(std::begin(peakCount), std::end(peakCount), 0);
+
+	std::vector<uint32_t>* targets[] = {&reads, &writes};
+	QRegExp group("\\{([^}]*)\\}");
+	int pos = 0;
+	for (auto* target : targets) {
+		pos = group.indexIn(message, pos);
+		if (pos == -1) break;
+		pos += group.matchedLength();
+		auto words = group.cap(1).split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+		for (int i = 0; i + 1 < words.size(); i += 2) {
+			unsigned block = words[i].toUInt();
+			if (block < target->size()) (*target)[block] = words[i + 1].toUInt();
+		}
+	}
+
+	for (size_t i = 0; i < reads.size(); ++i) {
+		peakCount[READS] = std::max(peakCount[READS], reads[i]);
+		peakCount[WRITES] = std::max(peakCount[WRITES], writes[i]);
+		peakCount[ACCESSES] = std::max(peakCount[ACCESSES], reads[i] + writes[i]);
+	}
+	emit updated();
+}
+
+uint32_t AccessHeatmap::count(uint16_t address, Kind kind) const
+{
+	if (reads.empty()) return 0;
+	unsigned block = address >> shift;
+	uint32_t result = 0;
+	if (kind & READS) result += reads[block];
+	if (kind & WRITES) result += writes[block];
+	return result;
+}
@@ -0,0 +1,42 @@
+#ifndef ACCESSHEATMAP_H
+#define ACCESSHEATMAP_H
+
+#include "PolledCollector.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Read and write counts per memory block (or per byte) over a recording
+ * window. While recording, two non-breaking range watchpoints in openMSX
+ * increment Tcl counters; the counts are only transferred once, when the
+ * recording stops.
+ */
+class AccessHeatmap : public PolledCollector
+{
+	Q_OBJECT
+public:
+	enum Kind { READS = 1, WRITES = 2, ACCESSES = READS | WRITES };
+
+	AccessHeatmap(QObject* parent = nullptr);
+
+	// blockSize must be a power of two
+	void start(uint16_t first, uint16_t last, int blockSize);
+	void clear();
+	[[nodiscard]] bool isEmpty() const { return peakCount[ACCESSES] == 0; }
+
+	[[nodiscard]] uint32_t count(uint16_t address, Kind kind) const;
+	[[nodiscard]] uint32_t peak(Kind kind) const { return peakCount[kind]; }
+
+signals:
+	void updated();
+
+private:
+	void processReply(const QString& message) override;
+
+	std::vector<uint32_t> reads;
+	std::vector<uint32_t> writes;
+	uint32_t peakCount[4] = {};
+	int shift = 8; // of the counts in reads and writes
+};
+
+#endif // ACCESSHEATMAP_H
@@ -1,7 +1,9 @@
 #include "BitMapViewer.h"
 #include "PaletteDialog.h"
 #include "VramBitMappedView.h"
+#include "VramOverview.h"
 #include "VDPDataStore.h"
+#include "VDPLiveControl.h"
 #include "Convert.h"
 #include <QMessageBox>
 
@@ -26,6 +28,7 @@ BitMapViewer::BitMapViewer(QWidget* parent)
     connect(editPaletteButton, &QPushButton::clicked, this, &BitMapViewer::on_editPaletteButton_clicked);
     connect(useVDPPalette, &QCheckBox::stateChanged, this, &BitMapViewer::on_useVDPPalette_stateChanged);
     connect(zoomLevel, qOverload<double>(&QDoubleSpinBox::valueChanged), this, &BitMapViewer::on_zoomLevel_valueChanged);
+    connect(showAllPages, &QCheckBox::stateChanged, this, &BitMapViewer::on_showAllPages_stateChanged);
 
 	// hand code entering the actual display widget in the scrollarea With
 	// the designer-qt4 there is an extra scrollAreaWidget between the
@@ -51,6 +54,13 @@ BitMapViewer::BitMapViewer(QWidget* parent)
 	// Palette data not received from VDPDataStore yet causing black image, so
 	// we start by using fixed palette until VDPDataStoreDataRefreshed kicks in.
 	imageWidget->setPaletteSource(VDPDataStore::instance().getDefaultPalettePointer());
+
+	// the overview decodes with the settings of the image widget, and
+	// follows it whenever that one decodes again
+	overview = new VramOverview(*imageWidget, this);
+	overview->hide();
+	overview->setVramSource(vram);
+	connect(imageWidget, &VramBitMappedView::imageChanged, overview, &VramOverview::refresh);
 	
 	// now hook up some signals and slots
 	connect(&VDPDataStore::instance(), &VDPDataStore::dataRefreshed,
@@ -59,6 +69,11 @@ BitMapViewer::BitMapViewer(QWidget* parent)
 	        imageWidget, &VramBitMappedView::refresh);
 	connect(refreshButton, &QPushButton::clicked,
 	        &VDPDataStore::instance(), &VDPDataStore::refresh);
+	auto* liveControl = new VDPLiveControl();
+	liveControl->setCaptureSource([this] { return imageWidget->frame(); });
+	delete liveControl_widget->parentWidget()->layout()->replaceWidget(
+	        liveControl_widget, liveControl);
+	delete liveControl_widget;
 
 	connect(imageWidget, &VramBitMappedView::imageHovered,
 	        this, &BitMapViewer::updateImagePosition);
@@ -200,6 +215,7 @@ void BitMapViewer::setPages()
 	if (!useVDP && oldIndex < currentPage->count()) {
 		currentPage->setCurrentIndex(oldIndex);
 	}
+	overview->setPages(pageSize, pages, visibleLines);
 }
 
 void BitMapViewer::on_currentPage_currentIndexChanged(int index)
@@ -217,8 +233,10 @@ void BitMapViewer::on_linesVisible_currentIndexChanged(int index)
 {
 	static const int m[3] = { 192, 212, 256 };
 	int lines = m[index];
+	visibleLines = lines;
 	imageWidget->setLines(lines);
 	linesLabel->setText(QString("%1").arg(m[index]));
+	overview->setPages(pageSize, currentPage->count(), lines);
 }
 
 void BitMapViewer::on_bgColor_valueChanged(int value)
@@ -243,6 +261,19 @@ void BitMapViewer::on_zoomLevel_valueChanged(double d)
 	imageWidget->setZoom(float(d));
 }
 
+void BitMapViewer::on_showAllPages_stateChanged(int state)
+{
+	// the scroll area deletes the widget it replaces, take it out first
+	QWidget* old = scrollArea->takeWidget();
+	old->setParent(this);
+	old->hide();
+	scrollArea->setWidget(state ? static_cast<QWidget*>(overview) : imageWidget);
+	scrollArea->widget()->show();
+	currentPage->setEnabled(!state && !useVDP);
+	zoomLevel->setEnabled(!state);
+	overview->refresh();
+}
+
 void BitMapViewer::on_saveImageButton_clicked(bool /*checked*/)
 {
 	QMessageBox::information(
@@ -5,6 +5,7 @@
 #include <QDialog>
 
 class VramBitMappedView;
+class VramOverview;
 
 class BitMapViewer : public QDialog, private Ui::BitMapViewer
 {
@@ -29,6 +30,7 @@ private:
 	void on_editPaletteButton_clicked(bool checked);
 	void on_useVDPPalette_stateChanged(int state);
 	void on_zoomLevel_valueChanged(double d);
+	void on_showAllPages_stateChanged(int state);
 
 	void updateImagePosition(int x, int y, int color, unsigned addr, int byteValue);
 
@@ -36,6 +38,8 @@ private:
 
 private:
 	VramBitMappedView* imageWidget;
+	VramOverview* overview;
+	int visibleLines = 212;
 	unsigned pageSize;
 	int screenMod;
 	bool useVDP;
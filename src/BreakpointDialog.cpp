@@ -1,5 +1,6 @@
 #include "BreakpointDialog.h"
 #include "DebugSession.h"
+#include "SymbolCompleter.h"
 #include "Convert.h"
 #include <QStandardItemModel>
 #include <memory>
@@ -12,10 +13,14 @@ BreakpointDialog::BreakpointDialog(const MemoryLayout& ml, DebugSession* session
 	debugSession = session;
 	if (session) {
 		// create address completer
-		jumpCompleter = std::make_unique<QCompleter>(session->symbolTable().labelList(), this);
-		allCompleter = std::make_unique<QCompleter>(session->symbolTable().labelList(true), this);
-		jumpCompleter->setCaseSensitivity(Qt::CaseInsensitive);
-		allCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+		jumpCompleter = std::make_unique<SymbolCompleter>(session->symbolTable(), false, nullptr, this);
+		allCompleter = std::make_unique<SymbolCompleter>(session->symbolTable(), true, nullptr, this);
+		// feed the text of the edit field to whichever completer it uses
+		for (auto* edit : {edtAddress, edtAddressRange}) {
+			connect(edit, &QLineEdit::textEdited, this, [edit](const QString& text) {
+				if (auto* c = qobject_cast<SymbolCompleter*>(edit->completer())) c->update(text);
+			});
+		}
 		connect(jumpCompleter.get(), qOverload<const QString&>(&QCompleter::activated), this, &BreakpointDialog::addressChanged);
 		connect(allCompleter.get(),  qOverload<const QString&>(&QCompleter::activated), this, &BreakpointDialog::addressChanged);
 	}
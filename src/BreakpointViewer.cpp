@@ -625,6 +625,33 @@ void BreakpointViewer::refresh()
 	stretchTable(BreakpointType::ALL);
 }
 
+void BreakpointViewer::refreshBreakpoint(const QString& id)
+{
+	// don't reload if self-inflicted update
+	if (disableRefresh) return;
+
+	BreakpointType type = id.startsWith("bp#") ? BreakpointType::BREAKPOINT
+	                    : (id.startsWith("cond#") ? BreakpointType::CONDITION
+	                    : BreakpointType::WATCHPOINT);
+	auto bpIndex = breakpoints->indexOf(id);
+	auto row = findBreakpointRow(type, id);
+
+	// keep the rows in place while changing one of them
+	disableSorting(type);
+	if (bpIndex && row) {
+		auto sa = ScopedAssign(userMode, false);
+		refreshTableRow(*bpIndex, type, *row);
+	} else if (bpIndex) {
+		// new breakpoints created on OpenMSX will go through here
+		auto newRow = createTableRow(type);
+		fillTableRow(type, newRow, *bpIndex);
+	} else if (row && tables[type]->item(*row, ENABLED)->checkState() == Qt::Checked) {
+		auto sa = ScopedAssign(userMode, false);
+		tables[type]->removeRow(*row);
+	}
+	stretchTable(type);
+}
+
 void BreakpointViewer::changeCurrentWpType(int row, int /*selected*/)
 {
 	if (!userMode) return;
@@ -32,6 +32,8 @@ public:
 	void setRunState();
 	void setBreakState();
 	void refresh();
+	// update only the row of the breakpoint with this id
+	void refreshBreakpoint(const QString& id);
 
 signals:
 	void contentsUpdated();
@@ -0,0 +1,52 @@
+#include "CallProfiler.h"
+#include <QHash>
+#include <QStringList>
+#include <functional>
+
+CallProfiler::CallProfiler(QObject* parent)
+	: PolledCollector("iprof", 1000, parent)
+{
+}
+
+void CallProfiler::start(const std::vector<uint16_t>& addresses)
+{
+	if (isRunning() || addresses.empty()) return;
+	QString list;
+	for (auto addr : addresses) {
+		list += QString(" %1").arg(addr);
+	}
+	callNodes.clear();
+	emit updated();
+	startCollecting(QString("{%1 }").arg(list));
+}
+
+void CallProfiler::processReply(const QString& message)
+{
+	// every line is "/caller/.../callee calls inclusive exclusive max",
+	// with the routines given by their (decimal) address
+	callNodes.clear();
+	QHash<QString, int> paths;
+	std::function<int(const QString&)> nodeFor = [&](const QString& path) {
+		auto it = paths.constFind(path);
+		if (it != paths.constEnd()) return *it;
+		int slash = path.lastIndexOf('/');
+		// a caller that is still running has no statistics yet
+		int parent = slash > 0 ? nodeFor(path.left(slash)) : -1;
+		int index = callNodes.size();
+		callNodes.push_back({uint16_t(path.mid(slash + 1).toUInt()), parent, 0, 0.0, 0.0, 0.0});
+		paths.insert(path, index);
+		return index;
+	};
+
+	for (const auto& line : message.split('\n', Qt::SplitBehaviorFlags::SkipEmptyParts)) {
+		auto fields = line.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+		if (fields.size() != 5 || !fields[0].startsWith('/')) continue;
+		int index = nodeFor(fields[0]);
+		auto& node = callNodes[index];
+		node.calls = fields[1].toULongLong();
+		node.inclusive = fields[2].toDouble();
+		node.exclusive = fields[3].toDouble();
+		node.maximum = fields[4].toDouble();
+	}
+	emit updated();
+}
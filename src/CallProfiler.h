@@ -0,0 +1,45 @@
+#ifndef CALLPROFILER_H
+#define CALLPROFILER_H
+
+#include "PolledCollector.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Instrumenting profiler: openMSX gets a non-breaking breakpoint on the
+ * entry of every selected routine, and on the return address of every
+ * call to one of them. The probes keep a shadow call stack in Tcl and
+ * accumulate the emulated time spent per call path, so the debugger only
+ * has to fetch the totals (in a single reply) to show the call tree.
+ */
+class CallProfiler : public PolledCollector
+{
+	Q_OBJECT
+public:
+	// statistics for one call path, times are in seconds of emulated time
+	struct Node {
+		uint16_t address;
+		int parent; // index of the calling node, -1 for a root
+		uint64_t calls;
+		double inclusive; // including time spent in profiled callees
+		double exclusive;
+		double maximum;   // longest single (inclusive) call
+	};
+
+	CallProfiler(QObject* parent = nullptr);
+
+	void start(const std::vector<uint16_t>& addresses);
+
+	// parents are always listed before their children
+	[[nodiscard]] const std::vector<Node>& nodes() const { return callNodes; }
+
+signals:
+	void updated();
+
+private:
+	void processReply(const QString& message) override;
+
+	std::vector<Node> callNodes;
+};
+
+#endif // CALLPROFILER_H
@@ -0,0 +1,263 @@
+#include "CallTreeViewer.h"
+#include "CallProfiler.h"
+#include "SymbolTable.h"
+#include "SymbolCompleter.h"
+#include "Convert.h"
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QHeaderView>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPair>
+#include <QPushButton>
+#include <QSet>
+#include <QSplitter>
+#include <QTreeWidget>
+#include <QVBoxLayout>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+enum { COL_ROUTINE = 0, COL_CALLS, COL_INCLUSIVE, COL_EXCLUSIVE, COL_MAXIMUM, COLUMN_COUNT };
+
+// emulated seconds shown as microseconds with one decimal
+static double micros(double seconds)
+{
+	return std::round(seconds * 1e7) / 10.0;
+}
+
+CallTreeViewer::CallTreeViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	routineEdit = new QLineEdit();
+	routineEdit->setPlaceholderText(tr("Label or address"));
+	addButton = new QPushButton(tr("Add"));
+	removeButton = new QPushButton(tr("Remove"));
+	startButton = new QPushButton(tr("Start"));
+	flatBox = new QCheckBox(tr("Per routine"));
+	flatBox->setToolTip(tr("Show the totals per routine instead of per call path"));
+
+	routineList = new QListWidget();
+	routineList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+	tree = new QTreeWidget();
+	tree->setColumnCount(COLUMN_COUNT);
+	tree->setHeaderLabels({tr("Routine"), tr("Calls"), tr("Inclusive (µs)"),
+	                       tr("Exclusive (µs)"), tr("Max (µs)")});
+	tree->header()->setSectionResizeMode(COL_ROUTINE, QHeaderView::Stretch);
+	tree->setSortingEnabled(true);
+	tree->sortByColumn(COL_INCLUSIVE, Qt::DescendingOrder);
+
+	auto* listBox = new QWidget();
+	auto* lvbox = new QVBoxLayout();
+	lvbox->setMargin(0);
+	lvbox->addWidget(routineEdit);
+	auto* lhbox = new QHBoxLayout();
+	lhbox->setMargin(0);
+	lhbox->addWidget(addButton);
+	lhbox->addWidget(removeButton);
+	lvbox->addLayout(lhbox);
+	lvbox->addWidget(routineList);
+	listBox->setLayout(lvbox);
+
+	auto* splitter = new QSplitter(Qt::Horizontal);
+	splitter->addWidget(listBox);
+	splitter->addWidget(tree);
+	splitter->setStretchFactor(1, 1);
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(startButton);
+	hbox->addWidget(flatBox);
+	hbox->addStretch(1);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addWidget(splitter);
+	setLayout(vbox);
+
+	connect(routineEdit, &QLineEdit::returnPressed, this, &CallTreeViewer::addRoutine);
+	connect(addButton, &QPushButton::clicked, this, &CallTreeViewer::addRoutine);
+	connect(removeButton, &QPushButton::clicked, this, &CallTreeViewer::removeRoutines);
+	connect(startButton, &QPushButton::clicked, this, &CallTreeViewer::startStop);
+	connect(flatBox, &QCheckBox::toggled, this, &CallTreeViewer::refresh);
+	connect(tree, &QTreeWidget::itemDoubleClicked, this, &CallTreeViewer::itemActivated);
+}
+
+void CallTreeViewer::setProfiler(CallProfiler* p)
+{
+	profiler = p;
+	connect(profiler, &CallProfiler::updated, this, &CallTreeViewer::refresh);
+	connect(profiler, &CallProfiler::runningChanged, this, &CallTreeViewer::runningChanged);
+}
+
+void CallTreeViewer::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+
+	auto* completer = new SymbolCompleter(*symTable, false, nullptr, this);
+	routineEdit->setCompleter(completer);
+	connect(routineEdit, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
+}
+
+void CallTreeViewer::addRoutine()
+{
+	QString text = routineEdit->text().trimmed();
+	auto addr = stringToValue<uint16_t>(text);
+	QString name = addr ? hexValue(*addr, 4) : text;
+	if (!addr && symTable) {
+		if (Symbol* s = symTable->getAddressSymbol(text)) {
+			addr = s->value();
+			name = s->text();
+		}
+	}
+	if (!addr) return;
+
+	for (int i = 0; i < routineList->count(); ++i) {
+		if (routineList->item(i)->data(Qt::UserRole).toInt() == *addr) return;
+	}
+	auto* item = new QListWidgetItem(name);
+	item->setData(Qt::UserRole, *addr);
+	routineList->addItem(item);
+	routineEdit->clear();
+}
+
+void CallTreeViewer::removeRoutines()
+{
+	qDeleteAll(routineList->selectedItems());
+}
+
+void CallTreeViewer::startStop()
+{
+	if (profiler->isRunning()) {
+		profiler->stop();
+		return;
+	}
+	std::vector<uint16_t> addresses;
+	for (int i = 0; i < routineList->count(); ++i) {
+		addresses.push_back(routineList->item(i)->data(Qt::UserRole).toInt());
+	}
+	profiler->start(addresses);
+}
+
+void CallTreeViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+	// the probes are placed when starting
+	routineEdit->setEnabled(!running);
+	addButton->setEnabled(!running);
+	removeButton->setEnabled(!running);
+}
+
+void CallTreeViewer::itemActivated(QTreeWidgetItem* item)
+{
+	emit addressSelected(item->data(COL_ROUTINE, Qt::UserRole).toInt());
+}
+
+QString CallTreeViewer::routineName(uint16_t addr) const
+{
+	for (int i = 0; i < routineList->count(); ++i) {
+		auto* item = routineList->item(i);
+		if (item->data(Qt::UserRole).toInt() == addr) return item->text();
+	}
+	return hexValue(addr, 4);
+}
+
+// The items are updated in place, so expanded nodes, the selection and the
+// scroll position survive the periodic updates while profiling. An item is
+// identified by its parent item and routine address.
+void CallTreeViewer::refresh()
+{
+	if (!profiler || flatBox->isChecked() != flatShown) tree->clear();
+	if (!profiler) return;
+	flatShown = flatBox->isChecked();
+	const auto& nodes = profiler->nodes();
+
+	QHash<QPair<QTreeWidgetItem*, uint16_t>, QTreeWidgetItem*> existing;
+	std::function<void(QTreeWidgetItem*)> collect = [&](QTreeWidgetItem* parent) {
+		for (int i = 0; i < parent->childCount(); ++i) {
+			auto* child = parent->child(i);
+			existing.insert({parent, uint16_t(child->data(COL_ROUTINE, Qt::UserRole).toInt())}, child);
+			collect(child);
+		}
+	};
+	collect(tree->invisibleRootItem());
+
+	QSet<QTreeWidgetItem*> used;
+	auto findItem = [&](QTreeWidgetItem* parent, uint16_t addr) {
+		auto* item = existing.value({parent, addr});
+		if (!item) {
+			item = new QTreeWidgetItem(parent);
+			item->setExpanded(true);
+			existing.insert({parent, addr}, item);
+		}
+		used.insert(item);
+		return item;
+	};
+
+	auto setColumns = [&](QTreeWidgetItem* item, uint16_t addr, uint64_t calls,
+	                      double inclusive, double exclusive, double maximum) {
+		item->setText(COL_ROUTINE, routineName(addr));
+		item->setData(COL_ROUTINE, Qt::UserRole, addr);
+		item->setData(COL_CALLS, Qt::DisplayRole, qulonglong(calls));
+		item->setData(COL_INCLUSIVE, Qt::DisplayRole, micros(inclusive));
+		item->setData(COL_EXCLUSIVE, Qt::DisplayRole, micros(exclusive));
+		item->setData(COL_MAXIMUM, Qt::DisplayRole, micros(maximum));
+	};
+
+	// don't resort after every changed value
+	tree->setSortingEnabled(false);
+	auto* root = tree->invisibleRootItem();
+	if (flatShown) {
+		struct Total {
+			uint64_t calls = 0;
+			double inclusive = 0.0, exclusive = 0.0, maximum = 0.0;
+		};
+		QHash<uint16_t, Total> totals;
+		for (const auto& node : nodes) {
+			auto& t = totals[node.address];
+			t.calls += node.calls;
+			t.exclusive += node.exclusive;
+			t.maximum = std::max(t.maximum, node.maximum);
+			// time of recursive calls is already part of the outer call
+			bool recursive = false;
+			for (int p = node.parent; p != -1 && !recursive; p = nodes[p].parent) {
+				recursive = nodes[p].address == node.address;
+			}
+			if (!recursive) t.inclusive += node.inclusive;
+		}
+		for (auto it = totals.begin(); it != totals.end(); ++it) {
+			const auto& t = it.value();
+			setColumns(findItem(root, it.key()), it.key(), t.calls,
+			           t.inclusive, t.exclusive, t.maximum);
+		}
+	} else {
+		// parents come before their children
+		std::vector<QTreeWidgetItem*> items;
+		items.reserve(nodes.size());
+		for (const auto& node : nodes) {
+			auto* item = findItem(node.parent == -1 ? root : items[node.parent],
+			                      node.address);
+			setColumns(item, node.address, node.calls,
+			           node.inclusive, node.exclusive, node.maximum);
+			items.push_back(item);
+		}
+	}
+
+	// drop the items of call paths that are gone, e.g. after a restart
+	std::function<void(QTreeWidgetItem*)> prune = [&](QTreeWidgetItem* parent) {
+		for (int i = parent->childCount() - 1; i >= 0; --i) {
+			auto* child = parent->child(i);
+			if (used.contains(child)) {
+				prune(child);
+			} else {
+				delete child;
+			}
+		}
+	};
+	prune(root);
+	tree->setSortingEnabled(true);
+}
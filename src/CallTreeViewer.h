@@ -0,0 +1,56 @@
+#ifndef CALLTREEVIEWER_H
+#define CALLTREEVIEWER_H
+
+#include <QWidget>
+#include <cstdint>
+
+class CallProfiler;
+class SymbolTable;
+class QCheckBox;
+class QLineEdit;
+class QListWidget;
+class QPushButton;
+class QTreeWidget;
+class QTreeWidgetItem;
+
+/**
+ * Selection of the routines to instrument and the call tree (or flat list
+ * per routine) with the call counts and times measured by the
+ * CallProfiler.
+ */
+class CallTreeViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	CallTreeViewer(QWidget* parent = nullptr);
+
+	void setProfiler(CallProfiler* profiler);
+	void setSymbolTable(SymbolTable* st);
+
+	void refresh();
+
+signals:
+	void addressSelected(uint16_t addr);
+
+private:
+	void addRoutine();
+	void removeRoutines();
+	void startStop();
+	void runningChanged(bool running);
+	void itemActivated(QTreeWidgetItem* item);
+	[[nodiscard]] QString routineName(uint16_t addr) const;
+
+	QLineEdit* routineEdit;
+	QPushButton* addButton;
+	QPushButton* removeButton;
+	QPushButton* startButton;
+	QCheckBox* flatBox;
+	QListWidget* routineList;
+	QTreeWidget* tree;
+
+	CallProfiler* profiler = nullptr;
+	SymbolTable* symTable = nullptr;
+	bool flatShown = false; // how the items in 'tree' were built
+};
+
+#endif // CALLTREEVIEWER_H
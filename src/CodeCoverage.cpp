@@ -0,0 +1,94 @@
+#include "CodeCoverage.h"
+#include "DebuggerData.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+CodeCoverage::CodeCoverage(QObject* parent)
+	: PolledCollector("cov", 1000, parent)
+{
+}
+
+void CodeCoverage::start()
+{
+	startCollecting();
+}
+
+void CodeCoverage::clear()
+{
+	bitsets.clear();
+	emit updated();
+}
+
+void CodeCoverage::processReply(const QString& message)
+{
+	// only the regions that changed since the previous fetch
+	bool changed = false;
+	for (const auto& line : message.split('\n', Qt::SplitBehaviorFlags::SkipEmptyParts)) {
+		changed |= mergeLine(line);
+	}
+	if (changed) emit updated();
+}
+
+QString CodeCoverage::regionKey(uint16_t address, const MemoryLayout* ml)
+{
+	int page = address >> 14;
+	int ps = ml->primarySlot[page] & 3;
+	int ss = ml->secondarySlot[page];
+	QString key = QString("%1:%2:").arg(ps).arg(ss < 0 ? QString("X") : QString::number(ss));
+	if (ml->mapperSize[ps][std::max(ss, 0)] > 0) {
+		return key + QString("m%1").arg(ml->mapperSegment[page]);
+	} else if (ml->romBlock[address >> 13] >= 0) {
+		return key + QString("r%1").arg(ml->romBlock[address >> 13]);
+	}
+	return key + QString("p%1").arg(page);
+}
+
+bool CodeCoverage::isCovered(uint16_t address, const MemoryLayout* ml) const
+{
+	auto it = bitsets.constFind(regionKey(address, ml));
+	if (it == bitsets.constEnd()) return false;
+	int offset = address & (REGION_SIZE - 1);
+	return (uint8_t(it->at(offset >> 3)) >> (offset & 7)) & 1;
+}
+
+bool CodeCoverage::mergeLine(const QString& line)
+{
+	static const QRegExp keyFormat("[0-3]:[0-3X]:[mrp]\\d+");
+	auto fields = line.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+	if (fields.size() != 2 || !keyFormat.exactMatch(fields[0])) return false;
+	QByteArray bits = QByteArray::fromHex(fields[1].toLatin1());
+	if (bits.size() != BITSET_SIZE) return false;
+
+	auto it = bitsets.find(fields[0]);
+	if (it == bitsets.end()) {
+		bitsets.insert(fields[0], bits);
+	} else {
+		for (int i = 0; i < BITSET_SIZE; ++i) {
+			(*it)[i] = (*it)[i] | bits[i];
+		}
+	}
+	return true;
+}
+
+bool CodeCoverage::merge(const QString& text)
+{
+	bool ok = true;
+	for (const auto& line : text.split('\n', Qt::SplitBehaviorFlags::SkipEmptyParts)) {
+		if (line.trimmed().isEmpty() || line.startsWith('#')) continue;
+		ok &= mergeLine(line.trimmed());
+	}
+	emit updated();
+	return ok;
+}
+
+QString CodeCoverage::save() const
+{
+	QStringList keys = bitsets.keys();
+	keys.sort();
+	QString text = "# openMSX debugger code coverage: slot:subslot:region bitset\n";
+	for (const auto& key : keys) {
+		text += key + ' ' + QString::fromLatin1(bitsets.value(key).toHex()) + '\n';
+	}
+	return text;
+}
@@ -0,0 +1,57 @@
+#ifndef CODECOVERAGE_H
+#define CODECOVERAGE_H
+
+#include "PolledCollector.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <cstdint>
+
+struct MemoryLayout;
+
+/**
+ * Set of executed instruction addresses, recorded by a condition in openMSX
+ * that runs for every instruction.
+ *
+ * Memory is split in 16kB regions that are identified by slot, subslot and
+ * mapper segment or ROM block (or the page for unmapped memory), with one bit
+ * per address, so even the coverage of a large MegaROM takes only a few
+ * kilobytes. openMSX keeps the bitsets of the current run and reports the
+ * regions that changed since the last fetch; the debugger merges them into
+ * its own bitsets, which can be saved and merged with earlier runs.
+ */
+class CodeCoverage : public PolledCollector
+{
+	Q_OBJECT
+public:
+	static constexpr int REGION_SIZE = 0x4000;
+	static constexpr int BITSET_SIZE = REGION_SIZE / 8;
+
+	CodeCoverage(QObject* parent = nullptr);
+
+	void start();
+	void clear();
+	[[nodiscard]] bool isEmpty() const { return bitsets.isEmpty(); }
+
+	// was the instruction at 'address', in the slot and segment that the
+	// memory layout shows there, ever executed
+	[[nodiscard]] bool isCovered(uint16_t address, const MemoryLayout* ml) const;
+
+	// one "region hex-bitset" line per region
+	[[nodiscard]] QString save() const;
+	// add the coverage of another run, returns false on a malformed file
+	bool merge(const QString& text);
+
+	[[nodiscard]] static QString regionKey(uint16_t address, const MemoryLayout* ml);
+
+signals:
+	void updated();
+
+private:
+	void processReply(const QString& message) override;
+	bool mergeLine(const QString& line);
+
+	QHash<QString, QByteArray> bitsets;
+};
+
+#endif // CODECOVERAGE_H
@@ -69,6 +69,7 @@ bool Breakpoint::operator==(const Breakpoint &bp) const
 void Breakpoints::clear()
 {
 	breakpoints.clear();
+	buildIndex();
 }
 
 void Breakpoints::setMemoryLayout(MemoryLayout* ml)
@@ -129,70 +130,103 @@ void Breakpoints::setBreakpoints(const QString& str)
 
 	QStringList bps = str.split('\n');
 	for (auto& bp : bps) {
-		if (bp.trimmed().isEmpty()) continue;
-
-		Breakpoint newBp;
-
-		// set id
-		int p = 0;
-		newBp.id = getNextArgument(bp, p);
-
-		// determine type
-		if (bp.startsWith("bp#")) {
-			newBp.type = Breakpoint::BREAKPOINT;
-		} else if (bp.startsWith("wp#")) {
-			// determine watchpoint type
-			static const char* const WpTypeNames[] = {"read_mem", "write_mem", "read_io", "write_io"};
-			QString wpType = getNextArgument(bp, p);
-			if (auto it = ranges::find(WpTypeNames, wpType); it != std::end(WpTypeNames)) {
-				newBp.type = static_cast<Breakpoint::Type>(std::distance(WpTypeNames, it) + 1);
-			} else {
-				continue;
-			}
-		} else if (bp.startsWith("cond#")) {
-			newBp.type = Breakpoint::CONDITION;
-		} else { // unknown
-			continue;
+		if (auto newBp = parseBreakpoint(bp)) {
+			insertBreakpoint(*newBp);
 		}
+	}
+	buildIndex();
+}
 
-		// get address
-		p++;
-		if (newBp.type != Breakpoint::CONDITION) {
-			if (bp[p] == '{') {
-				p++;
-				auto s = getNextArgument(bp, p);
-				auto start = stringToValue<uint16_t>(s);
-				if (!start) continue;
-				newBp.range = AddressRange(*start);
-				int q = bp.indexOf('}', p);
-				auto end = stringToValue<uint16_t>(bp.mid(p, q - p));
-				newBp.range->end = end;
-				p = q + 1;
-			} else {
-				auto s = getNextArgument(bp, p);
-				auto start = stringToValue<uint16_t>(s);
-				if (!start) continue;
-				newBp.range = AddressRange(*start);
-			}
+std::optional<Breakpoint> Breakpoints::parseBreakpoint(const QString& bp)
+{
+	if (bp.trimmed().isEmpty()) return {};
+
+	Breakpoint newBp;
+
+	// set id
+	int p = 0;
+	newBp.id = getNextArgument(bp, p);
+
+	// determine type
+	if (bp.startsWith("bp#")) {
+		newBp.type = Breakpoint::BREAKPOINT;
+	} else if (bp.startsWith("wp#")) {
+		// determine watchpoint type
+		static const char* const WpTypeNames[] = {"read_mem", "write_mem", "read_io", "write_io"};
+		QString wpType = getNextArgument(bp, p);
+		if (auto it = ranges::find(WpTypeNames, wpType); it != std::end(WpTypeNames)) {
+			newBp.type = static_cast<Breakpoint::Type>(std::distance(WpTypeNames, it) + 1);
+		} else {
+			return {};
+		}
+	} else if (bp.startsWith("cond#")) {
+		newBp.type = Breakpoint::CONDITION;
+	} else { // unknown
+		return {};
+	}
+
+	// get address
+	p++;
+	if (newBp.type != Breakpoint::CONDITION) {
+		if (bp[p] == '{') {
+			p++;
+			auto s = getNextArgument(bp, p);
+			auto start = stringToValue<uint16_t>(s);
+			if (!start) return {};
+			newBp.range = AddressRange(*start);
+			int q = bp.indexOf('}', p);
+			auto end = stringToValue<uint16_t>(bp.mid(p, q - p));
+			newBp.range->end = end;
+			p = q + 1;
+		} else {
+			auto s = getNextArgument(bp, p);
+			auto start = stringToValue<uint16_t>(s);
+			if (!start) return {};
+			newBp.range = AddressRange(*start);
 		}
-		// check and clip command (skip non-default commands)
-		int q = bp.lastIndexOf('{');
-		if (bp.mid(q).simplified() != "{debug break}") continue;
+	}
+	// check and clip command (skip non-default commands)
+	int q = bp.lastIndexOf('{');
+	if (bp.mid(q).simplified() != "{debug break}") return {};
+
+	newBp.condition = unescapeXML(bp.mid(p, q - p).trimmed());
+	parseCondition(newBp);
+	return newBp;
+}
 
-		newBp.condition = unescapeXML(bp.mid(p, q - p).trimmed());
-		parseCondition(newBp);
-		insertBreakpoint(newBp);
+bool Breakpoints::updateBreakpoint(const QString& id, const QString& str)
+{
+	auto newBp = parseBreakpoint(str);
+	if (newBp && newBp->id != id) return false;
+
+	auto it = ranges::find_if(breakpoints, [&](auto& bp) { return bp.id == id; });
+	if (it != breakpoints.end()) {
+		if (newBp && *it == *newBp) return false; // nothing changed
+		breakpoints.erase(it);
+	} else if (!newBp) {
+		return false; // unknown and gone
 	}
+	// the id stays the same, so views can keep referring to it
+	if (newBp) insertBreakpoint(*newBp);
+	buildIndex();
+	return true;
+}
+
+std::optional<int> Breakpoints::indexOf(const QString& id) const
+{
+	auto it = ranges::find_if(breakpoints, [&](auto& bp) { return bp.id == id; });
+	if (it == breakpoints.end()) return {};
+	return std::distance(breakpoints.begin(), it);
 }
 
-QString Breakpoints::mergeBreakpoints(const QString& str)
+std::vector<Breakpoint> Breakpoints::mergeBreakpoints(const QString& str)
 {
 	// copy breakpoints
 	auto oldBps = breakpoints;
 	// parse new list
 	setBreakpoints(str);
 	// check old list against new one
-	QStringList mergeSet;
+	std::vector<Breakpoint> missing;
 	for (const auto& old : oldBps) {
 		auto newit = breakpoints.begin();
 		for (/**/; newit != breakpoints.end(); ++newit) {
@@ -200,12 +234,135 @@ QString Breakpoints::mergeBreakpoints(const QString& str)
 			if (old  == *newit) break;
 		}
 		if (newit == breakpoints.end()) {
-			// create command to set this breakpoint again
-			QString cmd = createSetCommand(old.type, old.range, old.slot, old.segment, old.condition);
-			mergeSet << cmd;
+			// this breakpoint must be set again
+			missing.push_back(old);
+		}
+	}
+	return missing;
+}
+
+QString Breakpoints::createBatchSetCommand(const std::vector<Breakpoint>& bps)
+{
+	// debug_set_breaks evaluates each command separately, so one bad
+	// breakpoint doesn't stop the others from being set
+	QString cmd = "debug_set_breaks {";
+	for (const auto& bp : bps) {
+		cmd += QString(" {%1}").arg(createSetCommand(bp.type, bp.range, bp.slot,
+		                                             bp.segment, bp.condition));
+	}
+	return cmd + " }";
+}
+
+QStringList Breakpoints::parseBatchReply(const QString& reply)
+{
+	// a Tcl list of ids, where failures are empty elements: "bp#1 {} wp#2"
+	QStringList ids = reply.split(QRegExp("\\s+"), Qt::SplitBehaviorFlags::SkipEmptyParts);
+	for (auto& id : ids) {
+		if (id == "{}") id.clear();
+	}
+	return ids;
+}
+
+void Breakpoints::insertBreakpoints(std::vector<Breakpoint> bps, const QStringList& ids)
+{
+	for (size_t i = 0; i < bps.size() && int(i) < ids.size(); ++i) {
+		if (ids[i].isEmpty()) continue;
+		auto& bp = bps[i];
+		bp.id = ids[i];
+		// an update event may have added it already
+		breakpoints.erase(std::remove_if(breakpoints.begin(), breakpoints.end(),
+		                                 [&](auto& b) { return b.id == bp.id; }),
+		                  breakpoints.end());
+		insertBreakpoint(bp);
+	}
+	buildIndex();
+}
+
+QString Breakpoints::exportBreakpoints()
+{
+	QString result = "# type,location,slot,segment,condition\n";
+	for (const auto& bp : breakpoints) {
+		QString location;
+		if (bp.range) {
+			location = QString("0x%1").arg(bp.range->start, 4, 16, QChar('0'));
+			if (bp.range->end) {
+				location += QString(":0x%1").arg(*bp.range->end, 4, 16, QChar('0'));
+			}
+		}
+		result += QString("%1,%2,%3/%4,%5,%6\n")
+		          .arg(TypeNames[bp.type])
+		          .arg(location)
+		          .arg(bp.slot.ps ? QChar('0' + *bp.slot.ps) : QChar('X'))
+		          .arg(bp.slot.ss ? QChar('0' + *bp.slot.ss) : QChar('X'))
+		          .arg(bp.segment ? QString::number(*bp.segment) : "X")
+		          .arg(bp.condition);
+	}
+	return result;
+}
+
+std::vector<Breakpoint> Breakpoints::importBreakpoints(const QString& text,
+                                                       const AddressResolver& resolve,
+                                                       QStringList& errors)
+{
+	std::vector<Breakpoint> result;
+	QStringList lines = text.split('\n');
+	for (int n = 0; n < lines.size(); ++n) {
+		QString line = lines[n].trimmed();
+		if (line.isEmpty() || line.startsWith('#') || line.startsWith(';')) continue;
+		auto error = [&](const QString& msg) {
+			errors << QString("line %1: %2").arg(n + 1).arg(msg);
+		};
+
+		// a line with only a location is a breakpoint
+		QStringList fields = line.split(',');
+		if (fields.size() == 1) fields.prepend("breakpoint");
+
+		Breakpoint bp;
+		QString type = fields[0].trimmed().toLower();
+		if (type == "bp") type = "breakpoint";
+		if (auto it = ranges::find(TypeNames, type); it != std::end(TypeNames)) {
+			bp.type = static_cast<Breakpoint::Type>(std::distance(TypeNames, it));
+		} else {
+			error(QString("unknown type '%1'").arg(type));
+			continue;
+		}
+
+		if (bp.type != Breakpoint::CONDITION) {
+			QStringList loc = fields.value(1).split(':');
+			auto start = resolve(loc[0].trimmed());
+			if (!start) {
+				error(QString("can't resolve '%1'").arg(loc[0].trimmed()));
+				continue;
+			}
+			bp.range = AddressRange(*start);
+			if (loc.size() > 1 && bp.type != Breakpoint::BREAKPOINT) {
+				auto end = resolve(loc[1].trimmed());
+				if (!end || *end < *start) {
+					error(QString("bad range end '%1'").arg(loc[1].trimmed()));
+					continue;
+				}
+				if (*end != *start) bp.range->end = end;
+			}
+
+			QStringList slot = fields.value(2).trimmed().split('/');
+			auto slotValue = [](const QString& s) {
+				auto v = stringToValue<int8_t>(s);
+				return make_if(v && *v >= 0 && *v <= 3, v.value_or(0));
+			};
+			bp.slot.ps = slotValue(slot.value(0));
+			bp.slot.ss = slotValue(slot.value(1));
+			bp.segment = stringToValue<uint8_t>(fields.value(3));
 		}
+
+		// the condition may contain commas itself
+		bp.condition = fields.mid(4).join(',').trimmed();
+		if (bp.type == Breakpoint::CONDITION && bp.condition.isEmpty()) {
+			error("condition is empty");
+			continue;
+		}
+		result.push_back(std::move(bp));
 	}
-	return mergeSet.join(" ; ");
+	return result;
 }
 
 void Breakpoints::parseCondition(Breakpoint& bp)
@@ -269,7 +426,8 @@ bool Breakpoints::inCurrentSlot(const Breakpoint& bp)
 
 void Breakpoints::insertBreakpoint(Breakpoint& bp)
 {
-	auto it = ranges::upper_bound(breakpoints, bp.range->start, {}, [](auto& bp) { return bp.range ? bp.range->start : -1; });
+	int start = bp.range ? bp.range->start : -1; // conditions have no address
+	auto it = ranges::upper_bound(breakpoints, start, {}, [](auto& bp) { return bp.range ? bp.range->start : -1; });
 	breakpoints.insert(it, bp);
 }
 
@@ -294,20 +452,56 @@ bool Breakpoints::isBreakpoint(uint16_t addr, QString* id, bool checkSlot)
 
 bool Breakpoints::isWatchpoint(quint16 addr, QString* id, bool checkSlot)
 {
-	for (const auto& bp : breakpoints) {
-		if (bp.type == Breakpoint::WATCHPOINT_MEMREAD || bp.type == Breakpoint::WATCHPOINT_MEMWRITE) {
-			assert(bp.range);
-			if (bp.range->contains(addr)) {
-				if (!checkSlot || inCurrentSlot(bp)) {
-					if (id) *id = bp.id;
-					return true;
-				}
-			}
+	for (const auto* bp : findInRange(addr, addr, checkSlot)) {
+		if (bp->type != Breakpoint::BREAKPOINT) {
+			if (id) *id = bp->id;
+			return true;
 		}
 	}
 	return false;
 }
 
+void Breakpoints::buildIndex()
+{
+	intervals.clear();
+	maxEnd.clear();
+	for (size_t i = 0; i < breakpoints.size(); ++i) {
+		const auto& bp = breakpoints[i];
+		if (bp.type != Breakpoint::BREAKPOINT &&
+		    bp.type != Breakpoint::WATCHPOINT_MEMREAD &&
+		    bp.type != Breakpoint::WATCHPOINT_MEMWRITE) continue;
+		assert(bp.range);
+		uint16_t end = bp.range->end ? std::max(*bp.range->end, bp.range->start)
+		                             : bp.range->start;
+		intervals.push_back({bp.range->start, end, i});
+	}
+	// breakpoints are already sorted on start address, keep it robust anyway
+	std::stable_sort(intervals.begin(), intervals.end(),
+	                 [](const Interval& a, const Interval& b) { return a.start < b.start; });
+	maxEnd.reserve(intervals.size());
+	for (const auto& iv : intervals) {
+		maxEnd.push_back(maxEnd.empty() ? iv.end : std::max(maxEnd.back(), iv.end));
+	}
+}
+
+std::vector<const Breakpoint*> Breakpoints::findInRange(uint16_t first, uint16_t last, bool checkSlot)
+{
+	std::vector<const Breakpoint*> result;
+	// intervals starting after the range can't overlap it
+	auto it = std::upper_bound(intervals.begin(), intervals.end(), last,
+	                           [](uint16_t a, const Interval& iv) { return a < iv.start; });
+	for (auto i = std::distance(intervals.begin(), it); i-- > 0;) {
+		if (maxEnd[i] < first) break; // nothing before this reaches the range
+		const auto& iv = intervals[i];
+		if (iv.end < first) continue;
+		const auto& bp = breakpoints[iv.index];
+		if (!checkSlot || inCurrentSlot(bp)) result.push_back(&bp);
+	}
+	// report in address order
+	std::reverse(result.begin(), result.end());
+	return result;
+}
+
 std::optional<uint16_t>
 Breakpoints::findBreakpoint(uint16_t addr)
 {
@@ -411,4 +605,5 @@ void Breakpoints::loadBreakpoints(QXmlStreamReader& xml)
 			}
 		}
 	}
+	buildIndex();
 }
@@ -2,8 +2,10 @@
 #define DEBUGGERDATA_H
 
 #include <QString>
+#include <QStringList>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
+#include <functional>
 #include <optional>
 #include <vector>
 
@@ -71,21 +73,46 @@ public:
 
 	void setMemoryLayout(MemoryLayout* ml);
 	void setBreakpoints(const QString& str);
-	QString mergeBreakpoints(const QString& str);
+	// parse the list from openMSX, returns the old breakpoints missing in it
+	std::vector<Breakpoint> mergeBreakpoints(const QString& str);
+	// Apply a change to a single breakpoint. 'str' is its line from the
+	// breakpoint list, or empty when it was removed. Returns whether the
+	// local list changed.
+	bool updateBreakpoint(const QString& id, const QString& str);
+	std::optional<int> indexOf(const QString& id) const;
 	int breakpointCount();
 	bool isBreakpoint(uint16_t addr, QString *id = nullptr, bool checkSlot = true);
 	bool isWatchpoint(uint16_t addr, QString *id = nullptr, bool checkSlot = true);
 
+	// add breakpoints installed with a batch command, using the ids from
+	// its reply (an empty id means that one failed)
+	void insertBreakpoints(std::vector<Breakpoint> bps, const QStringList& ids);
+
+	/* text file import/export, one breakpoint per line:
+	 *   type,location,slot,segment,condition
+	 */
+	using AddressResolver = std::function<std::optional<uint16_t>(const QString&)>;
+	QString exportBreakpoints();
+	static std::vector<Breakpoint> importBreakpoints(const QString& text,
+	                                                const AddressResolver& resolve,
+	                                                QStringList& errors);
+
 	/* xml session file functions */
 	void saveBreakpoints(QXmlStreamWriter& xml);
 	void loadBreakpoints(QXmlStreamReader& xml);
 
 	std::optional<uint16_t> findBreakpoint(uint16_t addr);
+	// All breakpoints and memory watchpoints that overlap the (inclusive)
+	// address range, found with a single query on the interval index.
+	std::vector<const Breakpoint*> findInRange(uint16_t first, uint16_t last, bool checkSlot = true);
 
 	static QString createSetCommand(Breakpoint::Type type, std::optional<AddressRange> range = {},
 	                                Slot slot = {}, std::optional<uint8_t> segment = {},
                                     QString condition = {});
 	static QString createRemoveCommand(const QString& id);
+	// one command that sets all breakpoints and returns the list of new ids
+	static QString createBatchSetCommand(const std::vector<Breakpoint>& bps);
+	[[nodiscard]] static QStringList parseBatchReply(const QString& reply);
 
 	const Breakpoint& getBreakpoint(int index);
 	bool inCurrentSlot(const Breakpoint& bp);
@@ -94,8 +121,22 @@ private:
 	std::vector<Breakpoint> breakpoints;
 	MemoryLayout* memLayout = nullptr;
 
+	// Address ranges of the breakpoints and memory watchpoints, sorted on
+	// start address. 'maxEnd[i]' is the highest end address among the
+	// first i+1 intervals, so a query can stop scanning backwards as soon
+	// as no earlier interval can reach the queried range anymore.
+	struct Interval {
+		uint16_t start;
+		uint16_t end;
+		size_t index;
+	};
+	std::vector<Interval> intervals;
+	std::vector<uint16_t> maxEnd;
+
+	std::optional<Breakpoint> parseBreakpoint(const QString& line);
 	void parseCondition(Breakpoint& bp);
 	void insertBreakpoint(Breakpoint& bp);
+	void buildIndex();
 };
 
 #endif // DEBUGGERDATA_H
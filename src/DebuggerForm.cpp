@@ -10,6 +10,21 @@
 #include "StackViewer.h"
 #include "SlotViewer.h"
 #include "BreakpointViewer.h"
+#include "SourceViewer.h"
+#include "SampleProfiler.h"
+#include "HotSpotViewer.h"
+#include "CallProfiler.h"
+#include "CallTreeViewer.h"
+#include "AccessHeatmap.h"
+#include "CodeCoverage.h"
+#include "FrameBudget.h"
+#include "FrameBudgetViewer.h"
+#include "IoProfiler.h"
+#include "IoProfilerViewer.h"
+#include "Tracer.h"
+#include "TraceViewer.h"
+#include "InstructionTrace.h"
+#include "InstructionTraceViewer.h"
 #include "CommClient.h"
 #include "ConnectDialog.h"
 #include "SymbolManager.h"
@@ -22,6 +37,7 @@
 #include "VDPStatusRegViewer.h"
 #include "VDPCommandRegViewer.h"
 #include "Settings.h"
+#include "Convert.h"
 #include "Version.h"
 #include <QAction>
 #include <QMessageBox>
@@ -38,7 +54,11 @@
 #include <QSplitter>
 #include <QPixmap>
 #include <QFileDialog>
+#include <QInputDialog>
+#include <QFile>
+#include <QDir>
 #include <QCloseEvent>
+#include <algorithm>
 #include <iostream>
 
 class QueryPauseHandler : public SimpleCommand
@@ -105,6 +125,29 @@ private:
 };
 
 
+// reads all of the visible memory for the coverage report
+class CoverageReportRequest : public ReadDebugBlockCommand
+{
+public:
+	CoverageReportRequest(DebuggerForm& form_, QString fileName_)
+		: ReadDebugBlockCommand("memory", 0, 0x10000, form_.mainMemory)
+		, form(form_), fileName(std::move(fileName_))
+	{
+	}
+
+	void replyOk(const QString& message) override
+	{
+		copyData(message);
+		form.writeCoverageReport(fileName);
+		delete this;
+	}
+
+private:
+	DebuggerForm& form;
+	QString fileName;
+};
+
+
 class ListDebuggablesHandler : public SimpleCommand
 {
 public:
@@ -249,6 +292,34 @@ void DebuggerForm::createActions()
 	viewSlotsAction->setStatusTip(tr("Toggle the slots display"));
 	viewSlotsAction->setCheckable(true);
 
+	viewSourceAction = new QAction(tr("Source"), this);
+	viewSourceAction->setStatusTip(tr("Toggle the source code display"));
+	viewSourceAction->setCheckable(true);
+
+	viewHotSpotsAction = new QAction(tr("Profiler"), this);
+	viewHotSpotsAction->setStatusTip(tr("Toggle the sampling profiler display"));
+	viewHotSpotsAction->setCheckable(true);
+
+	viewCallTreeAction = new QAction(tr("Call profiler"), this);
+	viewCallTreeAction->setStatusTip(tr("Toggle the instrumenting profiler display"));
+	viewCallTreeAction->setCheckable(true);
+
+	viewFrameBudgetAction = new QAction(tr("Frame budget"), this);
+	viewFrameBudgetAction->setStatusTip(tr("Toggle the frame budget display"));
+	viewFrameBudgetAction->setCheckable(true);
+
+	viewIoPortsAction = new QAction(tr("I/O ports"), this);
+	viewIoPortsAction->setStatusTip(tr("Toggle the I/O port traffic display"));
+	viewIoPortsAction->setCheckable(true);
+
+	viewTraceAction = new QAction(tr("Trace"), this);
+	viewTraceAction->setStatusTip(tr("Toggle the tracepoint display"));
+	viewTraceAction->setCheckable(true);
+
+	viewInstructionTraceAction = new QAction(tr("Instruction trace"), this);
+	viewInstructionTraceAction->setStatusTip(tr("Toggle the instruction trace display"));
+	viewInstructionTraceAction->setCheckable(true);
+
 	viewMemoryAction = new QAction(tr("Memory"), this);
 	viewMemoryAction->setStatusTip(tr("Toggle the main memory display"));
 	viewMemoryAction->setCheckable(true);
@@ -294,9 +365,21 @@ void DebuggerForm::createActions()
 	executeStepAction->setStatusTip(tr("Execute a single instruction"));
 	executeStepAction->setIcon(QIcon(":/icons/stepinto.png"));
 	executeStepAction->setEnabled(false);
-	connect(this, &DebuggerForm::runStateEntered,   [this]{ executeStepAction->setEnabled(false); });
+	// stays enabled during a step, so a repeating key can queue more steps
+	connect(this, &DebuggerForm::runStateEntered,   [this]{ executeStepAction->setEnabled(stepping); });
 	connect(this, &DebuggerForm::breakStateEntered, [this]{ executeStepAction->setEnabled(true); });
 
+	executeStepManyAction = new QAction(tr("Step many ..."), this);
+	executeStepManyAction->setShortcut(tr("Shift+F7"));
+	executeStepManyAction->setStatusTip(tr("Execute a number of instructions and only then update the views"));
+	executeStepManyAction->setEnabled(false);
+	connect(this, &DebuggerForm::runStateEntered,   [this]{ executeStepManyAction->setEnabled(false); });
+	connect(this, &DebuggerForm::breakStateEntered, [this]{ executeStepManyAction->setEnabled(true); });
+
+	executeStepTraceAction = new QAction(tr("Trace steps"), this);
+	executeStepTraceAction->setStatusTip(tr("Add the registers before every step to the instruction trace"));
+	executeStepTraceAction->setCheckable(true);
+
 	executeStepOverAction = new QAction(tr("Step over"), this);
 	executeStepOverAction->setShortcut(tr("F8"));
 	executeStepOverAction->setStatusTip(tr("Execute the next instruction including any called subroutines"));
@@ -344,6 +427,31 @@ void DebuggerForm::createActions()
 	breakpointAddAction->setStatusTip(tr("Add a breakpoint at a location"));
 	breakpointAddAction->setEnabled(false);
 
+	breakpointImportAction = new QAction(tr("Import ..."), this);
+	breakpointImportAction->setStatusTip(tr("Set the breakpoints listed in a file"));
+	breakpointImportAction->setEnabled(false);
+
+	breakpointExportAction = new QAction(tr("Export ..."), this);
+	breakpointExportAction->setStatusTip(tr("Write all breakpoints to a file"));
+
+	coverageRecordAction = new QAction(tr("Record"), this);
+	coverageRecordAction->setStatusTip(tr("Record which instructions are executed (slows down emulation)"));
+	coverageRecordAction->setCheckable(true);
+	coverageRecordAction->setEnabled(false);
+
+	coverageClearAction = new QAction(tr("Clear"), this);
+	coverageClearAction->setStatusTip(tr("Forget the recorded coverage"));
+
+	coverageSaveAction = new QAction(tr("Save ..."), this);
+	coverageSaveAction->setStatusTip(tr("Save the recorded coverage to a file"));
+
+	coverageMergeAction = new QAction(tr("Merge ..."), this);
+	coverageMergeAction->setStatusTip(tr("Add the coverage saved from an earlier run"));
+
+	coverageReportAction = new QAction(tr("Export per routine ..."), this);
+	coverageReportAction->setStatusTip(tr("Write the coverage of each routine in the visible memory to a file"));
+	coverageReportAction->setEnabled(false);
+
 	helpAboutAction = new QAction(tr("&About"), this);
 	helpAboutAction->setStatusTip(tr("Show the application information"));
 
@@ -366,6 +474,13 @@ void DebuggerForm::createActions()
 	connect(viewStackAction, &QAction::triggered, this, &DebuggerForm::toggleStackDisplay);
 	connect(viewSlotsAction, &QAction::triggered, this, &DebuggerForm::toggleSlotsDisplay);
 	connect(viewMemoryAction, &QAction::triggered, this, &DebuggerForm::toggleMemoryDisplay);
+	connect(viewSourceAction, &QAction::triggered, this, &DebuggerForm::toggleSourceDisplay);
+	connect(viewHotSpotsAction, &QAction::triggered, this, &DebuggerForm::toggleHotSpotsDisplay);
+	connect(viewCallTreeAction, &QAction::triggered, this, &DebuggerForm::toggleCallTreeDisplay);
+	connect(viewFrameBudgetAction, &QAction::triggered, this, &DebuggerForm::toggleFrameBudgetDisplay);
+	connect(viewIoPortsAction, &QAction::triggered, this, &DebuggerForm::toggleIoPortsDisplay);
+	connect(viewTraceAction, &QAction::triggered, this, &DebuggerForm::toggleTraceDisplay);
+	connect(viewInstructionTraceAction, &QAction::triggered, this, &DebuggerForm::toggleInstructionTraceDisplay);
 	connect(viewDebuggableViewerAction, &QAction::triggered, this, &DebuggerForm::addDebuggableViewer);
 	connect(viewBitMappedAction, &QAction::triggered, this, &DebuggerForm::toggleBitMappedDisplay);
 	connect(viewCharMappedAction, &QAction::triggered, this, &DebuggerForm::toggleCharMappedDisplay);
@@ -376,12 +491,20 @@ void DebuggerForm::createActions()
 	connect(executeBreakAction, &QAction::triggered, this, &DebuggerForm::executeBreak);
 	connect(executeRunAction, &QAction::triggered, this, &DebuggerForm::executeRun);
 	connect(executeStepAction, &QAction::triggered, this, &DebuggerForm::executeStep);
+	connect(executeStepManyAction, &QAction::triggered, this, &DebuggerForm::executeStepMany);
 	connect(executeStepOverAction, &QAction::triggered, this, &DebuggerForm::executeStepOver);
 	connect(executeRunToAction, &QAction::triggered, this, &DebuggerForm::executeRunTo);
 	connect(executeStepOutAction, &QAction::triggered, this, &DebuggerForm::executeStepOut);
 	connect(executeStepBackAction, &QAction::triggered, this, &DebuggerForm::executeStepBack);
 	connect(breakpointToggleAction, &QAction::triggered, this, &DebuggerForm::toggleBreakpoint);
 	connect(breakpointAddAction, &QAction::triggered, this, &DebuggerForm::addBreakpoint);
+	connect(breakpointImportAction, &QAction::triggered, this, &DebuggerForm::importBreakpoints);
+	connect(breakpointExportAction, &QAction::triggered, this, &DebuggerForm::exportBreakpoints);
+	connect(coverageRecordAction, &QAction::triggered, this, &DebuggerForm::recordCoverage);
+	connect(coverageClearAction, &QAction::triggered, this, [this]{ coverage->clear(); });
+	connect(coverageSaveAction, &QAction::triggered, this, &DebuggerForm::saveCoverage);
+	connect(coverageMergeAction, &QAction::triggered, this, &DebuggerForm::mergeCoverage);
+	connect(coverageReportAction, &QAction::triggered, this, &DebuggerForm::exportCoverage);
 	connect(commandAction, &QAction::triggered, this, &DebuggerForm::manageCommandButtons);
 	connect(helpAboutAction, &QAction::triggered, this, &DebuggerForm::showAbout);
 }
@@ -431,6 +554,13 @@ void DebuggerForm::createMenus()
 	viewMenu->addAction(viewSlotsAction);
 	viewMenu->addAction(viewMemoryAction);
 	viewMenu->addAction(viewBreakpointsAction);
+	viewMenu->addAction(viewSourceAction);
+	viewMenu->addAction(viewHotSpotsAction);
+	viewMenu->addAction(viewCallTreeAction);
+	viewMenu->addAction(viewFrameBudgetAction);
+	viewMenu->addAction(viewIoPortsAction);
+	viewMenu->addAction(viewTraceAction);
+	viewMenu->addAction(viewInstructionTraceAction);
 	viewVDPDialogsMenu = viewMenu->addMenu("VDP");
 	viewMenu->addSeparator();
 	viewFloatingWidgetsMenu = viewMenu->addMenu("Floating widgets:");
@@ -459,11 +589,26 @@ void DebuggerForm::createMenus()
 	executeMenu->addAction(executeStepOutAction);
 	executeMenu->addAction(executeStepBackAction);
 	executeMenu->addAction(executeRunToAction);
+	executeMenu->addSeparator();
+	executeMenu->addAction(executeStepManyAction);
+	executeMenu->addAction(executeStepTraceAction);
 
 	// create breakpoint menu
 	breakpointMenu = menuBar()->addMenu(tr("&Breakpoint"));
 	breakpointMenu->addAction(breakpointToggleAction);
 	breakpointMenu->addAction(breakpointAddAction);
+	breakpointMenu->addSeparator();
+	breakpointMenu->addAction(breakpointImportAction);
+	breakpointMenu->addAction(breakpointExportAction);
+
+	// create coverage menu
+	coverageMenu = menuBar()->addMenu(tr("Co&verage"));
+	coverageMenu->addAction(coverageRecordAction);
+	coverageMenu->addAction(coverageClearAction);
+	coverageMenu->addSeparator();
+	coverageMenu->addAction(coverageSaveAction);
+	coverageMenu->addAction(coverageMergeAction);
+	coverageMenu->addAction(coverageReportAction);
 
 	// create command menu
 	commandMenu = menuBar()->addMenu("&Commands");
@@ -545,6 +690,8 @@ void DebuggerForm::createForm()
 	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
 
 	// create the memory view widget
+	heatmap = new AccessHeatmap(this);
+	coverage = new CodeCoverage(this);
 	mainMemoryView = new MainMemoryViewer();
 	dw = new DockableWidget(dockMan);
 	dw->setWidget(mainMemoryView);
@@ -616,6 +763,96 @@ void DebuggerForm::createForm()
 	dw->setClosable(true);
 	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
 
+	// create source viewer
+	sourceView = new SourceViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(sourceView);
+	dw->setTitle(tr("Source"));
+	dw->setId("SOURCEVIEW");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create profiler hot spot list
+	profiler = new SampleProfiler(this);
+	hotSpotView = new HotSpotViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(hotSpotView);
+	dw->setTitle(tr("Profiler"));
+	dw->setId("HOTSPOTS");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create call tree of the instrumenting profiler
+	callProfiler = new CallProfiler(this);
+	callTreeView = new CallTreeViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(callTreeView);
+	dw->setTitle(tr("Call profile"));
+	dw->setId("CALLTREE");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create frame budget timeline
+	frameBudget = new FrameBudget(this);
+	frameBudgetView = new FrameBudgetViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(frameBudgetView);
+	dw->setTitle(tr("Frame budget"));
+	dw->setId("FRAMEBUDGET");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create I/O port profiler
+	ioProfiler = new IoProfiler(this);
+	ioProfilerView = new IoProfilerViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(ioProfilerView);
+	dw->setTitle(tr("I/O ports"));
+	dw->setId("IOPORTS");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create tracepoint view
+	tracer = new Tracer(this);
+	traceView = new TraceViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(traceView);
+	dw->setTitle(tr("Trace"));
+	dw->setId("TRACE");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
+	// create instruction trace browser
+	instructionTrace = new InstructionTrace(this);
+	instructionTraceView = new InstructionTraceViewer();
+	dw = new DockableWidget(dockMan);
+	dw->setWidget(instructionTraceView);
+	dw->setTitle(tr("Instruction trace"));
+	dw->setId("ITRACE");
+	dw->setFloating(false);
+	dw->setDestroyable(false);
+	dw->setMovable(true);
+	dw->setClosable(true);
+	connect(dw, &DockableWidget::visibilityChanged, this, &DebuggerForm::dockWidgetVisibilityChanged);
+
 	// restore layout
 	restoreGeometry(Settings::get().value("Layout/WindowGeometry", saveGeometry()).toByteArray());
 
@@ -641,6 +878,13 @@ void DebuggerForm::createForm()
 		list.append(QString("DEBUG D V B %1 %2 -1").arg(codeW)
 		                                             .arg(regW + flagW + slotW + stackW));
 	}
+	// layouts saved before these views existed
+	for (QString id : {"SOURCEVIEW", "HOTSPOTS", "CALLTREE", "FRAMEBUDGET", "IOPORTS", "TRACE", "ITRACE"}) {
+		if (std::none_of(list.begin(), list.end(),
+		                 [&](const QString& l) { return l.startsWith(id + ' '); })) {
+			list.append(id + " D H B 0 -1 -1");
+		}
+	}
 
 	// restore commands
 	restoreCommands(Settings::get().value("Commands/Tcl", saveCommands()).toByteArray());
@@ -696,9 +940,39 @@ void DebuggerForm::createForm()
 
 	// Breakpoint viewer
 	connect(this, &DebuggerForm::breakpointsUpdated, bpView, &BreakpointViewer::refresh);
+	connect(this, &DebuggerForm::breakpointChanged, bpView, &BreakpointViewer::refreshBreakpoint);
 	connect(this, &DebuggerForm::runStateEntered, bpView, &BreakpointViewer::setRunState);
 	connect(this, &DebuggerForm::breakStateEntered, bpView, &BreakpointViewer::setBreakState);
 
+	// Source viewer
+	connect(this, &DebuggerForm::symbolsChanged, sourceView, &SourceViewer::refresh);
+	connect(this, &DebuggerForm::symbolFilesChanged, sourceView, &SourceViewer::refresh);
+	connect(this, &DebuggerForm::settingsChanged, sourceView, &SourceViewer::updateLayout);
+
+	// Sampling profiler
+	connect(profiler, &SampleProfiler::updated, disasmView, [this]{ disasmView->update(); });
+	connect(this, &DebuggerForm::symbolsChanged, hotSpotView, &HotSpotViewer::refresh);
+	connect(hotSpotView, &HotSpotViewer::addressSelected, this,
+	        [this](uint16_t addr) { disasmView->setCursorAddress(addr, 0, DisasmViewer::MiddleAlways); });
+
+	// Code coverage
+	connect(coverage, &CodeCoverage::updated, disasmView, [this]{ disasmView->update(); });
+	connect(coverage, &CodeCoverage::runningChanged, coverageRecordAction, &QAction::setChecked);
+
+	// Instrumenting profiler
+	connect(callTreeView, &CallTreeViewer::addressSelected, this,
+	        [this](uint16_t addr) { disasmView->setCursorAddress(addr, 0, DisasmViewer::MiddleAlways); });
+
+	// Tracepoints
+	connect(this, &DebuggerForm::symbolsChanged, traceView, &TraceViewer::symbolsChanged);
+	connect(traceView, &TraceViewer::addressSelected, this,
+	        [this](uint16_t addr) { disasmView->setCursorAddress(addr, 0, DisasmViewer::MiddleAlways); });
+
+	// Instruction trace
+	connect(this, &DebuggerForm::symbolsChanged, instructionTraceView, &InstructionTraceViewer::symbolsChanged);
+	connect(instructionTraceView, &InstructionTraceViewer::addressSelected, this,
+	        [this](uint16_t addr) { disasmView->setCursorAddress(addr, 0, DisasmViewer::MiddleAlways); });
+
 	// CPU regs viewer
 	// Hook up the register viewer with the main memory viewer
 	connect(regsView, &CPURegsViewer::registerChanged, mainMemoryView, &MainMemoryViewer::registerChanged);
@@ -719,10 +993,29 @@ void DebuggerForm::createForm()
 	disasmView->setSymbolTable(&session.symbolTable());
 	mainMemoryView->setRegsView(regsView);
 	mainMemoryView->setSymbolTable(&session.symbolTable());
+	mainMemoryView->setBreakpoints(&session.breakpoints());
+	mainMemoryView->setHeatmap(heatmap);
+	disasmView->setCoverage(coverage);
 	mainMemoryView->setDebuggable("memory", 0x10000);
 	stackView->setData(mainMemory, 0x10000);
 	slotView->setMemoryLayout(&memLayout);
 	bpView->setBreakpoints(&session.breakpoints());
+	sourceView->setMemoryLayout(&memLayout);
+	sourceView->setSymbolTable(&session.symbolTable());
+	profiler->setMemoryLayout(&memLayout);
+	disasmView->setProfiler(profiler);
+	hotSpotView->setProfiler(profiler);
+	hotSpotView->setMemoryLayout(&memLayout);
+	hotSpotView->setSymbolTable(&session.symbolTable());
+	callTreeView->setProfiler(callProfiler);
+	callTreeView->setSymbolTable(&session.symbolTable());
+	frameBudgetView->setFrameBudget(frameBudget);
+	frameBudgetView->setSymbolTable(&session.symbolTable());
+	ioProfilerView->setProfiler(ioProfiler);
+	traceView->setTracer(tracer);
+	traceView->setSymbolTable(&session.symbolTable());
+	instructionTraceView->setTrace(instructionTrace);
+	instructionTraceView->setSymbolTable(&session.symbolTable());
 }
 
 void DebuggerForm::closeEvent(QCloseEvent* e)
@@ -826,7 +1119,7 @@ void DebuggerForm::initConnection()
 	comm.sendCommand(new SimpleCommand("openmsx_update enable status"));
 
 	auto* command = new Command("openmsx_update enable debug",
-		[=](const QString& /*message*/) {},
+		[=](const QString& /*message*/) { debugUpdates = true; },
 		[=](const QString& /*error*/) {
 			// force reload if debug is disabled
 			connect(bpView, &BreakpointViewer::contentsUpdated, this, [this]{ reloadBreakpoints(false); });
@@ -835,86 +1128,29 @@ void DebuggerForm::initConnection()
 
 	comm.sendCommand(new ListDebuggablesHandler(*this));
 
-	// define 'debug_bin2hex' proc for internal use
-	comm.sendCommand(new SimpleCommand(
-		"proc debug_bin2hex { input } {\n"
-		"  set result \"\"\n"
-		"  foreach i [split $input {}] {\n"
-		"    append result [format %02X [scan $i %c]] \"\"\n"
-		"  }\n"
-		"  return $result\n"
-		"}\n"));
-
-	// define 'debug_hex2bin' proc for internal use
-	comm.sendCommand(new SimpleCommand(
-		"proc debug_hex2bin { input } {\n"
-		"  set result \"\"\n"
-		"  foreach {h l} [split $input {}] {\n"
-		"    append result [binary format H2 $h$l] \"\"\n"
-		"  }\n"
-		"  return $result\n"
-		"}\n"));
-
-	// define 'debug_memmapper' proc for internal use
-	comm.sendCommand(new SimpleCommand(
-		"proc debug_memmapper { } {\n"
-		"  set result \"\"\n"
-		"  for { set page 0 } { $page &lt; 4 } { incr page } {\n"
-		"    set tmp [get_selected_slot $page]\n"
-		"    append result [lindex $tmp 0] [lindex $tmp 1] \"\\n\"\n"
-		"    if { [lsearch [debug list] \"MapperIO\"] != -1} {\n"
-		"      append result [debug read \"MapperIO\" $page] \"\\n\"\n"
-		"    } else {\n"
-		"      append result \"0\\n\"\n"
-		"    }\n"
-		"  }\n"
-		"  for { set ps 0 } { $ps &lt; 4 } { incr ps } {\n"
-		"    if [machine_info issubslotted $ps] {\n"
-		"      append result \"1\\n\"\n"
-		"      for { set ss 0 } { $ss &lt; 4 } { incr ss } {\n"
-		"        append result [get_mapper_size $ps $ss] \"\\n\"\n"
-		"      }\n"
-		"    } else {\n"
-		"      append result \"0\\n\"\n"
-		"      append result [get_mapper_size $ps 0] \"\\n\"\n"
-		"    }\n"
-		"  }\n"
-		"  for { set page 0 } { $page &lt; 4 } { incr page } {\n"
-		"    set tmp [get_selected_slot $page]\n"
-		"    set ss [lindex $tmp 1]\n"
-		"    if { $ss == \"X\" } { set ss 0 }\n"
-		"    set device_list [machine_info slot [lindex $tmp 0] $ss $page]\n"
-		"    set name \"[lindex $device_list 0] romblocks\"\n"
-		"    if { [lsearch [debug list] $name] != -1} {\n"
-		"      append result \"[debug read $name [expr {$page * 0x4000}] ]\\n\"\n"
-		"      append result \"[debug read $name [expr {$page * 0x4000 + 0x2000}] ]\\n\"\n"
-		"    } else {\n"
-		"      append result \"X\\nX\\n\"\n"
-		"    }\n"
-		"  }\n"
-		"  return $result\n"
-		"}\n"));
-
-	// define 'debug_list_all_breaks' proc for internal use
-	comm.sendCommand(new SimpleCommand(
-		"proc debug_list_all_breaks { } {\n"
-		"  set result [debug list_bp]\n"
-		"  append result [debug list_watchpoints]\n"
-		"  append result [debug list_conditions]\n"
-		"  return $result\n"
-		"}\n"));
-
-	// define 'debug_check_debuggables' proc for internal use
-	comm.sendCommand(new SimpleCommand(
-		"proc debug_check_debuggables { debuggables } {\n"
-		"  set all_debuggables [debug list]\n"
-		"  lmap x $debuggables {expr {[lsearch $all_debuggables $x] >= 0}}\n"
-		"}\n"));
-
+	// define the 'debug_*' procs the debugger uses internally
+	QFile script(":/tcl/debugger.tcl");
+	script.open(QIODevice::ReadOnly | QIODevice::Text);
+	comm.sendCommand(new SimpleCommand(escapeXML(QString::fromUtf8(script.readAll()))));
 }
 
 void DebuggerForm::connectionClosed()
 {
+	debugUpdates = false;
+	stepping = false;
+	pendingSteps = 0;
+	// the batch installs still on their way are cancelled without reply
+	pendingInstalls = 0;
+	deferredUpdates.clear();
+	installedIds.clear();
+	profiler->connectionClosed();
+	callProfiler->connectionClosed();
+	heatmap->connectionClosed();
+	coverage->connectionClosed();
+	frameBudget->connectionClosed();
+	ioProfiler->connectionClosed();
+	tracer->connectionClosed();
+	instructionTrace->connectionClosed();
 	systemPauseAction->setEnabled(false);
 	systemRebootAction->setEnabled(false);
 	executeBreakAction->setEnabled(false);
@@ -929,6 +1165,9 @@ void DebuggerForm::connectionClosed()
 	systemConnectAction->setEnabled(true);
 	breakpointToggleAction->setEnabled(false);
 	breakpointAddAction->setEnabled(false);
+	breakpointImportAction->setEnabled(false);
+	coverageRecordAction->setEnabled(false);
+	coverageReportAction->setEnabled(false);
 	commandAction->setEnabled(false);
 
 	for (auto* w : dockMan.managedWidgets()) {
@@ -942,6 +1181,9 @@ void DebuggerForm::finalizeConnection(bool halted)
 	systemRebootAction->setEnabled(true);
 	breakpointToggleAction->setEnabled(true);
 	breakpointAddAction->setEnabled(true);
+	breakpointImportAction->setEnabled(true);
+	coverageRecordAction->setEnabled(true);
+	coverageReportAction->setEnabled(true);
 	commandAction->setEnabled(true);
 
 	// merge breakpoints on connect
@@ -964,8 +1206,20 @@ void DebuggerForm::handleUpdate(const QString& type, const QString& name,
                                 const QString& message)
 {
 	if (type == "debug") {
-		// TODO: read only new breakpoint
-		reloadBreakpoints(false);
+		if (pendingInstalls && message != "remove") {
+			// the reply of the batch install lists the new breakpoints,
+			// anything else is handled once that reply is in
+			deferredUpdates << name;
+		} else if (name.startsWith("bp#") || name.startsWith("wp#") || name.startsWith("cond#")) {
+			// only the breakpoint that changed needs to be read
+			if (message == "remove") {
+				processBreakpoint(name, {});
+			} else {
+				reloadBreakpoint(name);
+			}
+		} else {
+			reloadBreakpoints(false);
+		}
 	} else if (type == "status") {
 		if (name == "cpu") {
 			// running state by default.
@@ -973,7 +1227,8 @@ void DebuggerForm::handleUpdate(const QString& type, const QString& name,
 				breakOccured();
 			} else if (message == "running") {
 				emit runStateEntered();
-				updateData();
+				// a step batch is only shown once it has ended
+				if (!stepping) updateData();
 			}
 		} else if (name == "paused") {
 			pauseStatusChanged(message == "true");
@@ -988,13 +1243,37 @@ void DebuggerForm::pauseStatusChanged(bool isPaused)
 
 void DebuggerForm::breakOccured()
 {
+	if (stepping) {
+		// the batch ended (or hit a breakpoint), collect the registers of
+		// its steps and drop its condition
+		comm.sendCommand(new Command("debug_step_end",
+			[this](const QString& hex) {
+				if (!hex.isEmpty()) instructionTrace->appendRecords(hex);
+			}));
+		stepping = false;
+		if (pendingSteps) {
+			// more steps were requested meanwhile, the views are only
+			// refreshed after those
+			int count = pendingSteps;
+			pendingSteps = 0;
+			executeSteps(count);
+			return;
+		}
+	}
 	emit breakStateEntered();
+	// show the trace up to the point where the emulation stopped
+	if (tracer->isRunning()) tracer->fetch();
+	if (instructionTrace->isRunning()) instructionTrace->fetch();
 	updateData();
 }
 
 void DebuggerForm::updateData()
 {
-	reloadBreakpoints(mergeBreakpoints);
+	// after connecting the full list is read (and merged), after that
+	// openMSX reports every change in the list
+	if (mergeBreakpoints || !debugUpdates) {
+		reloadBreakpoints(mergeBreakpoints);
+	}
 	// only merge the first time after connect
 	mergeBreakpoints = false;
 
@@ -1178,7 +1457,30 @@ void DebuggerForm::executeRun()
 
 void DebuggerForm::executeStep()
 {
-	comm.sendCommand(new SimpleCommand("debug step"));
+	// a held down key repeats faster than the views can be refreshed, the
+	// steps it requests meanwhile are executed as one batch
+	if (stepping) {
+		++pendingSteps;
+		return;
+	}
+	executeSteps(1);
+}
+
+void DebuggerForm::executeStepMany()
+{
+	bool ok;
+	int count = QInputDialog::getInt(this, tr("Step many"), tr("Number of instructions:"),
+	                                 stepCount, 1, 10000000, 1, &ok);
+	if (!ok) return;
+	stepCount = count;
+	executeSteps(count);
+}
+
+void DebuggerForm::executeSteps(int count)
+{
+	stepping = true;
+	comm.sendCommand(new SimpleCommand(QString("debug_step_n %1 %2")
+		.arg(count).arg(executeStepTraceAction->isChecked() ? 1 : 0)));
 	setRunMode();
 }
 
@@ -1232,7 +1534,7 @@ void DebuggerForm::toggleBreakpointAddress(uint16_t addr)
 	}
 	comm.sendCommand(new SimpleCommand(cmd));
 	// Get results from command above
-	reloadBreakpoints();
+	if (!debugUpdates) reloadBreakpoints();
 }
 
 void DebuggerForm::addBreakpoint()
@@ -1249,9 +1551,217 @@ void DebuggerForm::addBreakpoint()
 				bpd.type(), bpd.addressRange(), bpd.slot(), bpd.segment(), bpd.condition());
 			comm.sendCommand(new SimpleCommand(cmd));
 			// Get results of command above
-			reloadBreakpoints();
+			if (!debugUpdates) reloadBreakpoints();
+		}
+	}
+}
+
+void DebuggerForm::importBreakpoints()
+{
+	QString fileName = QFileDialog::getOpenFileName(
+		this, tr("Import breakpoints"), QDir::currentPath(),
+		tr("Breakpoint lists (*.csv *.txt);;All files (*)"));
+	if (fileName.isEmpty()) return;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		QMessageBox::warning(this, tr("Import breakpoints"),
+		                     tr("Can't read %1").arg(fileName));
+		return;
+	}
+
+	// locations are addresses, labels or label+offset
+	auto& symbols = session.symbolTable();
+	auto resolve = [&](const QString& expr) -> std::optional<uint16_t> {
+		if (auto value = stringToValue<uint16_t>(expr)) return value;
+		int op = std::max(expr.lastIndexOf('+'), expr.lastIndexOf('-'));
+		QString label = op > 0 ? expr.left(op).trimmed() : expr;
+		int offset = 0;
+		if (op > 0) {
+			auto v = stringToValue<uint16_t>(expr.mid(op + 1));
+			if (!v) return {};
+			offset = expr[op] == '+' ? *v : -*v;
+		}
+		Symbol* sym = symbols.getAddressSymbol(label);
+		if (!sym) return {};
+		return uint16_t(sym->value() + offset);
+	};
+
+	QStringList errors;
+	auto bps = Breakpoints::importBreakpoints(QString::fromUtf8(file.readAll()), resolve, errors);
+	if (!errors.empty()) {
+		int choice = QMessageBox::warning(this, tr("Import breakpoints"),
+			tr("%1 line(s) could not be read:\n%2\n\nImport the other %3 breakpoint(s)?")
+			.arg(errors.size()).arg(errors.mid(0, 10).join('\n')).arg(bps.size()),
+			QMessageBox::Yes | QMessageBox::No);
+		if (choice == QMessageBox::No) return;
+	}
+	if (!bps.empty()) installBreakpoints(std::move(bps));
+}
+
+void DebuggerForm::exportBreakpoints()
+{
+	QString fileName = QFileDialog::getSaveFileName(
+		this, tr("Export breakpoints"), QDir::currentPath(),
+		tr("Breakpoint lists (*.csv *.txt);;All files (*)"));
+	if (fileName.isEmpty()) return;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+		QMessageBox::warning(this, tr("Export breakpoints"),
+		                     tr("Can't write %1").arg(fileName));
+		return;
+	}
+	file.write(session.breakpoints().exportBreakpoints().toUtf8());
+}
+
+void DebuggerForm::installBreakpoints(std::vector<Breakpoint> bps)
+{
+	// one round trip for all breakpoints, the reply lists the new ids
+	++pendingInstalls;
+	QString cmd = Breakpoints::createBatchSetCommand(bps);
+	auto* command = new Command(cmd,
+		[this, bps = std::move(bps)](const QString& message) {
+			--pendingInstalls;
+			QStringList ids = Breakpoints::parseBatchReply(message);
+			session.breakpoints().insertBreakpoints(bps, ids);
+			updateBreakpointViews();
+			for (const auto& id : ids) {
+				if (!id.isEmpty()) installedIds.insert(id);
+			}
+			if (!pendingInstalls) processDeferredUpdates();
+			int failed = std::count(ids.begin(), ids.end(), QString());
+			if (failed || ids.size() != int(bps.size())) {
+				statusBar()->showMessage(tr("%1 of %2 breakpoints could not be set")
+					.arg(int(bps.size()) - ids.size() + failed).arg(bps.size()));
+			}
+		},
+		[this](const QString& error) {
+			--pendingInstalls;
+			statusBar()->showMessage(tr("Setting breakpoints failed: %1").arg(error.trimmed()));
+			if (!pendingInstalls) {
+				// the complete list covers the deferred updates as well
+				deferredUpdates.clear();
+				installedIds.clear();
+			}
+			reloadBreakpoints(false);
+		});
+	comm.sendCommand(command);
+}
+
+void DebuggerForm::processDeferredUpdates()
+{
+	// updates that came in while batches were installed, except for the
+	// breakpoints those batches set themselves
+	bool reloadAll = false;
+	for (const auto& name : deferredUpdates) {
+		if (installedIds.contains(name)) continue;
+		if (name.startsWith("bp#") || name.startsWith("wp#") || name.startsWith("cond#")) {
+			reloadBreakpoint(name);
+		} else {
+			reloadAll = true;
+		}
+	}
+	deferredUpdates.clear();
+	installedIds.clear();
+	if (reloadAll) reloadBreakpoints(false);
+}
+
+void DebuggerForm::recordCoverage()
+{
+	if (coverage->isRunning()) {
+		coverage->stop();
+	} else {
+		coverage->start();
+	}
+}
+
+void DebuggerForm::saveCoverage()
+{
+	QString fileName = QFileDialog::getSaveFileName(
+		this, tr("Save coverage"), QDir::currentPath(),
+		tr("Coverage files (*.cov);;All files (*)"));
+	if (fileName.isEmpty()) return;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+		QMessageBox::warning(this, tr("Save coverage"),
+		                     tr("Can't write %1").arg(fileName));
+		return;
+	}
+	file.write(coverage->save().toLatin1());
+}
+
+void DebuggerForm::mergeCoverage()
+{
+	QString fileName = QFileDialog::getOpenFileName(
+		this, tr("Merge coverage"), QDir::currentPath(),
+		tr("Coverage files (*.cov);;All files (*)"));
+	if (fileName.isEmpty()) return;
+
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		QMessageBox::warning(this, tr("Merge coverage"),
+		                     tr("Can't read %1").arg(fileName));
+		return;
+	}
+	if (!coverage->merge(QString::fromLatin1(file.readAll()))) {
+		QMessageBox::warning(this, tr("Merge coverage"),
+		                     tr("Some lines of %1 were not valid coverage data").arg(fileName));
+	}
+}
+
+void DebuggerForm::exportCoverage()
+{
+	QString fileName = QFileDialog::getSaveFileName(
+		this, tr("Export coverage per routine"), QDir::currentPath(),
+		tr("Comma separated values (*.csv);;All files (*)"));
+	if (fileName.isEmpty()) return;
+
+	// the routines are disassembled, so all memory must be up to date
+	comm.sendCommand(new CoverageReportRequest(*this, fileName));
+}
+
+void DebuggerForm::writeCoverageReport(const QString& fileName)
+{
+	QFile file(fileName);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+		QMessageBox::warning(this, tr("Export coverage per routine"),
+		                     tr("Can't write %1").arg(fileName));
+		return;
+	}
+
+	// routines are the jump labels in the visible memory, each one runs
+	// up to the next label
+	auto& symbols = session.symbolTable();
+	std::vector<Symbol*> routines;
+	for (auto* sym = symbols.findFirstAddressSymbol(0, &memLayout); sym;
+	     sym = symbols.findNextAddressSymbol(&memLayout)) {
+		if (sym->type() == Symbol::JUMPLABEL) routines.push_back(sym);
+	}
+
+	QString text = "# routine,address,instructions,executed,percentage\n";
+	DisasmLines lines;
+	for (size_t i = 0; i < routines.size(); ++i) {
+		int start = routines[i]->value();
+		int end = i + 1 < routines.size() ? routines[i + 1]->value() : 0x10000;
+		if (end <= start) continue; // more labels on one address
+		dasm(mainMemory, start, end - 1, lines, &memLayout, &symbols, 0);
+		int total = 0;
+		int executed = 0;
+		for (const auto& row : lines) {
+			if (row.rowType != DisasmRow::INSTRUCTION) continue;
+			++total;
+			if (coverage->isCovered(row.addr, &memLayout)) ++executed;
 		}
+		text += QString("%1,0x%2,%3,%4,%5\n")
+			.arg(routines[i]->text())
+			.arg(start, 4, 16, QChar('0'))
+			.arg(total).arg(executed)
+			.arg(total ? 100.0 * executed / total : 0.0, 0, 'f', 1);
 	}
+	file.write(text.toUtf8());
+	statusBar()->showMessage(tr("Coverage of %1 routines written to %2").arg(routines.size()).arg(fileName));
 }
 
 void DebuggerForm::manageCommandButtons()
@@ -1298,6 +1808,41 @@ void DebuggerForm::toggleSlotsDisplay()
 	toggleView(qobject_cast<DockableWidget*>(slotView->parentWidget()));
 }
 
+void DebuggerForm::toggleSourceDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(sourceView->parentWidget()));
+}
+
+void DebuggerForm::toggleHotSpotsDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(hotSpotView->parentWidget()));
+}
+
+void DebuggerForm::toggleCallTreeDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(callTreeView->parentWidget()));
+}
+
+void DebuggerForm::toggleFrameBudgetDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(frameBudgetView->parentWidget()));
+}
+
+void DebuggerForm::toggleIoPortsDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(ioProfilerView->parentWidget()));
+}
+
+void DebuggerForm::toggleTraceDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(traceView->parentWidget()));
+}
+
+void DebuggerForm::toggleInstructionTraceDisplay()
+{
+	toggleView(qobject_cast<DockableWidget*>(instructionTraceView->parentWidget()));
+}
+
 void DebuggerForm::toggleBitMappedDisplay()
 {
 	//toggleView(qobject_cast<DockableWidget*>(slotView->parentWidget()));
@@ -1492,6 +2037,13 @@ void DebuggerForm::updateViewMenu()
 	viewSlotsAction->setChecked(slotView->isVisible());
 	viewMemoryAction->setChecked(mainMemoryView->isVisible());
 	viewBreakpointsAction->setChecked(bpView->isVisible());
+	viewSourceAction->setChecked(sourceView->isVisible());
+	viewHotSpotsAction->setChecked(hotSpotView->isVisible());
+	viewCallTreeAction->setChecked(callTreeView->isVisible());
+	viewFrameBudgetAction->setChecked(frameBudgetView->isVisible());
+	viewIoPortsAction->setChecked(ioProfilerView->isVisible());
+	viewTraceAction->setChecked(traceView->isVisible());
+	viewInstructionTraceAction->setChecked(instructionTraceView->isVisible());
 }
 
 void DebuggerForm::updateVDPViewMenu()
@@ -1607,21 +2159,43 @@ void DebuggerForm::reloadBreakpoints(bool merge)
 void DebuggerForm::processBreakpoints(const QString& message)
 {
 	session.breakpoints().setBreakpoints(message);
+	updateBreakpointViews();
+}
+
+void DebuggerForm::updateBreakpointViews()
+{
 	disasmView->update();
+	mainMemoryView->update();
 	session.sessionModified();
 	updateWindowTitle();
 	emit breakpointsUpdated();
 }
 
+void DebuggerForm::reloadBreakpoint(const QString& id)
+{
+	auto* command = new Command("debug_list_break " + id,
+	                            [this, id](const QString& message) {
+	                                    processBreakpoint(id, message);
+	                            });
+	comm.sendCommand(command);
+}
+
+void DebuggerForm::processBreakpoint(const QString& id, const QString& message)
+{
+	if (!session.breakpoints().updateBreakpoint(id, message)) return;
+	disasmView->update();
+	mainMemoryView->update();
+	session.sessionModified();
+	updateWindowTitle();
+	emit breakpointChanged(id);
+}
+
 void DebuggerForm::processMerge(const QString& message)
 {
-	QString bps = session.breakpoints().mergeBreakpoints(message);
-	if (!bps.isEmpty()) {
-		comm.sendCommand(new SimpleCommand(bps));
-		reloadBreakpoints(false);
-	} else {
-		processBreakpoints(message);
-	}
+	auto missing = session.breakpoints().mergeBreakpoints(message);
+	updateBreakpointViews();
+	// set the breakpoints from the session that openMSX doesn't have
+	if (!missing.empty()) installBreakpoints(std::move(missing));
 }
 
 QByteArray DebuggerForm::saveCommands() const
@@ -1670,6 +2244,7 @@ void DebuggerForm::onSlotsUpdated(bool slotsChanged)
 {
 	if (disasmStatus == PC_CHANGED) {
 		disasmView->setProgramCounter(disasmAddress, slotsChanged);
+		sourceView->setProgramCounter(disasmAddress);
 		disasmStatus = RESET;
 	} else {
 		disasmStatus = slotsChanged ? SLOTS_CHANGED : SLOTS_CHECKED;
@@ -1680,6 +2255,7 @@ void DebuggerForm::onPCChanged(uint16_t address)
 {
 	if (disasmStatus != RESET) {
 		disasmView->setProgramCounter(address, disasmStatus == SLOTS_CHANGED);
+		sourceView->setProgramCounter(address);
 	} else {
 		disasmStatus = PC_CHANGED;
 		disasmAddress = address;
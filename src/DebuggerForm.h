@@ -9,8 +9,11 @@
 #include <QMainWindow>
 #include <QMap>
 #include <QPointer>
+#include <QSet>
+#include <QStringList>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 class DisasmViewer;
 class MainMemoryViewer;
@@ -26,6 +29,21 @@ class VDPStatusRegViewer;
 class VDPRegViewer;
 class VDPCommandRegViewer;
 class BreakpointViewer;
+class SourceViewer;
+class SampleProfiler;
+class HotSpotViewer;
+class CallProfiler;
+class CallTreeViewer;
+class AccessHeatmap;
+class CodeCoverage;
+class FrameBudget;
+class FrameBudgetViewer;
+class IoProfiler;
+class IoProfilerViewer;
+class Tracer;
+class TraceViewer;
+class InstructionTrace;
+class InstructionTraceViewer;
 
 
 class DebuggerForm : public QMainWindow
@@ -77,6 +95,7 @@ private:
 	QMenu* viewFloatingWidgetsMenu;
 	QMenu* executeMenu;
 	QMenu* breakpointMenu;
+	QMenu* coverageMenu;
 	QMenu* commandMenu;
 	QMenu* helpMenu;
 	QDialog* commandDialog;
@@ -112,6 +131,13 @@ private:
 	QAction* viewSlotsAction;
 	QAction* viewMemoryAction;
 	QAction* viewBreakpointsAction;
+	QAction* viewSourceAction;
+	QAction* viewHotSpotsAction;
+	QAction* viewCallTreeAction;
+	QAction* viewFrameBudgetAction;
+	QAction* viewIoPortsAction;
+	QAction* viewTraceAction;
+	QAction* viewInstructionTraceAction;
 	QAction* viewDebuggableViewerAction;
 
 	QAction* viewBitMappedAction;
@@ -124,6 +150,8 @@ private:
 	QAction* executeBreakAction;
 	QAction* executeRunAction;
 	QAction* executeStepAction;
+	QAction* executeStepManyAction;
+	QAction* executeStepTraceAction;
 	QAction* executeStepOverAction;
 	QAction* executeRunToAction;
 	QAction* executeStepOutAction;
@@ -131,6 +159,13 @@ private:
 
 	QAction* breakpointToggleAction;
 	QAction* breakpointAddAction;
+	QAction* breakpointImportAction;
+	QAction* breakpointExportAction;
+	QAction* coverageRecordAction;
+	QAction* coverageClearAction;
+	QAction* coverageSaveAction;
+	QAction* coverageMergeAction;
+	QAction* coverageReportAction;
 	QAction* commandAction;
 	QAction* helpAboutAction;
 
@@ -148,6 +183,21 @@ private:
 	VDPRegViewer* VDPRegView;
 	VDPCommandRegViewer* VDPCommandRegView;
 	BreakpointViewer* bpView;
+	SourceViewer* sourceView;
+	SampleProfiler* profiler;
+	HotSpotViewer* hotSpotView;
+	CallProfiler* callProfiler;
+	CallTreeViewer* callTreeView;
+	AccessHeatmap* heatmap;
+	CodeCoverage* coverage;
+	FrameBudget* frameBudget;
+	FrameBudgetViewer* frameBudgetView;
+	IoProfiler* ioProfiler;
+	IoProfilerViewer* ioProfilerView;
+	Tracer* tracer;
+	TraceViewer* traceView;
+	InstructionTrace* instructionTrace;
+	InstructionTraceViewer* instructionTraceView;
 	QPointer<SymbolManager> symManager;
 
 	CommClient& comm;
@@ -156,6 +206,16 @@ private:
 	uint8_t mainMemory[0x10000 + 4] = {}; // 4 extra to avoid wrap-check during disasm
 
 	bool mergeBreakpoints;
+	// openMSX reports breakpoint changes, no need to poll the list
+	bool debugUpdates = false;
+	// batch installs in progress, their reply brings the new breakpoints
+	int pendingInstalls = 0;
+	QStringList deferredUpdates;  // breakpoint updates received meanwhile
+	QSet<QString> installedIds;   // set by the batches, no need to read them
+	// a batch of steps is executing, more were requested meanwhile
+	bool stepping = false;
+	int pendingSteps = 0;
+	int stepCount = 1000;
 	QMap<QString, int> debuggables;
 
 	static int counter;
@@ -183,6 +243,13 @@ private:
 	void toggleFlagsDisplay();
 	void toggleStackDisplay();
 	void toggleSlotsDisplay();
+	void toggleSourceDisplay();
+	void toggleHotSpotsDisplay();
+	void toggleCallTreeDisplay();
+	void toggleFrameBudgetDisplay();
+	void toggleIoPortsDisplay();
+	void toggleTraceDisplay();
+	void toggleInstructionTraceDisplay();
 	void toggleMemoryDisplay();
 	void toggleBitMappedDisplay();
 	void toggleCharMappedDisplay();
@@ -194,6 +261,8 @@ private:
 	void executeBreak();
 	void executeRun();
 	void executeStep();
+	void executeStepMany();
+	void executeSteps(int count);
 	void executeStepOver();
 	void executeRunTo();
 	void executeStepOut();
@@ -202,6 +271,15 @@ private:
 	void toggleBreakpoint();
 	void toggleBreakpointAddress(uint16_t addr);
 	void addBreakpoint();
+	void importBreakpoints();
+	void exportBreakpoints();
+	void installBreakpoints(std::vector<Breakpoint> bps);
+
+	void recordCoverage();
+	void saveCoverage();
+	void mergeCoverage();
+	void exportCoverage();
+	void writeCoverageReport(const QString& fileName);
 
 	void manageCommandButtons();
 	void manageCommandButtonsFinished(int result);
@@ -221,7 +299,11 @@ private:
 	void symbolFileChanged();
 	void showFloatingWidget();
 	void processBreakpoints(const QString& message);
+	void updateBreakpointViews();
 	void processMerge(const QString& message);
+	void reloadBreakpoint(const QString& id);
+	void processDeferredUpdates();
+	void processBreakpoint(const QString& id, const QString& message);
 
 	QByteArray saveCommands() const;
 	void restoreCommands(const QByteArray& input);
@@ -232,6 +314,7 @@ private:
 	friend class CPURegRequest;
 	friend class ListDebuggablesHandler;
 	friend class DebuggableSizeHandler;
+	friend class CoverageReportRequest;
 
 signals:
 	void connected();
@@ -241,6 +324,7 @@ signals:
 	void runStateEntered();
 	void breakStateEntered();
 	void breakpointsUpdated();
+	void breakpointChanged(const QString& id);
 	void debuggablesChanged(const QMap<QString, int>& list);
 };
 
@@ -3,6 +3,8 @@
 #include "CommClient.h"
 #include "DebuggerData.h"
 #include "Settings.h"
+#include "SampleProfiler.h"
+#include "CodeCoverage.h"
 #include <QPaintEvent>
 #include <QPainter>
 #include <QStyleOptionFocusRect>
@@ -188,6 +190,18 @@ void DisasmViewer::paintEvent(QPaintEvent* e)
 	const DisasmRow* row;
 	bool displayDisasm = memory != nullptr && isEnabled();
 
+	// fetch the breakpoints and watchpoints for all rows that can possibly
+	// be visible in one query, instead of searching them for every row
+	std::vector<const Breakpoint*> marks;
+	if (displayDisasm && !disasmLines.empty()) {
+		int maxRows = (height() - frameT - frameB) / std::min(codeFontHeight, labelFontHeight) + 1;
+		int last = std::min(disasmTopLine + maxRows, int(disasmLines.size())) - 1;
+		uint16_t firstAddr = disasmLines[disasmTopLine].addr;
+		uint16_t lastAddr = disasmLines[last].addr;
+		marks = lastAddr >= firstAddr ? breakpoints->findInRange(firstAddr, lastAddr)
+		                              : breakpoints->findInRange(0, 0xFFFF);
+	}
+
 	Settings& s = Settings::get();
 	p.setFont(s.font(Settings::CODE_FONT));
 	while (y < height() - frameB) {
@@ -235,21 +249,43 @@ void DisasmViewer::paintEvent(QPaintEvent* e)
 			p.setFont(s.font(Settings::CODE_FONT));
 		} else {
 			// draw code line
-			// default to text pen
+			// default to text pen, code that never ran is greyed out
 			if (!isCursorLine) {
-				p.setPen(s.fontColor(Settings::CODE_FONT));
+				bool unused = coverage && !coverage->isEmpty() && row->infoLine == 0 &&
+				              !coverage->isCovered(row->addr, memLayout);
+				p.setPen(unused ? palette().color(QPalette::Disabled, QPalette::Text)
+				                : s.fontColor(Settings::CODE_FONT));
+			}
+
+			// draw profiler heat, on a log scale so that code that is
+			// only a bit hot still shows up next to the hottest loop
+			if (row->infoLine == 0 && profiler && profiler->peak()) {
+				if (uint32_t hits = profiler->count(row->addr, memLayout)) {
+					double heat = std::log1p(hits) / std::log1p(profiler->peak());
+					p.fillRect(frameL + 28, y, 4, h, QColor::fromHsvF((1.0 - heat) / 6.0, 1.0, 1.0));
+				}
 			}
 
 			// draw breakpoint marker
 			if (row->infoLine == 0) {
-				if (breakpoints->isBreakpoint(row->addr)) {
+				bool isBreak = false;
+				bool isWatch = false;
+				for (const auto* bp : marks) {
+					if (bp->range->start > row->addr) break; // sorted on start
+					if (bp->type == Breakpoint::BREAKPOINT) {
+						isBreak |= bp->range->start == row->addr;
+					} else {
+						isWatch |= bp->range->contains(row->addr);
+					}
+				}
+				if (isBreak) {
 					p.drawPixmap(frameL + 2, y + h / 2 -5, breakMarker);
 					if (!isCursorLine) {
 						p.fillRect(frameL + 32, y, width() - 32 - frameL - frameR, h,
 									  Qt::red);
 						p.setPen(Qt::white);
 					}
-				} else if (breakpoints->isWatchpoint(row->addr)) {
+				} else if (isWatch) {
 					p.drawPixmap(frameL + 2, y + h / 2 -5, watchMarker);
 				}
 			}
@@ -593,6 +629,16 @@ void DisasmViewer::setSymbolTable(SymbolTable* st)
 	symTable = st;
 }
 
+void DisasmViewer::setProfiler(const SampleProfiler* sp)
+{
+	profiler = sp;
+}
+
+void DisasmViewer::setCoverage(const CodeCoverage* cc)
+{
+	coverage = cc;
+}
+
 void DisasmViewer::keyPressEvent(QKeyEvent* e)
 {
 	switch (e->key()) {
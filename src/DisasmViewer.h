@@ -9,6 +9,8 @@ class CommMemoryRequest;
 class QScrollBar;
 class Breakpoints;
 class SymbolTable;
+class SampleProfiler;
+class CodeCoverage;
 struct MemoryLayout;
 
 class DisasmViewer : public QFrame
@@ -21,6 +23,8 @@ public:
 	void setBreakpoints(Breakpoints* bps);
 	void setMemoryLayout(MemoryLayout* ml);
 	void setSymbolTable(SymbolTable* st);
+	void setProfiler(const SampleProfiler* sp);
+	void setCoverage(const CodeCoverage* cc);
 	void memoryUpdated(CommMemoryRequest* req);
 	void updateCancelled(CommMemoryRequest* req);
 	uint16_t programCounter() const;
@@ -83,6 +87,8 @@ private:
 	Breakpoints* breakpoints;
 	MemoryLayout* memLayout;
 	SymbolTable* symTable;
+	const SampleProfiler* profiler = nullptr;
+	const CodeCoverage* coverage = nullptr;
 
 signals:
 	void breakpointToggled(int addr);
@@ -0,0 +1,50 @@
+#include "FrameBudget.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+// a few records per batch, frequent enough for a smooth scroll
+FrameBudget::FrameBudget(QObject* parent)
+	: PolledCollector("frame", 250, parent)
+	, frames(CAPACITY)
+{
+}
+
+void FrameBudget::start(uint16_t isrEntry, std::optional<uint16_t> isrExit, uint16_t idle)
+{
+	startCollecting(QString("%1 {%2} %3")
+		.arg(isrEntry)
+		.arg(isrExit ? QString::number(*isrExit) : QString())
+		.arg(idle));
+}
+
+void FrameBudget::clear()
+{
+	head = 0;
+	count = 0;
+	dropped = 0;
+	emit updated();
+}
+
+const FrameBudget::Frame& FrameBudget::frame(size_t age) const
+{
+	return frames[(head + CAPACITY - 1 - age) % CAPACITY];
+}
+
+void FrameBudget::processReply(const QString& message)
+{
+	// a Tcl list of "{length busy isr}" records, oldest first
+	QRegExp record("\\{([^}]*)\\}");
+	int added = 0;
+	for (int pos = 0; (pos = record.indexIn(message, pos)) != -1; pos += record.matchedLength()) {
+		auto fields = record.cap(1).split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+		if (fields.size() != 3) continue;
+		Frame f{fields[0].toFloat(), fields[1].toFloat(), fields[2].toFloat()};
+		if (f.dropped()) ++dropped;
+		frames[head] = f;
+		head = (head + 1) % CAPACITY;
+		count = std::min(count + 1, CAPACITY);
+		++added;
+	}
+	if (added) emit updated();
+}
@@ -0,0 +1,55 @@
+#ifndef FRAMEBUDGET_H
+#define FRAMEBUDGET_H
+
+#include "PolledCollector.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Per frame timing of the emulated program: breakpoints (that don't stop
+ * the emulation) on the interrupt handler and on the idle point of the main
+ * loop measure how much of each video frame is in use. openMSX collects one
+ * record per frame, the debugger fetches them in batches and keeps the most
+ * recent ones in a ring buffer.
+ */
+class FrameBudget : public PolledCollector
+{
+	Q_OBJECT
+public:
+	// times are in seconds of emulated time
+	struct Frame {
+		float length; // from this VBLANK interrupt to the next one
+		float busy;   // until the idle point was reached, < 0 if it wasn't
+		float isr;    // time spent in the interrupt handler (all interrupts)
+
+		[[nodiscard]] bool dropped() const { return busy < 0.0f; }
+	};
+
+	static constexpr size_t CAPACITY = 4096;
+
+	FrameBudget(QObject* parent = nullptr);
+
+	// 'isrExit' is the last instruction of the interrupt handler, without
+	// it the time spent in interrupts is not measured
+	void start(uint16_t isrEntry, std::optional<uint16_t> isrExit, uint16_t idle);
+	void clear();
+
+	[[nodiscard]] size_t size() const { return count; }
+	// 0 is the most recent frame
+	[[nodiscard]] const Frame& frame(size_t age) const;
+	[[nodiscard]] uint64_t droppedFrames() const { return dropped; }
+
+signals:
+	void updated();
+
+private:
+	void processReply(const QString& message) override;
+
+	std::vector<Frame> frames; // ring buffer
+	size_t head = 0;           // next position to write
+	size_t count = 0;
+	uint64_t dropped = 0;
+};
+
+#endif // FRAMEBUDGET_H
@@ -0,0 +1,178 @@
+#include "FrameBudgetViewer.h"
+#include "FrameBudget.h"
+#include "SymbolTable.h"
+#include "SymbolCompleter.h"
+#include "Convert.h"
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPainter>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <algorithm>
+
+static constexpr int BAR_WIDTH = 3;
+
+class FrameChart : public QWidget
+{
+public:
+	explicit FrameChart(QWidget* parent = nullptr)
+		: QWidget(parent)
+	{
+		setBackgroundRole(QPalette::Base);
+		setAutoFillBackground(true);
+		setMinimumHeight(60);
+	}
+
+	void setFrameBudget(const FrameBudget* fb) { budget = fb; }
+
+	QSize sizeHint() const override { return {400, 120}; }
+
+protected:
+	void paintEvent(QPaintEvent* /*e*/) override
+	{
+		QPainter p(this);
+		int h = height();
+		// a full frame reaches 2/3 of the height, so overruns stay visible
+		double scale = h * 2.0 / 3.0;
+		int budgetY = h - int(scale);
+
+		if (budget) {
+			// newest frame on the right
+			size_t n = std::min<size_t>(budget->size(), width() / BAR_WIDTH + 1);
+			for (size_t age = 0; age < n; ++age) {
+				const auto& f = budget->frame(age);
+				if (f.length <= 0.0f) continue;
+				int x = width() - int(age + 1) * BAR_WIDTH;
+				auto bar = [&](double time, const QColor& color) {
+					int top = h - int(std::min(time / f.length, 1.5) * scale);
+					p.fillRect(x, top, BAR_WIDTH - 1, h - top, color);
+				};
+				if (f.dropped()) {
+					bar(f.length, QColor(220, 40, 40));
+				} else {
+					bar(f.busy, QColor(80, 170, 80));
+				}
+				bar(f.isr, QColor(70, 110, 200));
+			}
+		}
+
+		p.setPen(QPen(palette().color(QPalette::Text), 1, Qt::DashLine));
+		p.drawLine(0, budgetY, width(), budgetY);
+	}
+
+private:
+	const FrameBudget* budget = nullptr;
+};
+
+FrameBudgetViewer::FrameBudgetViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	isrEntryEdit = new QLineEdit(hexValue(0x0038, 4));
+	isrEntryEdit->setToolTip(tr("Entry of the interrupt handler"));
+	isrExitEdit = new QLineEdit();
+	isrExitEdit->setPlaceholderText(tr("ISR exit"));
+	isrExitEdit->setToolTip(tr("Last instruction of the interrupt handler (optional)"));
+	idleEdit = new QLineEdit();
+	idleEdit->setPlaceholderText(tr("Idle point"));
+	idleEdit->setToolTip(tr("Where the main loop waits for the next frame"));
+	startButton = new QPushButton(tr("Start"));
+	clearButton = new QPushButton(tr("Clear"));
+	statsLabel = new QLabel();
+	chart = new FrameChart();
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(isrEntryEdit);
+	hbox->addWidget(isrExitEdit);
+	hbox->addWidget(idleEdit);
+	hbox->addWidget(startButton);
+	hbox->addWidget(clearButton);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addWidget(statsLabel);
+	vbox->addWidget(chart, 1);
+	setLayout(vbox);
+
+	connect(startButton, &QPushButton::clicked, this, &FrameBudgetViewer::startStop);
+}
+
+void FrameBudgetViewer::setFrameBudget(FrameBudget* fb)
+{
+	budget = fb;
+	chart->setFrameBudget(budget);
+	connect(clearButton, &QPushButton::clicked, budget, &FrameBudget::clear);
+	connect(budget, &FrameBudget::updated, this, &FrameBudgetViewer::updateStatistics);
+	connect(budget, &FrameBudget::runningChanged, this, &FrameBudgetViewer::runningChanged);
+}
+
+void FrameBudgetViewer::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+
+	for (auto* edit : {isrEntryEdit, isrExitEdit, idleEdit}) {
+		auto* completer = new SymbolCompleter(*symTable, false, nullptr, this);
+		edit->setCompleter(completer);
+		connect(edit, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
+	}
+}
+
+std::optional<uint16_t> FrameBudgetViewer::resolve(const QLineEdit* edit) const
+{
+	if (auto addr = stringToValue<uint16_t>(edit->text())) return addr;
+	if (symTable) {
+		if (Symbol* s = symTable->getAddressSymbol(edit->text().trimmed())) {
+			return uint16_t(s->value());
+		}
+	}
+	return {};
+}
+
+void FrameBudgetViewer::startStop()
+{
+	if (budget->isRunning()) {
+		budget->stop();
+		return;
+	}
+	auto isrEntry = resolve(isrEntryEdit);
+	auto isrExit = resolve(isrExitEdit);
+	auto idle = resolve(idleEdit);
+	if (!isrEntry || !idle || (!isrExit && !isrExitEdit->text().trimmed().isEmpty())) {
+		statsLabel->setText(tr("Unknown label or address"));
+		return;
+	}
+	budget->start(*isrEntry, isrExit, *idle);
+}
+
+void FrameBudgetViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+	isrEntryEdit->setEnabled(!running);
+	isrExitEdit->setEnabled(!running);
+	idleEdit->setEnabled(!running);
+}
+
+void FrameBudgetViewer::updateStatistics()
+{
+	chart->update();
+	if (budget->size() == 0) {
+		statsLabel->clear();
+		return;
+	}
+	const auto& last = budget->frame(0);
+	float peak = 0.0f;
+	for (size_t age = 0; age < budget->size(); ++age) {
+		const auto& f = budget->frame(age);
+		if (!f.dropped() && f.length > 0.0f) peak = std::max(peak, f.busy / f.length);
+	}
+	QString lastText = last.dropped() || last.length <= 0.0f
+	                 ? tr("dropped")
+	                 : QString("%1%").arg(int(100.0f * last.busy / last.length));
+	statsLabel->setText(tr("Last frame: %1 (ISR %2%)   Peak: %3%   Dropped: %4")
+		.arg(lastText)
+		.arg(last.length > 0.0f ? int(100.0f * last.isr / last.length) : 0)
+		.arg(int(100.0f * peak))
+		.arg(budget->droppedFrames()));
+}
@@ -0,0 +1,48 @@
+#ifndef FRAMEBUDGETVIEWER_H
+#define FRAMEBUDGETVIEWER_H
+
+#include <QWidget>
+#include <cstdint>
+#include <optional>
+
+class FrameBudget;
+class FrameChart;
+class SymbolTable;
+class QLabel;
+class QLineEdit;
+class QPushButton;
+
+/**
+ * Scrolling bar chart of the frame budget: one bar per video frame, with
+ * the time spent in the interrupt handler and in the main loop stacked
+ * against the length of the frame. Frames in which the main loop didn't
+ * reach its idle point are drawn in red.
+ */
+class FrameBudgetViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	FrameBudgetViewer(QWidget* parent = nullptr);
+
+	void setFrameBudget(FrameBudget* budget);
+	void setSymbolTable(SymbolTable* st);
+
+private:
+	void startStop();
+	void runningChanged(bool running);
+	void updateStatistics();
+	[[nodiscard]] std::optional<uint16_t> resolve(const QLineEdit* edit) const;
+
+	QLineEdit* isrEntryEdit;
+	QLineEdit* isrExitEdit;
+	QLineEdit* idleEdit;
+	QPushButton* startButton;
+	QPushButton* clearButton;
+	QLabel* statsLabel;
+	FrameChart* chart;
+
+	FrameBudget* budget = nullptr;
+	SymbolTable* symTable = nullptr;
+};
+
+#endif // FRAMEBUDGETVIEWER_H
@@ -0,0 +1,138 @@
+#include "FrameRecorder.h"
+#include <QFileInfo>
+#include <QThread>
+
+FrameRecorder::FrameRecorder(QObject* parent)
+	: QObject(parent)
+{
+}
+
+FrameRecorder::~FrameRecorder()
+{
+	if (!worker) return;
+	stop();
+	worker->wait();
+	delete worker;
+}
+
+bool FrameRecorder::start(const QString& path, Format fmt, int frames)
+{
+	if (worker) return false; // still writing the previous recording
+	format = fmt;
+	maxFrames = frames;
+	basePath = path;
+	rawSize = QSize();
+	error.clear();
+	queued = 0;
+	written = 0;
+	dropped = 0;
+	stopping = false;
+	head = 0;
+	tail = 0;
+	pending.acquire(pending.available());
+
+	if (format == RAW_BGRA) {
+		rawFile.setFileName(path);
+		if (!rawFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+			error = rawFile.errorString();
+			return false;
+		}
+	}
+	worker = QThread::create([this] { encodeLoop(); });
+	connect(worker, &QThread::finished, this, &FrameRecorder::encoderFinished);
+	worker->start();
+	emit recordingChanged(true);
+	return true;
+}
+
+void FrameRecorder::stop()
+{
+	if (!worker || stopping) return;
+	// the worker encodes what is still queued before it ends
+	stopping = true;
+	pending.release();
+}
+
+void FrameRecorder::encoderFinished()
+{
+	worker->wait();
+	delete worker;
+	worker = nullptr;
+	rawFile.close();
+	emit progress(written, dropped);
+	emit recordingChanged(false);
+}
+
+void FrameRecorder::addFrame(const QImage& frame)
+{
+	if (!worker || stopping || frame.isNull()) return;
+	if (queued >= maxFrames) {
+		stop();
+		return;
+	}
+	unsigned h = head.load(std::memory_order_relaxed);
+	if (h - tail.load(std::memory_order_acquire) == QUEUE_SIZE) {
+		// encoder is behind, never wait for it
+		++dropped;
+		return;
+	}
+	queue[h % QUEUE_SIZE] = frame;
+	head.store(h + 1, std::memory_order_release);
+	++queued;
+	pending.release();
+}
+
+void FrameRecorder::encodeLoop()
+{
+	while (true) {
+		pending.acquire();
+		unsigned t = tail.load(std::memory_order_relaxed);
+		if (t == head.load(std::memory_order_acquire)) {
+			if (stopping) break;
+			continue;
+		}
+		QImage frame = std::move(queue[t % QUEUE_SIZE]);
+		queue[t % QUEUE_SIZE] = QImage();
+		tail.store(t + 1, std::memory_order_release);
+
+		if (encode(frame, written)) {
+			++written;
+		} else {
+			++dropped;
+		}
+		emit progress(written, dropped);
+		// the stop request may have consumed the wake-up of this frame
+		if (stopping) pending.release();
+	}
+}
+
+bool FrameRecorder::encode(const QImage& frame, int number)
+{
+	if (format == PNG_SEQUENCE) {
+		return frame.save(sequenceName(number), "PNG");
+	}
+	// a raw stream needs one frame size, the first frame sets it
+	if (!rawSize.isValid()) rawSize = frame.size();
+	QImage out = frame.size() == rawSize
+	           ? frame
+	           : frame.scaled(rawSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+	out = out.convertToFormat(QImage::Format_RGB32); // B, G, R, 0xff in memory
+	qint64 rowBytes = 4 * rawSize.width();
+	for (int y = 0; y < out.height(); ++y) {
+		if (rawFile.write(reinterpret_cast<const char*>(out.constScanLine(y)), rowBytes) != rowBytes) {
+			return false;
+		}
+	}
+	return true;
+}
+
+QString FrameRecorder::sequenceName(int number) const
+{
+	QFileInfo info(basePath);
+	QString suffix = info.suffix().isEmpty() ? QString("png") : info.suffix();
+	return QString("%1/%2_%3.%4")
+		.arg(info.path())
+		.arg(info.completeBaseName())
+		.arg(number, 5, 10, QChar('0'))
+		.arg(suffix);
+}
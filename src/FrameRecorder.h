@@ -0,0 +1,78 @@
+#ifndef FRAMERECORDER_H
+#define FRAMERECORDER_H
+
+#include <QFile>
+#include <QImage>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <array>
+#include <atomic>
+
+class QThread;
+
+/**
+ * Writes the frames handed to addFrame() to disk, either as a numbered PNG
+ * sequence or as one file of raw 32-bit BGRA frames (for example for
+ * "ffmpeg -f rawvideo -pixel_format bgra -video_size WxH"). Encoding runs
+ * on a worker thread; the frames get there through a small lock-free ring
+ * buffer with a single producer (the GUI thread) and a single consumer.
+ * When the encoder falls behind, new frames are dropped instead of making
+ * the GUI wait.
+ */
+class FrameRecorder : public QObject
+{
+	Q_OBJECT
+public:
+	enum Format { PNG_SEQUENCE, RAW_BGRA };
+
+	FrameRecorder(QObject* parent = nullptr);
+	~FrameRecorder() override;
+
+	// 'path' is the file name of the raw file, or the name the numbered
+	// PNG files are derived from: "capture.png" gives "capture_00000.png", ...
+	bool start(const QString& path, Format format, int maxFrames);
+	// doesn't wait for the encoder: recordingChanged(false) follows once
+	// the queued frames are written
+	void stop();
+	[[nodiscard]] bool isRecording() const { return worker != nullptr; }
+
+	// queues 'frame' without copying the pixels, ends the recording once
+	// maxFrames were queued
+	void addFrame(const QImage& frame);
+
+	[[nodiscard]] int writtenFrames() const { return written; }
+	[[nodiscard]] int droppedFrames() const { return dropped; }
+	[[nodiscard]] QSize frameSize() const { return rawSize; } // of the raw format, after recording
+	[[nodiscard]] const QString& errorString() const { return error; }
+
+signals:
+	void progress(int written, int dropped);
+	void recordingChanged(bool recording);
+
+private:
+	void encodeLoop();
+	void encoderFinished();
+	bool encode(const QImage& frame, int number);
+	[[nodiscard]] QString sequenceName(int number) const;
+
+	static constexpr unsigned QUEUE_SIZE = 16;
+	std::array<QImage, QUEUE_SIZE> queue;
+	std::atomic<unsigned> head{0}; // next slot to fill, only written by the producer
+	std::atomic<unsigned> tail{0}; // next slot to encode, only written by the consumer
+	QSemaphore pending;            // wakes the worker, the queue itself takes no lock
+	std::atomic<bool> stopping{false};
+	std::atomic<int> written{0};
+	std::atomic<int> dropped{0};
+
+	QThread* worker = nullptr;
+	QFile rawFile;
+	QSize rawSize;
+	QString basePath;
+	QString error;
+	Format format = PNG_SEQUENCE;
+	int maxFrames = 0;
+	int queued = 0; // frames accepted so far, producer side
+};
+
+#endif // FRAMERECORDER_H
@@ -1,7 +1,7 @@
 #include "GotoDialog.h"
 #include "DebugSession.h"
+#include "SymbolCompleter.h"
 #include "Convert.h"
-#include <QCompleter>
 
 
 GotoDialog::GotoDialog(const MemoryLayout& ml, DebugSession *session, QWidget* parent)
@@ -12,9 +12,9 @@ GotoDialog::GotoDialog(const MemoryLayout& ml, DebugSession *session, QWidget* p
 	debugSession = session;
 	if (session) {
 		// create address completer
-		auto* completer = new QCompleter(session->symbolTable().labelList(true, &ml), this);
-		completer->setCaseSensitivity(Qt::CaseInsensitive);
+		auto* completer = new SymbolCompleter(session->symbolTable(), true, &ml, this);
 		edtAddress->setCompleter(completer);
+		connect(edtAddress, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
 		connect(completer,  qOverload<const QString&>(&QCompleter::activated), this, &GotoDialog::addressChanged);
 	}
 
@@ -34,7 +34,6 @@ void GotoDialog::addressChanged(const QString& text)
 	if (!text.isEmpty() && !addr && debugSession) {
 		// try finding a label
 		currentSymbol = debugSession->symbolTable().getAddressSymbol(text);
-		if (!currentSymbol) currentSymbol = debugSession->symbolTable().getAddressSymbol(text, Qt::CaseInsensitive);
 		if (currentSymbol) addr = currentSymbol->value();
 	}
 
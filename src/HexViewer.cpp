@@ -2,6 +2,8 @@
 #include "OpenMSXConnection.h"
 #include "CommClient.h"
 #include "Settings.h"
+#include "DebuggerData.h"
+#include "AccessHeatmap.h"
 #include <QScrollBar>
 #include <QPaintEvent>
 #include <QPainter>
@@ -271,6 +273,27 @@ void HexViewer::paintEvent(QPaintEvent* e)
 	// redraw background
 	p.fillRect(r, palette().color(QPalette::Base));
 
+	// bytes covered by a memory watchpoint, relative to the top address
+	int shownBytes = (visibleLines + partialBottomLine) * horBytes;
+	std::vector<bool> watched;
+	if (breakpoints && debuggableName == "memory" && hexTopAddress < debuggableSize) {
+		int last = std::min(hexTopAddress + shownBytes, debuggableSize) - 1;
+		watched.assign(shownBytes, false);
+		for (const auto* bp : breakpoints->findInRange(hexTopAddress, last)) {
+			if (bp->type == Breakpoint::BREAKPOINT) continue;
+			int from = std::max<int>(bp->range->start, hexTopAddress);
+			int to = std::min<int>(bp->range->end.value_or(bp->range->start), last);
+			for (int a = from; a <= to; ++a) watched[a - hexTopAddress] = true;
+		}
+	}
+	QColor watchColor(255, 220, 160);
+
+	// access counts on a log scale, the hue tells reads from writes
+	auto kind = AccessHeatmap::Kind(heatKind);
+	bool showHeat = heatmap && heatKind && debuggableName == "memory" && heatmap->peak(kind);
+	double heatScale = showHeat ? 1.0 / std::log1p(heatmap->peak(kind)) : 0.0;
+	double heatHue = kind == AccessHeatmap::READS ? 0.6 : kind == AccessHeatmap::WRITES ? 0.0 : 0.8;
+
 	int y = frameT;
 	int address = hexTopAddress;
 	for (int i = 0; i < visibleLines+partialBottomLine; ++i) {
@@ -285,6 +308,16 @@ void HexViewer::paintEvent(QPaintEvent* e)
 			// print data
 			if (address + j < debuggableSize) {
 				hexStr = QString("%1").arg(hexData[address + j], 2, 16, QChar('0')).toUpper();
+				if (showHeat) {
+					if (uint32_t n = heatmap->count(address + j, kind)) {
+						double heat = std::log1p(n) * heatScale;
+						p.fillRect(x, y, dataWidth, lineHeight,
+						           QColor::fromHsvF(heatHue, 0.15 + 0.6 * heat, 1.0));
+					}
+				}
+				if (!watched.empty() && watched[address + j - hexTopAddress]) {
+					p.fillRect(x, y, dataWidth, lineHeight, watchColor);
+				}
 				// draw marker if needed
 				if (useMarker || beingEdited) {
 					QRect b(x, y, dataWidth, lineHeight);
@@ -378,6 +411,19 @@ void HexViewer::paintEvent(QPaintEvent* e)
 	}
 }
 
+void HexViewer::setHeatmap(const AccessHeatmap* map, int kind)
+{
+	heatmap = map;
+	heatKind = kind;
+	update();
+}
+
+void HexViewer::setBreakpoints(Breakpoints* bps)
+{
+	breakpoints = bps;
+	update();
+}
+
 void HexViewer::setDebuggable(const QString& name, int size)
 {
 	debuggableSize = size;
@@ -678,6 +724,11 @@ bool HexViewer::event(QEvent* e)
 				.arg((wd & 0x000F) >>  0, 4, 2, QChar('0'));
 			text += QString("\nDecimal: %1").arg(wd);
 		}
+		if (heatmap && debuggableName == "memory" && !heatmap->isEmpty()) {
+			text += QString("\n\nReads: %1\nWrites: %2")
+				.arg(heatmap->count(address, AccessHeatmap::READS))
+				.arg(heatmap->count(address, AccessHeatmap::WRITES));
+		}
 		QToolTip::showText(helpEvent->globalPos(), text);
 	} else {
 		QToolTip::hideText();
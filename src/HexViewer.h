@@ -6,6 +6,8 @@
 #include <vector>
 
 class HexRequest;
+class Breakpoints;
+class AccessHeatmap;
 class QScrollBar;
 class QPaintEvent;
 
@@ -21,6 +23,11 @@ public:
 	void setIsInteractive(bool enabled);
 	void setUseMarker(bool enabled);
 	void setIsEditable(bool enabled);
+	// mark the bytes covered by memory watchpoints ("memory" debuggable only)
+	void setBreakpoints(Breakpoints* bps);
+	// colour the bytes by how often they were accessed, 'kind' selects
+	// reads, writes or both, 0 turns it off ("memory" debuggable only)
+	void setHeatmap(const AccessHeatmap* map, int kind);
 
 	void setDisplayMode(Mode mode);
 	void setDisplayWidth(short width);
@@ -76,6 +83,9 @@ private:
 
 	// data
 	QString debuggableName;
+	Breakpoints* breakpoints = nullptr;
+	const AccessHeatmap* heatmap = nullptr;
+	int heatKind = 0;
 	std::vector<uint8_t> hexData;
 	std::vector<uint8_t> previousHexData;
 	int debuggableSize = 0;
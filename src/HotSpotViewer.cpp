@@ -0,0 +1,170 @@
+#include "HotSpotViewer.h"
+#include "SampleProfiler.h"
+#include "SymbolTable.h"
+#include "DebuggerData.h"
+#include "Convert.h"
+#include <QDoubleSpinBox>
+#include <QHBoxLayout>
+#include <QHash>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <cmath>
+#include <vector>
+
+enum { COL_ROUTINE = 0, COL_ADDRESS, COL_SAMPLES, COL_PERCENT, COLUMN_COUNT };
+
+HotSpotViewer::HotSpotViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	startButton = new QPushButton(tr("Start"));
+	resetButton = new QPushButton(tr("Reset"));
+
+	intervalBox = new QDoubleSpinBox();
+	intervalBox->setRange(0.01, 1000.0);
+	intervalBox->setDecimals(2);
+	intervalBox->setValue(1.0);
+	intervalBox->setSuffix(tr(" ms"));
+	intervalBox->setToolTip(tr("Emulated time between two samples"));
+
+	totalLabel = new QLabel();
+
+	table = new QTableWidget(0, COLUMN_COUNT);
+	table->setHorizontalHeaderLabels({tr("Routine"), tr("Address"), tr("Samples"), tr("%")});
+	table->horizontalHeader()->setSectionResizeMode(COL_ROUTINE, QHeaderView::Stretch);
+	table->verticalHeader()->hide();
+	table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	table->setSortingEnabled(true);
+	table->sortByColumn(COL_SAMPLES, Qt::DescendingOrder);
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(startButton);
+	hbox->addWidget(resetButton);
+	hbox->addWidget(intervalBox);
+	hbox->addWidget(totalLabel, 1);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addWidget(table);
+	setLayout(vbox);
+
+	connect(startButton, &QPushButton::clicked, this, &HotSpotViewer::startStop);
+	connect(table, &QTableWidget::itemDoubleClicked, this, &HotSpotViewer::itemActivated);
+}
+
+void HotSpotViewer::setProfiler(SampleProfiler* p)
+{
+	profiler = p;
+	connect(resetButton, &QPushButton::clicked, profiler, &SampleProfiler::reset);
+	connect(profiler, &SampleProfiler::updated, this, &HotSpotViewer::refresh);
+	connect(profiler, &SampleProfiler::runningChanged, this, &HotSpotViewer::runningChanged);
+}
+
+void HotSpotViewer::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+}
+
+void HotSpotViewer::setMemoryLayout(const MemoryLayout* ml)
+{
+	memLayout = ml;
+}
+
+void HotSpotViewer::startStop()
+{
+	if (profiler->isRunning()) {
+		profiler->stop();
+	} else {
+		profiler->start(intervalBox->value() / 1000.0);
+	}
+}
+
+void HotSpotViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+	intervalBox->setEnabled(!running);
+}
+
+void HotSpotViewer::itemActivated(QTableWidgetItem* item)
+{
+	auto* addrItem = table->item(item->row(), COL_ADDRESS);
+	emit addressSelected(addrItem->data(Qt::UserRole).toInt());
+}
+
+void HotSpotViewer::refresh()
+{
+	if (!profiler) return;
+
+	// attribute every sample to the routine it was taken in, samples that
+	// are not preceded by a label are grouped per 256 byte block
+	struct Routine {
+		QString name;
+		uint16_t address;
+		uint64_t count;
+	};
+	std::vector<Routine> routines;
+	QHash<const Symbol*, size_t> symbolRows;
+	QHash<int, size_t> blockRows;
+	for (const auto& s : profiler->samples()) {
+		const Symbol* sym = nullptr;
+		if (symTable) {
+			MemoryLayout ml;
+			if (memLayout) ml = *memLayout;
+			int page = s.address >> 14;
+			ml.primarySlot[page] = s.ps;
+			ml.secondarySlot[page] = s.ss;
+			if (s.segment >= 0) ml.mapperSegment[page] = s.segment;
+			sym = symTable->findEnclosingAddressSymbol(s.address, &ml);
+		}
+		size_t row;
+		if (sym) {
+			auto it = symbolRows.constFind(sym);
+			if (it == symbolRows.constEnd()) {
+				row = routines.size();
+				symbolRows.insert(sym, row);
+				routines.push_back({sym->text(), uint16_t(sym->value()), 0});
+			} else {
+				row = *it;
+			}
+		} else {
+			int block = s.address & 0xFF00;
+			auto it = blockRows.constFind(block);
+			if (it == blockRows.constEnd()) {
+				row = routines.size();
+				blockRows.insert(block, row);
+				routines.push_back({QString("[%1-%2]").arg(hexValue(block, 4), hexValue(block | 0xFF, 4)),
+				                    uint16_t(block), 0});
+			} else {
+				row = *it;
+			}
+		}
+		routines[row].count += s.count;
+	}
+
+	uint64_t total = profiler->total();
+	totalLabel->setText(tr("%1 samples").arg(total));
+
+	bool sorting = table->isSortingEnabled();
+	table->setSortingEnabled(false);
+	table->setRowCount(routines.size());
+	for (size_t i = 0; i < routines.size(); ++i) {
+		const auto& r = routines[i];
+		auto* name = new QTableWidgetItem(r.name);
+		auto* addr = new QTableWidgetItem(hexValue(r.address, 4));
+		addr->setData(Qt::UserRole, r.address);
+		auto* count = new QTableWidgetItem();
+		count->setData(Qt::DisplayRole, qulonglong(r.count));
+		auto* percent = new QTableWidgetItem();
+		percent->setData(Qt::DisplayRole, total ? std::round(1000.0 * r.count / total) / 10.0 : 0.0);
+		table->setItem(i, COL_ROUTINE, name);
+		table->setItem(i, COL_ADDRESS, addr);
+		table->setItem(i, COL_SAMPLES, count);
+		table->setItem(i, COL_PERCENT, percent);
+	}
+	table->setSortingEnabled(sorting);
+}
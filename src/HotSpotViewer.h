@@ -0,0 +1,52 @@
+#ifndef HOTSPOTVIEWER_H
+#define HOTSPOTVIEWER_H
+
+#include <QWidget>
+#include <cstdint>
+
+class SampleProfiler;
+class SymbolTable;
+class QDoubleSpinBox;
+class QLabel;
+class QPushButton;
+class QTableWidget;
+class QTableWidgetItem;
+struct MemoryLayout;
+
+/**
+ * Controls for the sampling profiler and the list of routines in which the
+ * most samples were taken. Samples are attributed to the closest jump
+ * label before their address.
+ */
+class HotSpotViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	HotSpotViewer(QWidget* parent = nullptr);
+
+	void setProfiler(SampleProfiler* profiler);
+	void setSymbolTable(SymbolTable* st);
+	void setMemoryLayout(const MemoryLayout* ml);
+
+	void refresh();
+
+signals:
+	void addressSelected(uint16_t addr);
+
+private:
+	void startStop();
+	void runningChanged(bool running);
+	void itemActivated(QTableWidgetItem* item);
+
+	QPushButton* startButton;
+	QPushButton* resetButton;
+	QDoubleSpinBox* intervalBox;
+	QLabel* totalLabel;
+	QTableWidget* table;
+
+	SampleProfiler* profiler = nullptr;
+	SymbolTable* symTable = nullptr;
+	const MemoryLayout* memLayout = nullptr;
+};
+
+#endif // HOTSPOTVIEWER_H
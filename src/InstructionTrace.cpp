@@ -0,0 +1,114 @@
+#include "InstructionTrace.h"
+#include <algorithm>
+#include <cstring>
+
+InstructionTrace::InstructionTrace(QObject* parent)
+	: PolledCollector("itrace", 1000, parent)
+{
+}
+
+bool InstructionTrace::openFile()
+{
+	if (mapped) return true;
+	// the file is sparse, only the part that was written takes disk space
+	if (!file.open() || !file.resize(qint64(CAPACITY) * RECORD_SIZE)) return false;
+	mapped = file.map(0, file.size());
+	return mapped != nullptr;
+}
+
+void InstructionTrace::start(int depth)
+{
+	if (isRunning() || !openFile()) return;
+	startCollecting(QString::number(depth));
+}
+
+void InstructionTrace::clear()
+{
+	first = 0;
+	count = 0;
+	lost = 0;
+	++generation;
+	emit changed();
+}
+
+void InstructionTrace::processReply(const QString& message)
+{
+	// "lost hexdata"
+	bool ok;
+	uint64_t missed = message.section(' ', 0, 0).toULongLong(&ok);
+	if (!ok) return;
+	lost += missed;
+	append(QByteArray::fromHex(message.section(' ', 1, 1).toLatin1()));
+}
+
+void InstructionTrace::appendRecords(const QString& hex)
+{
+	if (openFile()) append(QByteArray::fromHex(hex.toLatin1()));
+}
+
+void InstructionTrace::append(const QByteArray& data)
+{
+	size_t n = data.size() / RECORD_SIZE;
+	if (n == 0 || !mapped) return;
+	const char* src = data.constData();
+	// only the newest records fit when more than the capacity arrives
+	if (n > CAPACITY) {
+		src += (n - CAPACITY) * RECORD_SIZE;
+		n = CAPACITY;
+	}
+	for (size_t i = 0; i < n; ++i, src += RECORD_SIZE) {
+		size_t slot = (first + count) % CAPACITY;
+		memcpy(mapped + slot * RECORD_SIZE, src, RECORD_SIZE);
+		if (count < CAPACITY) {
+			++count;
+		} else {
+			first = (first + 1) % CAPACITY;
+		}
+	}
+	++generation;
+	emit changed();
+}
+
+const uint8_t* InstructionTrace::record(size_t i) const
+{
+	return mapped + ((first + i) % CAPACITY) * RECORD_SIZE;
+}
+
+uint16_t InstructionTrace::value(size_t i, Register reg) const
+{
+	const uint8_t* r = record(i);
+	return (r[2 * reg] << 8) | r[2 * reg + 1];
+}
+
+void InstructionTrace::buildIndex(Register reg)
+{
+	auto& index = indices[reg];
+	if (index.generation == generation) return;
+
+	// counting sort of the record numbers on the register value
+	index.offsets.assign(65537, 0);
+	for (size_t i = 0; i < count; ++i) {
+		++index.offsets[value(i, reg) + 1];
+	}
+	for (int v = 0; v < 65536; ++v) {
+		index.offsets[v + 1] += index.offsets[v];
+	}
+	index.entries.resize(count);
+	std::vector<uint32_t> fill(index.offsets.begin(), index.offsets.end() - 1);
+	for (size_t i = 0; i < count; ++i) {
+		index.entries[fill[value(i, reg)]++] = i;
+	}
+	index.generation = generation;
+}
+
+std::optional<size_t> InstructionTrace::find(Register reg, uint16_t val, size_t from, bool forward)
+{
+	buildIndex(reg);
+	const auto& index = indices[reg];
+	auto begin = index.entries.begin() + index.offsets[val];
+	auto end = index.entries.begin() + index.offsets[val + 1];
+	auto it = std::lower_bound(begin, end, uint32_t(from));
+	if (forward && it != end) return *it;
+	if (!forward && it != begin) return *(it - 1);
+	return {};
+}
@@ -0,0 +1,79 @@
+#ifndef INSTRUCTIONTRACE_H
+#define INSTRUCTIONTRACE_H
+
+#include "PolledCollector.h"
+#include <QTemporaryFile>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+/**
+ * Execution trace of the last executed instructions. A condition in openMSX
+ * stores a fixed size binary record per instruction (the 'CPU regs'
+ * debuggable, the opcode bytes and the slot/segment of the PC) in a ring
+ * buffer. The debugger streams these records into a memory mapped temporary
+ * file, so millions of them can be kept without holding them in the heap.
+ */
+class InstructionTrace : public PolledCollector
+{
+	Q_OBJECT
+public:
+	// register pairs in the order of the 'CPU regs' debuggable
+	enum Register { AF = 0, BC, DE, HL, AF2, BC2, DE2, HL2, IX, IY, PC, SP, REGISTER_COUNT };
+
+	// record layout: 12 big endian register pairs, 4 opcode bytes,
+	// the slot (bit 0-1 primary, 2-3 secondary, 7 set when not expanded)
+	// and the mapper segment of the page of the PC, 2 bytes padding
+	static constexpr int RECORD_SIZE = 32;
+	static constexpr int OPCODE_OFFSET = 24;
+	static constexpr int SLOT_OFFSET = 28;
+	static constexpr int SEGMENT_OFFSET = 29;
+	// records kept in the file, 128MB
+	static constexpr size_t CAPACITY = 4 * 1024 * 1024;
+
+	InstructionTrace(QObject* parent = nullptr);
+
+	// 'depth' is the number of records openMSX keeps between two fetches
+	void start(int depth);
+	void clear();
+	// add records that were collected outside of a running trace, as the
+	// hex string of the concatenated records
+	void appendRecords(const QString& hex);
+
+	// 0 is the oldest record
+	[[nodiscard]] size_t size() const { return count; }
+	[[nodiscard]] const uint8_t* record(size_t i) const;
+	[[nodiscard]] uint16_t value(size_t i, Register reg) const;
+	[[nodiscard]] uint64_t lostRecords() const { return lost; }
+
+	// the first record at or after 'from' (or the last one before it) in
+	// which 'reg' holds 'value'
+	[[nodiscard]] std::optional<size_t> find(Register reg, uint16_t value, size_t from, bool forward);
+
+signals:
+	void changed();
+
+private:
+	// records per register value, built when first needed
+	struct ValueIndex {
+		uint64_t generation = ~uint64_t(0);
+		std::vector<uint32_t> offsets; // 65537 entries into 'entries'
+		std::vector<uint32_t> entries; // record numbers, ascending per value
+	};
+
+	void processReply(const QString& message) override;
+	bool openFile();
+	void append(const QByteArray& data);
+	void buildIndex(Register reg);
+
+	QTemporaryFile file;
+	uchar* mapped = nullptr;
+	size_t first = 0; // slot of the oldest record
+	size_t count = 0;
+	uint64_t lost = 0;
+	uint64_t generation = 0;
+	std::array<ValueIndex, REGISTER_COUNT> indices;
+};
+
+#endif // INSTRUCTIONTRACE_H
@@ -0,0 +1,115 @@
+#include "InstructionTraceModel.h"
+#include "SymbolTable.h"
+#include "Dasm.h"
+#include "Convert.h"
+
+InstructionTraceModel::InstructionTraceModel(InstructionTrace& tr, QObject* parent)
+	: QAbstractTableModel(parent), trace(tr)
+	, dasmBuffer(0x10000 + 4)
+{
+	connect(&trace, &InstructionTrace::changed, this, &InstructionTraceModel::reload);
+}
+
+void InstructionTraceModel::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+	reload();
+}
+
+void InstructionTraceModel::reload()
+{
+	// the trace is a ring buffer, all rows move when it wraps
+	beginResetModel();
+	endResetModel();
+}
+
+int InstructionTraceModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : trace.size();
+}
+
+int InstructionTraceModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant InstructionTraceModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+
+	switch (section) {
+	case INDEX:       return tr("#");
+	case SLOT:        return tr("Slot");
+	case PC:          return tr("PC");
+	case OPCODE:      return tr("Opcode");
+	case INSTRUCTION: return tr("Instruction");
+	case AF:          return "AF";
+	case BC:          return "BC";
+	case DE:          return "DE";
+	case HL:          return "HL";
+	case IX:          return "IX";
+	case IY:          return "IY";
+	case SP:          return "SP";
+	default:          return {};
+	}
+}
+
+QString InstructionTraceModel::instructionText(size_t row, int* numBytes) const
+{
+	if (!symTable) return {};
+	const uint8_t* r = trace.record(row);
+	uint16_t pc = trace.value(row, InstructionTrace::PC);
+	std::copy(r + InstructionTrace::OPCODE_OFFSET, r + InstructionTrace::OPCODE_OFFSET + 4,
+	          dasmBuffer.begin() + pc);
+	DisasmLines lines;
+	dasm(dasmBuffer.data(), pc, pc, lines, nullptr, symTable, 0);
+	for (const auto& line : lines) {
+		if (line.rowType == DisasmRow::INSTRUCTION) {
+			if (numBytes) *numBytes = line.numBytes;
+			return QString::fromStdString(line.instr);
+		}
+	}
+	return {};
+}
+
+QVariant InstructionTraceModel::data(const QModelIndex& index, int role) const
+{
+	if (!index.isValid() || index.row() >= int(trace.size())) return {};
+
+	if (role == Qt::TextAlignmentRole && index.column() == INDEX) {
+		return int(Qt::AlignRight | Qt::AlignVCenter);
+	}
+	if (role != Qt::DisplayRole) return {};
+
+	size_t row = index.row();
+	const uint8_t* r = trace.record(row);
+	auto reg = [&](InstructionTrace::Register reg) {
+		return hexValue(trace.value(row, reg), 4);
+	};
+	switch (index.column()) {
+	case INDEX:
+		return qulonglong(row);
+	case SLOT: {
+		uint8_t slot = r[InstructionTrace::SLOT_OFFSET];
+		QString text = QString::number(slot & 3);
+		if (!(slot & 0x80)) text += QString("-%1").arg((slot >> 2) & 3);
+		return text + QString(" %1").arg(hexValue(r[InstructionTrace::SEGMENT_OFFSET], 2));
+	}
+	case PC:          return reg(InstructionTrace::PC);
+	case OPCODE: {
+		int numBytes = 4;
+		instructionText(row, &numBytes);
+		QByteArray bytes(reinterpret_cast<const char*>(r + InstructionTrace::OPCODE_OFFSET), numBytes);
+		return QString::fromLatin1(bytes.toHex(' ')).toUpper();
+	}
+	case INSTRUCTION: return instructionText(row);
+	case AF:          return reg(InstructionTrace::AF);
+	case BC:          return reg(InstructionTrace::BC);
+	case DE:          return reg(InstructionTrace::DE);
+	case HL:          return reg(InstructionTrace::HL);
+	case IX:          return reg(InstructionTrace::IX);
+	case IY:          return reg(InstructionTrace::IY);
+	case SP:          return reg(InstructionTrace::SP);
+	default:          return {};
+	}
+}
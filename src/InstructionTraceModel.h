@@ -0,0 +1,40 @@
+#ifndef INSTRUCTIONTRACEMODEL_H
+#define INSTRUCTIONTRACEMODEL_H
+
+#include "InstructionTrace.h"
+#include <QAbstractTableModel>
+#include <vector>
+
+class SymbolTable;
+
+/**
+ * Item model on an InstructionTrace. It holds no data of its own: every
+ * cell is decoded from the mapped trace file, and only disassembled when a
+ * view asks for it.
+ */
+class InstructionTraceModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Columns { INDEX = 0, SLOT, PC, OPCODE, INSTRUCTION, AF, BC, DE, HL, IX, IY, SP, COLUMN_COUNT };
+
+	InstructionTraceModel(InstructionTrace& trace, QObject* parent = nullptr);
+
+	void setSymbolTable(SymbolTable* st);
+	void reload();
+
+	int rowCount(const QModelIndex& parent = {}) const override;
+	int columnCount(const QModelIndex& parent = {}) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	QString instructionText(size_t row, int* numBytes = nullptr) const;
+
+	InstructionTrace& trace;
+	SymbolTable* symTable = nullptr;
+	// dasm() addresses its input by CPU address
+	mutable std::vector<unsigned char> dasmBuffer;
+};
+
+#endif // INSTRUCTIONTRACEMODEL_H
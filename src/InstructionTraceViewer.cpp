@@ -0,0 +1,165 @@
+#include "InstructionTraceViewer.h"
+#include "InstructionTrace.h"
+#include "InstructionTraceModel.h"
+#include "SymbolTable.h"
+#include "SymbolCompleter.h"
+#include "Convert.h"
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QTableView>
+#include <QVBoxLayout>
+
+InstructionTraceViewer::InstructionTraceViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	startButton = new QPushButton(tr("Start"));
+	clearButton = new QPushButton(tr("Clear"));
+	depthBox = new QSpinBox();
+	depthBox->setRange(1000, 1000000);
+	depthBox->setSingleStep(10000);
+	depthBox->setValue(100000);
+	depthBox->setSuffix(tr(" instructions"));
+	depthBox->setToolTip(tr("Instructions kept in openMSX between two updates"));
+	statusLabel = new QLabel();
+
+	searchRegister = new QComboBox();
+	searchRegister->addItem("PC", InstructionTrace::PC);
+	searchRegister->addItem("AF", InstructionTrace::AF);
+	searchRegister->addItem("BC", InstructionTrace::BC);
+	searchRegister->addItem("DE", InstructionTrace::DE);
+	searchRegister->addItem("HL", InstructionTrace::HL);
+	searchRegister->addItem("IX", InstructionTrace::IX);
+	searchRegister->addItem("IY", InstructionTrace::IY);
+	searchRegister->addItem("SP", InstructionTrace::SP);
+	searchRegister->setToolTip(tr("Register to search"));
+	searchEdit = new QLineEdit();
+	searchEdit->setPlaceholderText(tr("Value or label"));
+	previousButton = new QPushButton(tr("Previous"));
+	nextButton = new QPushButton(tr("Next"));
+
+	table = new QTableView();
+	table->verticalHeader()->hide();
+	// fixed row heights, so the view never measures all rows
+	table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	table->verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 2);
+	table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	table->setSelectionMode(QAbstractItemView::SingleSelection);
+	table->setWordWrap(false);
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(startButton);
+	hbox->addWidget(clearButton);
+	hbox->addWidget(depthBox);
+	hbox->addWidget(statusLabel, 1);
+
+	auto* shbox = new QHBoxLayout();
+	shbox->setMargin(0);
+	shbox->addWidget(searchRegister);
+	shbox->addWidget(searchEdit, 1);
+	shbox->addWidget(previousButton);
+	shbox->addWidget(nextButton);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addLayout(shbox);
+	vbox->addWidget(table);
+	setLayout(vbox);
+
+	connect(startButton, &QPushButton::clicked, this, &InstructionTraceViewer::startStop);
+	connect(searchEdit, &QLineEdit::returnPressed, this, [this]{ search(true); });
+	connect(nextButton, &QPushButton::clicked, this, [this]{ search(true); });
+	connect(previousButton, &QPushButton::clicked, this, [this]{ search(false); });
+	connect(table, &QTableView::doubleClicked, this, &InstructionTraceViewer::rowActivated);
+}
+
+void InstructionTraceViewer::setTrace(InstructionTrace* t)
+{
+	trace = t;
+	model = new InstructionTraceModel(*trace, this);
+	table->setModel(model);
+	table->horizontalHeader()->setSectionResizeMode(InstructionTraceModel::INSTRUCTION,
+	                                                QHeaderView::Stretch);
+
+	connect(clearButton, &QPushButton::clicked, trace, &InstructionTrace::clear);
+	connect(trace, &InstructionTrace::runningChanged, this, &InstructionTraceViewer::runningChanged);
+	connect(trace, &InstructionTrace::changed, this, &InstructionTraceViewer::traceChanged);
+}
+
+void InstructionTraceViewer::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+	if (model) model->setSymbolTable(symTable);
+
+	auto* completer = new SymbolCompleter(*symTable, false, nullptr, this);
+	searchEdit->setCompleter(completer);
+	connect(searchEdit, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
+}
+
+void InstructionTraceViewer::symbolsChanged()
+{
+	if (model) model->reload();
+}
+
+void InstructionTraceViewer::startStop()
+{
+	if (trace->isRunning()) {
+		trace->stop();
+	} else {
+		trace->start(depthBox->value());
+	}
+}
+
+void InstructionTraceViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+	depthBox->setEnabled(!running);
+}
+
+void InstructionTraceViewer::traceChanged()
+{
+	QString status = tr("%1 instructions").arg(trace->size());
+	if (trace->lostRecords()) status += tr(", %1 lost").arg(trace->lostRecords());
+	statusLabel->setText(status);
+	// the newest instruction is the one that was executed last
+	if (trace->size()) table->scrollToBottom();
+}
+
+void InstructionTraceViewer::search(bool forward)
+{
+	if (!trace || trace->size() == 0) return;
+
+	QString text = searchEdit->text().trimmed();
+	auto value = stringToValue<uint16_t>(text);
+	if (!value && symTable) {
+		if (Symbol* s = symTable->getAddressSymbol(text)) value = s->value();
+	}
+	if (!value) {
+		statusLabel->setText(tr("Unknown label or value"));
+		return;
+	}
+
+	auto reg = InstructionTrace::Register(searchRegister->currentData().toInt());
+	QModelIndex current = table->currentIndex();
+	size_t from = current.isValid() ? current.row() + (forward ? 1 : 0)
+	                                : (forward ? 0 : trace->size());
+	if (auto row = trace->find(reg, *value, from, forward)) {
+		QModelIndex index = model->index(*row, InstructionTraceModel::PC);
+		table->setCurrentIndex(index);
+		table->scrollTo(index, QAbstractItemView::PositionAtCenter);
+	} else {
+		statusLabel->setText(tr("Not found"));
+	}
+}
+
+void InstructionTraceViewer::rowActivated(const QModelIndex& index)
+{
+	if (!index.isValid()) return;
+	emit addressSelected(trace->value(index.row(), InstructionTrace::PC));
+}
@@ -0,0 +1,58 @@
+#ifndef INSTRUCTIONTRACEVIEWER_H
+#define INSTRUCTIONTRACEVIEWER_H
+
+#include <QWidget>
+#include <cstdint>
+
+class InstructionTrace;
+class InstructionTraceModel;
+class SymbolTable;
+class QComboBox;
+class QLabel;
+class QLineEdit;
+class QModelIndex;
+class QPushButton;
+class QSpinBox;
+class QTableView;
+
+/**
+ * Browser for the instruction trace, with a search on the PC (by address
+ * or label) or on the value of a register.
+ */
+class InstructionTraceViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	InstructionTraceViewer(QWidget* parent = nullptr);
+
+	void setTrace(InstructionTrace* trace);
+	void setSymbolTable(SymbolTable* st);
+
+	void symbolsChanged();
+
+signals:
+	void addressSelected(uint16_t addr);
+
+private:
+	void startStop();
+	void runningChanged(bool running);
+	void traceChanged();
+	void search(bool forward);
+	void rowActivated(const QModelIndex& index);
+
+	QPushButton* startButton;
+	QPushButton* clearButton;
+	QSpinBox* depthBox;
+	QLabel* statusLabel;
+	QComboBox* searchRegister;
+	QLineEdit* searchEdit;
+	QPushButton* previousButton;
+	QPushButton* nextButton;
+	QTableView* table;
+
+	InstructionTrace* trace = nullptr;
+	InstructionTraceModel* model = nullptr;
+	SymbolTable* symTable = nullptr;
+};
+
+#endif // INSTRUCTIONTRACEVIEWER_H
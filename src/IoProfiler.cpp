@@ -0,0 +1,55 @@
+#include "IoProfiler.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+IoProfiler::IoProfiler(QObject* parent)
+	: PolledCollector("io", 1000, parent)
+{
+}
+
+void IoProfiler::start(bool perValue)
+{
+	startCollecting(perValue ? "1" : "0");
+}
+
+void IoProfiler::clear()
+{
+	counts.clear();
+	frameCount = 0;
+	emit updated();
+}
+
+std::vector<IoProfiler::Entry> IoProfiler::entries() const
+{
+	std::vector<Entry> result;
+	result.reserve(counts.size());
+	for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+		uint32_t key = it.key();
+		result.push_back({uint8_t(key & 0xFF), bool(key >> 17),
+		                  int16_t(int((key >> 8) & 0x1FF) - 1),
+		                  it->total, it->peak});
+	}
+	return result;
+}
+
+void IoProfiler::processReply(const QString& message)
+{
+	// "frames {r:port total peak} {w:port:value total peak} ..." with the
+	// counts of the frames since the previous fetch
+	bool ok;
+	uint64_t newFrames = message.section(' ', 0, 0).toULongLong(&ok);
+	if (!ok) return;
+	frameCount += newFrames;
+
+	QRegExp record("\\{([rw]):(\\d+)(?::(\\d+))? (\\d+) (\\d+)\\}");
+	for (int pos = 0; (pos = record.indexIn(message, pos)) != -1; pos += record.matchedLength()) {
+		uint32_t port = record.cap(2).toUInt() & 0xFF;
+		uint32_t value = record.cap(3).isEmpty() ? 0 : (record.cap(3).toUInt() & 0xFF) + 1;
+		uint32_t write = record.cap(1) == "w" ? 1 : 0;
+		auto& c = counts[port | value << 8 | write << 17];
+		c.total += record.cap(4).toULongLong();
+		c.peak = std::max<uint32_t>(c.peak, record.cap(5).toUInt());
+	}
+	emit updated();
+}
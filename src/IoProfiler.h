@@ -0,0 +1,51 @@
+#ifndef IOPROFILER_H
+#define IOPROFILER_H
+
+#include "PolledCollector.h"
+#include <QHash>
+#include <cstdint>
+#include <vector>
+
+/**
+ * I/O port traffic counter: two watchpoints on the whole I/O range (with a
+ * command instead of 'debug break', so the emulation keeps running) count
+ * the reads and writes per port, and optionally per written value. openMSX
+ * folds the counts into totals and per frame peaks at the end of every
+ * frame; the debugger collects them once per second.
+ */
+class IoProfiler : public PolledCollector
+{
+	Q_OBJECT
+public:
+	struct Entry {
+		uint8_t port;
+		bool write;
+		int16_t value;   // -1 for all values
+		uint64_t total;
+		uint32_t peak;   // most accesses in a single frame
+	};
+
+	IoProfiler(QObject* parent = nullptr);
+
+	void start(bool perValue);
+	void clear();
+
+	[[nodiscard]] uint64_t frames() const { return frameCount; }
+	[[nodiscard]] std::vector<Entry> entries() const;
+
+signals:
+	void updated();
+
+private:
+	struct Count {
+		uint64_t total = 0;
+		uint32_t peak = 0;
+	};
+
+	void processReply(const QString& message) override;
+
+	QHash<uint32_t, Count> counts; // port | (value + 1) << 8 | write << 17
+	uint64_t frameCount = 0;
+};
+
+#endif // IOPROFILER_H
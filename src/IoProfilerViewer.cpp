@@ -0,0 +1,134 @@
+#include "IoProfilerViewer.h"
+#include "IoProfiler.h"
+#include "Convert.h"
+#include <QCheckBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <cmath>
+
+enum { COL_PORT = 0, COL_DEVICE, COL_ACCESS, COL_VALUE, COL_TOTAL, COL_AVERAGE, COL_PEAK, COLUMN_COUNT };
+
+// the standard I/O ports of an MSX machine
+static QString deviceName(uint8_t port)
+{
+	switch (port) {
+	case 0x7C: case 0x7D:
+		return QObject::tr("MSX-MUSIC");
+	case 0x98:
+		return QObject::tr("VDP data");
+	case 0x99:
+		return QObject::tr("VDP control");
+	case 0x9A:
+		return QObject::tr("VDP palette");
+	case 0x9B:
+		return QObject::tr("VDP indirect");
+	case 0xA0: case 0xA1: case 0xA2:
+		return QObject::tr("PSG");
+	case 0xA8:
+		return QObject::tr("Slot select");
+	case 0xA9: case 0xAA: case 0xAB:
+		return QObject::tr("PPI");
+	case 0xB4: case 0xB5:
+		return QObject::tr("RTC");
+	case 0xFC: case 0xFD: case 0xFE: case 0xFF:
+		return QObject::tr("Memory mapper");
+	default:
+		return QString();
+	}
+}
+
+IoProfilerViewer::IoProfilerViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	startButton = new QPushButton(tr("Start"));
+	clearButton = new QPushButton(tr("Clear"));
+	perValueCheck = new QCheckBox(tr("Per value"));
+	perValueCheck->setToolTip(tr("Count the written values separately"));
+	framesLabel = new QLabel();
+
+	table = new QTableWidget(0, COLUMN_COUNT);
+	table->setHorizontalHeaderLabels({tr("Port"), tr("Device"), tr("Access"), tr("Value"),
+	                                  tr("Total"), tr("Per frame"), tr("Peak")});
+	table->horizontalHeader()->setSectionResizeMode(COL_DEVICE, QHeaderView::Stretch);
+	table->verticalHeader()->hide();
+	table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	table->setSortingEnabled(true);
+	table->sortByColumn(COL_TOTAL, Qt::DescendingOrder);
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(startButton);
+	hbox->addWidget(clearButton);
+	hbox->addWidget(perValueCheck);
+	hbox->addWidget(framesLabel, 1);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addWidget(table);
+	setLayout(vbox);
+
+	connect(startButton, &QPushButton::clicked, this, &IoProfilerViewer::startStop);
+}
+
+void IoProfilerViewer::setProfiler(IoProfiler* p)
+{
+	profiler = p;
+	connect(clearButton, &QPushButton::clicked, profiler, &IoProfiler::clear);
+	connect(profiler, &IoProfiler::updated, this, &IoProfilerViewer::refresh);
+	connect(profiler, &IoProfiler::runningChanged, this, &IoProfilerViewer::runningChanged);
+}
+
+void IoProfilerViewer::startStop()
+{
+	if (profiler->isRunning()) {
+		profiler->stop();
+	} else {
+		profiler->start(perValueCheck->isChecked());
+	}
+}
+
+void IoProfilerViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+	perValueCheck->setEnabled(!running);
+}
+
+void IoProfilerViewer::refresh()
+{
+	if (!profiler) return;
+
+	uint64_t frames = profiler->frames();
+	framesLabel->setText(tr("%1 frames").arg(frames));
+
+	auto entries = profiler->entries();
+	bool sorting = table->isSortingEnabled();
+	table->setSortingEnabled(false);
+	table->setRowCount(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i) {
+		const auto& e = entries[i];
+		auto* port = new QTableWidgetItem(hexValue(e.port, 2));
+		auto* device = new QTableWidgetItem(deviceName(e.port));
+		auto* access = new QTableWidgetItem(e.write ? tr("write") : tr("read"));
+		auto* value = new QTableWidgetItem(e.value < 0 ? QString() : hexValue(e.value, 2));
+		auto* total = new QTableWidgetItem();
+		total->setData(Qt::DisplayRole, qulonglong(e.total));
+		auto* average = new QTableWidgetItem();
+		average->setData(Qt::DisplayRole, frames ? std::round(10.0 * e.total / frames) / 10.0 : 0.0);
+		auto* peak = new QTableWidgetItem();
+		peak->setData(Qt::DisplayRole, e.peak);
+		table->setItem(i, COL_PORT, port);
+		table->setItem(i, COL_DEVICE, device);
+		table->setItem(i, COL_ACCESS, access);
+		table->setItem(i, COL_VALUE, value);
+		table->setItem(i, COL_TOTAL, total);
+		table->setItem(i, COL_AVERAGE, average);
+		table->setItem(i, COL_PEAK, peak);
+	}
+	table->setSortingEnabled(sorting);
+}
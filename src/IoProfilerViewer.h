@@ -0,0 +1,40 @@
+#ifndef IOPROFILERVIEWER_H
+#define IOPROFILERVIEWER_H
+
+#include <QWidget>
+
+class IoProfiler;
+class QCheckBox;
+class QLabel;
+class QPushButton;
+class QTableWidget;
+
+/**
+ * Controls for the I/O port profiler and a table with the traffic per port,
+ * as a total and per frame, so that ports that are written far more often
+ * than needed (VRAM uploads, mapper switches) stand out.
+ */
+class IoProfilerViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	IoProfilerViewer(QWidget* parent = nullptr);
+
+	void setProfiler(IoProfiler* profiler);
+
+	void refresh();
+
+private:
+	void startStop();
+	void runningChanged(bool running);
+
+	QPushButton* startButton;
+	QPushButton* clearButton;
+	QCheckBox* perValueCheck;
+	QLabel* framesLabel;
+	QTableWidget* table;
+
+	IoProfiler* profiler = nullptr;
+};
+
+#endif // IOPROFILERVIEWER_H
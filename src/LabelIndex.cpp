@@ -0,0 +1,122 @@
+#include "LabelIndex.h"
+#include "SymbolTable.h"
+#include <algorithm>
+
+static constexpr size_t MAX_FUZZY_CANDIDATES = 256;
+
+// Set of characters present in a (case folded) string, used to quickly
+// reject labels that cannot contain a search string as a subsequence.
+static uint64_t charMask(const QString& str)
+{
+	uint64_t mask = 0;
+	for (QChar c : str) {
+		ushort u = c.unicode();
+		int bit;
+		if (u >= 'a' && u <= 'z') {
+			bit = u - 'a';
+		} else if (u >= '0' && u <= '9') {
+			bit = 26 + (u - '0');
+		} else if (u == '_') {
+			bit = 36;
+		} else if (u == '.') {
+			bit = 37;
+		} else {
+			bit = 38 + (u % 26);
+		}
+		mask |= uint64_t(1) << bit;
+	}
+	return mask;
+}
+
+// Match 'pattern' as a subsequence of 'str' (both case folded). Returns the
+// number of skipped characters before and between the matched characters,
+// or -1 if there is no match. Lower is better.
+static int subsequenceScore(const QString& pattern, const QString& str)
+{
+	int score = 0;
+	int pos = 0;
+	for (QChar c : pattern) {
+		int found = str.indexOf(c, pos);
+		if (found < 0) return -1;
+		score += found - pos;
+		pos = found + 1;
+	}
+	return score;
+}
+
+void LabelIndex::clear()
+{
+	entries.clear();
+}
+
+void LabelIndex::build(std::vector<Symbol*> labels)
+{
+	entries.clear();
+	entries.reserve(labels.size());
+	for (auto* sym : labels) {
+		QString folded = sym->text().toCaseFolded();
+		uint64_t chars = charMask(folded);
+		entries.push_back({sym, std::move(folded), chars});
+	}
+	std::stable_sort(entries.begin(), entries.end(),
+	                 [](const Entry& a, const Entry& b) { return a.folded < b.folded; });
+}
+
+size_t LabelIndex::lowerBound(const QString& folded) const
+{
+	auto it = std::lower_bound(entries.begin(), entries.end(), folded,
+	                           [](const Entry& e, const QString& s) { return e.folded < s; });
+	return std::distance(entries.begin(), it);
+}
+
+Symbol* LabelIndex::find(const QString& label, bool caseSensitive) const
+{
+	QString folded = label.toCaseFolded();
+	Symbol* caseless = nullptr;
+	for (size_t i = lowerBound(folded); i < entries.size() && entries[i].folded == folded; ++i) {
+		if (entries[i].symbol->text() == label) return entries[i].symbol;
+		if (!caseless) caseless = entries[i].symbol;
+	}
+	return caseSensitive ? nullptr : caseless;
+}
+
+QStringList LabelIndex::complete(const QString& text, int maxResults, const Filter& filter) const
+{
+	QStringList result;
+	auto add = [&](const Symbol* sym) {
+		// labels with the same name (in different slots) are listed once
+		if (result.empty() || result.back() != sym->text()) {
+			result.append(sym->text());
+		}
+	};
+
+	// names starting with the text form one block in the sorted list
+	QString folded = text.toCaseFolded();
+	for (size_t i = lowerBound(folded);
+	     i < entries.size() && entries[i].folded.startsWith(folded); ++i) {
+		if (result.size() >= maxResults) return result;
+		if (!filter || filter(entries[i].symbol)) add(entries[i].symbol);
+	}
+	// a single character is a subsequence of too many names to be useful
+	if (folded.size() < 2 || result.size() >= maxResults) return result;
+
+	// fuzzy matches for the remaining places, the scan stops once it has
+	// plenty of candidates to pick the best ones from
+	uint64_t chars = charMask(folded);
+	std::vector<std::pair<int, size_t>> fuzzy;
+	for (size_t i = 0; i < entries.size() && fuzzy.size() < MAX_FUZZY_CANDIDATES; ++i) {
+		const auto& e = entries[i];
+		if ((chars & ~e.chars) != 0) continue;
+		if (e.folded.startsWith(folded)) continue; // already listed
+		int score = subsequenceScore(folded, e.folded);
+		if (score < 0) continue;
+		if (filter && !filter(e.symbol)) continue;
+		fuzzy.emplace_back(score, i);
+	}
+	size_t remaining = std::min(fuzzy.size(), size_t(std::max(0, maxResults - result.size())));
+	std::partial_sort(fuzzy.begin(), fuzzy.begin() + remaining, fuzzy.end());
+	for (size_t i = 0; i < remaining; ++i) {
+		add(entries[fuzzy[i].second].symbol);
+	}
+	return result;
+}
@@ -0,0 +1,51 @@
+#ifndef LABELINDEX_H
+#define LABELINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class Symbol;
+
+/**
+ * Search index over the names of address labels.
+ *
+ * Labels are kept sorted on their case folded name, so exact and prefix
+ * lookups are binary searches. Fuzzy (subsequence) matching only runs when
+ * the prefix matches don't fill the list, and stops after a fixed number of
+ * candidates; a per label character mask rejects most labels without
+ * looking at the name itself.
+ */
+class LabelIndex
+{
+public:
+	using Filter = std::function<bool(const Symbol*)>;
+
+	void clear();
+	void build(std::vector<Symbol*> labels);
+
+	// Find the label with this name, an exact match is preferred over a
+	// match that only differs in case.
+	[[nodiscard]] Symbol* find(const QString& label, bool caseSensitive = false) const;
+
+	// List at most 'maxResults' label names matching 'text': all names
+	// starting with 'text' first (sorted), followed by names that contain
+	// the characters of 'text' in order, best match first. The fuzzy part
+	// needs at least two characters of 'text'.
+	[[nodiscard]] QStringList complete(const QString& text, int maxResults,
+	                                   const Filter& filter = {}) const;
+
+private:
+	[[nodiscard]] size_t lowerBound(const QString& folded) const;
+
+	struct Entry {
+		Symbol* symbol;
+		QString folded;
+		uint64_t chars;
+	};
+	std::vector<Entry> entries;
+};
+
+#endif // LABELINDEX_H
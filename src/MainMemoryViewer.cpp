@@ -3,11 +3,14 @@
 #include "CPURegs.h"
 #include "CPURegsViewer.h"
 #include "SymbolTable.h"
+#include "SymbolCompleter.h"
+#include "AccessHeatmap.h"
 #include "Convert.h"
 #include <QComboBox>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QLineEdit>
+#include <QPushButton>
 #include <iostream>
 
 static const int linkRegisters[] = {
@@ -39,14 +42,40 @@ MainMemoryViewer::MainMemoryViewer(QWidget* parent)
 	hexView->setIsEditable(true);
 	hexView->setIsInteractive(true);
 	hexView->setDisplayMode(HexViewer::FILL_WIDTH_POWEROF2);
+	// access heatmap recording
+	heatKindList = new QComboBox();
+	heatKindList->addItem(tr("No heatmap"), 0);
+	heatKindList->addItem(tr("Reads"), AccessHeatmap::READS);
+	heatKindList->addItem(tr("Writes"), AccessHeatmap::WRITES);
+	heatKindList->addItem(tr("Reads + writes"), AccessHeatmap::ACCESSES);
+	heatBlockList = new QComboBox();
+	heatBlockList->addItem(tr("Per 256 bytes"), 256);
+	heatBlockList->addItem(tr("Per byte"), 1);
+	heatFirst = new QLineEdit(hexValue(0x0000, 4));
+	heatLast = new QLineEdit(hexValue(0xFFFF, 4));
+	heatFirst->setToolTip(tr("First address to record"));
+	heatLast->setToolTip(tr("Last address to record"));
+	recordButton = new QPushButton(tr("Record"));
+	recordButton->setToolTip(tr("Count memory accesses until stopped"));
+	recordButton->setEnabled(false);
+
 	auto* hbox = new QHBoxLayout();
 	hbox->setMargin(0);
 	hbox->addWidget(addressSourceList);
 	hbox->addWidget(addressValue);
 
+	auto* heatBox = new QHBoxLayout();
+	heatBox->setMargin(0);
+	heatBox->addWidget(heatKindList);
+	heatBox->addWidget(heatBlockList);
+	heatBox->addWidget(heatFirst);
+	heatBox->addWidget(heatLast);
+	heatBox->addWidget(recordButton);
+
 	auto* vbox = new QVBoxLayout();
 	vbox->setMargin(0);
 	vbox->addLayout(hbox);
+	vbox->addLayout(heatBox);
 	vbox->addWidget(hexView);
 	setLayout(vbox);
 
@@ -54,6 +83,7 @@ MainMemoryViewer::MainMemoryViewer(QWidget* parent)
 	linkedId = 0;
 	regsViewer = nullptr;
 	symTable = nullptr;
+	heatmap = nullptr;
 
 	connect(hexView, &HexViewer::locationChanged,
 	        this, &MainMemoryViewer::hexViewChanged);
@@ -61,6 +91,9 @@ MainMemoryViewer::MainMemoryViewer(QWidget* parent)
 	        this, &MainMemoryViewer::addressValueChanged);
 	connect(addressSourceList, qOverload<int>(&QComboBox::currentIndexChanged),
 	        this, &MainMemoryViewer::addressSourceListChanged);
+	connect(heatKindList, qOverload<int>(&QComboBox::currentIndexChanged),
+	        this, &MainMemoryViewer::heatKindChanged);
+	connect(recordButton, &QPushButton::clicked, this, &MainMemoryViewer::recordAccesses);
 }
 
 void MainMemoryViewer::settingsChanged()
@@ -87,6 +120,55 @@ void MainMemoryViewer::setRegsView(CPURegsViewer* viewer)
 void MainMemoryViewer::setSymbolTable(SymbolTable* symtable)
 {
 	symTable = symtable;
+
+	// complete labels in the address field
+	auto* completer = new SymbolCompleter(*symTable, true, nullptr, this);
+	addressValue->setCompleter(completer);
+	connect(addressValue, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
+	connect(completer, qOverload<const QString&>(&QCompleter::activated),
+	        this, &MainMemoryViewer::addressValueChanged);
+}
+
+void MainMemoryViewer::setBreakpoints(Breakpoints* bps)
+{
+	hexView->setBreakpoints(bps);
+}
+
+void MainMemoryViewer::setHeatmap(AccessHeatmap* map)
+{
+	heatmap = map;
+	recordButton->setEnabled(true);
+	connect(heatmap, &AccessHeatmap::updated, hexView, [this]{ hexView->update(); });
+	connect(heatmap, &AccessHeatmap::runningChanged, this, &MainMemoryViewer::recordingChanged);
+}
+
+void MainMemoryViewer::heatKindChanged(int index)
+{
+	hexView->setHeatmap(heatmap, heatKindList->itemData(index).toInt());
+}
+
+void MainMemoryViewer::recordAccesses()
+{
+	if (heatmap->isRunning()) {
+		heatmap->stop();
+		return;
+	}
+	auto first = stringToValue<uint16_t>(heatFirst->text());
+	auto last = stringToValue<uint16_t>(heatLast->text());
+	if (!first || !last || *last < *first) return;
+	heatmap->start(*first, *last, heatBlockList->currentData().toInt());
+	// show what is being recorded
+	if (heatKindList->currentIndex() == 0) {
+		heatKindList->setCurrentIndex(heatKindList->count() - 1);
+	}
+}
+
+void MainMemoryViewer::recordingChanged(bool running)
+{
+	recordButton->setText(running ? tr("Stop") : tr("Record"));
+	heatBlockList->setEnabled(!running);
+	heatFirst->setEnabled(!running);
+	heatLast->setEnabled(!running);
 }
 
 void MainMemoryViewer::refresh()
@@ -104,9 +186,9 @@ void MainMemoryViewer::addressValueChanged()
 	auto addr = stringToValue<uint16_t>(addressValue->text());
 	if (!addr && symTable) {
 		// try finding a label
-		Symbol *s = symTable->getAddressSymbol(addressValue->text());
-		if (!s) s = symTable->getAddressSymbol(addressValue->text(), Qt::CaseInsensitive);
-		if (s) addr = s->value();
+		if (Symbol* s = symTable->getAddressSymbol(addressValue->text())) {
+			addr = s->value();
+		}
 	}
 
 	if (addr) hexView->setLocation(*addr);
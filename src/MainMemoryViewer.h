@@ -6,6 +6,9 @@
 class HexViewer;
 class CPURegsViewer;
 class SymbolTable;
+class Breakpoints;
+class AccessHeatmap;
+class QPushButton;
 class QComboBox;
 class QLineEdit;
 
@@ -18,6 +21,8 @@ public:
 	void setDebuggable(const QString& name, int size);
 	void setRegsView(CPURegsViewer* viewer);
 	void setSymbolTable(SymbolTable* symtable);
+	void setBreakpoints(Breakpoints* bps);
+	void setHeatmap(AccessHeatmap* map);
 
 	void setLocation(int addr);
 	void settingsChanged();
@@ -27,14 +32,23 @@ public:
 	void hexViewChanged(int addr);
 	void addressValueChanged();
 	void addressSourceListChanged(int index);
+	void heatKindChanged(int index);
+	void recordAccesses();
+	void recordingChanged(bool running);
 
 private:
 	HexViewer* hexView;
 	QComboBox* addressSourceList;
 	QLineEdit* addressValue;
+	QComboBox* heatKindList;
+	QComboBox* heatBlockList;
+	QLineEdit* heatFirst;
+	QLineEdit* heatLast;
+	QPushButton* recordButton;
 
 	CPURegsViewer* regsViewer;
 	SymbolTable* symTable;
+	AccessHeatmap* heatmap;
 	int linkedId;
 	bool isLinked;
 };
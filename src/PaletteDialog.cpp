@@ -4,6 +4,7 @@
 #include <QPainter>
 #include "PaletteDialog.h"
 #include "Convert.h"
+#include "PaletteLut.h"
 #include "VDPDataStore.h"
 #include "ranges.h"
 
@@ -21,11 +22,7 @@ PalettePatch::PalettePatch(QWidget* parent, int palNr)
 
 void PalettePatch::updatePaletteChanged(const uint8_t* pal)
 {
-    int r = (pal[2 * msxPalNr + 0] & 0xf0) >> 4;
-    int b = (pal[2 * msxPalNr + 0] & 0x0f);
-    int g = (pal[2 * msxPalNr + 1] & 0x0f);
-    auto scale = [](int x) { return (x >> 1) | (x << 2) | (x << 5); };
-    myColor = qRgb(scale(r), scale(g), scale(b));
+    myColor = PaletteLut::decode(pal, msxPalNr);
     setSizePolicy(QSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding));
     update();
     //printf("PalettePatch::updatePaletteChanged %i\n", msxPalNr);
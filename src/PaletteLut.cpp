@@ -0,0 +1,65 @@
+#include "PaletteLut.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+PaletteLut& PaletteLut::instance()
+{
+	static PaletteLut oneInstance;
+	return oneInstance;
+}
+
+QRgb PaletteLut::decode(const uint8_t* source, int entry)
+{
+	int r = (source[2 * entry + 0] & 0xf0) >> 4;
+	int b = (source[2 * entry + 0] & 0x0f);
+	int g = (source[2 * entry + 1] & 0x0f);
+	auto scale = [](int x) { return (x >> 1) | (x << 2) | (x << 5); };
+	return qRgb(scale(r), scale(g), scale(b));
+}
+
+const PaletteLut::Colors& PaletteLut::colors(const uint8_t* source)
+{
+	if (!source) {
+		if (gray.version == 0) {
+			std::fill_n(gray.rgb, 16, qRgb(80, 80, 80));
+			gray.version = ++lastVersion;
+		}
+		return gray;
+	}
+
+	auto it = std::find_if(entries.begin(), entries.end(),
+	                       [&](const Entry& e) { return e.source == source; });
+	if (it == entries.end()) {
+		entries.push_back(Entry{source, {}, {}});
+		it = std::prev(entries.end());
+	} else if (memcmp(it->bytes, source, sizeof(it->bytes)) == 0) {
+		return it->colors;
+	}
+	memcpy(it->bytes, source, sizeof(it->bytes));
+	for (int i = 0; i < 16; ++i) {
+		it->colors.rgb[i] = decode(source, i);
+	}
+	it->colors.version = ++lastVersion;
+	return it->colors;
+}
+
+const std::array<QRgb, 256>& PaletteLut::screen8()
+{
+	// 3 bits green, 3 bits red, 2 bits blue
+	static const auto colors = [] {
+		std::array<QRgb, 256> result;
+		for (int val = 0; val < 256; ++val) {
+			int b = val & 0x03;
+			int r = val & 0x1C;
+			int g = val & 0xE0;
+
+			b = b | (b << 2) | (b << 4) | (b << 6);
+			r = (r >> 2) | r | (r << 3);
+			g = g | (g >> 3) | (g >> 6);
+			result[val] = qRgb(r, g, b);
+		}
+		return result;
+	}();
+	return colors;
+}
@@ -0,0 +1,56 @@
+#ifndef PALETTELUT_H
+#define PALETTELUT_H
+
+#include <QRgb>
+#include <array>
+#include <cstdint>
+#include <deque>
+
+/**
+ * Turns V9938 palette data into the QRgb colors all VDP views draw with.
+ * A palette source is the 32 bytes of palette data in the VDPDataStore,
+ * the default palette or a viewer's own edited copy. Each source is only
+ * decoded again when its bytes changed, and then gets a new version
+ * number, so a view can skip its own work when the version it decoded
+ * with is still current. Only used from the GUI thread.
+ */
+class PaletteLut
+{
+public:
+	struct Colors {
+		QRgb rgb[16];
+		uint32_t version = 0; // 0 is never a valid version
+	};
+
+	static PaletteLut& instance();
+
+	// the colors of the 16 palette entries at 'source', gray without source
+	const Colors& colors(const uint8_t* source);
+
+	// color 'c' as shown on screen: color 0 is transparent and shows the
+	// border color, unless the TP bit (VDP register 8, bit 5) is set
+	static QRgb shown(const QRgb rgb[16], int c, int borderColor, bool tp = false)
+	{
+		return rgb[c ? c : (tp ? 0 : borderColor)];
+	}
+
+	// the fixed colors of the 256 byte values in screen 8
+	static const std::array<QRgb, 256>& screen8();
+
+	// a single palette entry, scaled from 3 to 8 bits per channel
+	static QRgb decode(const uint8_t* source, int entry);
+
+private:
+	PaletteLut() = default;
+
+	struct Entry {
+		const uint8_t* source;
+		uint8_t bytes[32];
+		Colors colors;
+	};
+	std::deque<Entry> entries; // keeps the returned references valid
+	Colors gray;
+	uint32_t lastVersion = 0;
+};
+
+#endif // PALETTELUT_H
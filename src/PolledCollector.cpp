@@ -0,0 +1,65 @@
+#include "PolledCollector.h"
+#include "OpenMSXConnection.h"
+#include "CommClient.h"
+
+PolledCollector::PolledCollector(const QString& name, int interval, QObject* parent)
+	: QObject(parent), procs("debug_" + name)
+{
+	fetchTimer.setInterval(interval);
+	connect(&fetchTimer, &QTimer::timeout, this, &PolledCollector::fetch);
+}
+
+void PolledCollector::startCollecting(const QString& args)
+{
+	if (running) return;
+	CommClient::instance().sendCommand(new SimpleCommand(
+		args.isEmpty() ? procs + "_start" : QString("%1_start %2").arg(procs, args)));
+	running = true;
+	if (fetchTimer.interval() > 0) fetchTimer.start();
+	emit runningChanged(true);
+}
+
+void PolledCollector::stop()
+{
+	stopCollecting(true);
+}
+
+void PolledCollector::stopCollecting(bool fetchRest)
+{
+	if (!running) return;
+	CommClient::instance().sendCommand(new SimpleCommand(procs + "_stop"));
+	running = false;
+	fetchTimer.stop();
+	// what was collected since the last fetch, even when that one is
+	// still on its way
+	if (fetchRest) sendFetch();
+	emit runningChanged(false);
+}
+
+void PolledCollector::connectionClosed()
+{
+	fetching = false;
+	if (!running) return;
+	running = false;
+	fetchTimer.stop();
+	emit runningChanged(false);
+}
+
+void PolledCollector::fetch()
+{
+	// a slow reply must not pile up requests
+	if (fetching) return;
+	sendFetch();
+}
+
+void PolledCollector::sendFetch()
+{
+	fetching = true;
+	auto* command = new Command(procs + "_fetch",
+		[this](const QString& message) {
+			fetching = false;
+			processReply(message);
+		},
+		[this](const QString& /*error*/) { fetching = false; });
+	CommClient::instance().sendCommand(command);
+}
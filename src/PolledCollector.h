@@ -0,0 +1,50 @@
+#ifndef POLLEDCOLLECTOR_H
+#define POLLEDCOLLECTOR_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+/**
+ * Base of the collectors that gather data in openMSX while the emulation
+ * keeps running, through a set of 'debug_<name>_*' procs in debugger.tcl.
+ * Starting and stopping calls 'debug_<name>_start' and 'debug_<name>_stop';
+ * while running a timer calls 'debug_<name>_fetch', with at most one fetch
+ * on its way, and hands each reply to processReply().
+ */
+class PolledCollector : public QObject
+{
+	Q_OBJECT
+public:
+	[[nodiscard]] bool isRunning() const { return running; }
+
+	// stops the collection in openMSX and fetches what is left
+	virtual void stop();
+	void fetch();
+	void connectionClosed();
+
+signals:
+	void runningChanged(bool running);
+
+protected:
+	// 'name' as in the names of the procs, 'interval' in ms, 0 for no
+	// periodic fetch
+	PolledCollector(const QString& name, int interval, QObject* parent);
+
+	// 'args' are passed to the start proc
+	void startCollecting(const QString& args = {});
+	void stopCollecting(bool fetchRest);
+
+	// the replies to the fetches, in the order they were sent
+	virtual void processReply(const QString& message) = 0;
+
+private:
+	void sendFetch();
+
+	QString procs;
+	QTimer fetchTimer;
+	bool running = false;
+	bool fetching = false;
+};
+
+#endif // POLLEDCOLLECTOR_H
@@ -0,0 +1,92 @@
+#include "SampleProfiler.h"
+#include "DebuggerData.h"
+#include <algorithm>
+
+// address, slot and segment packed in one hash key
+static uint32_t sampleKey(uint16_t address, int ps, int ss, int segment)
+{
+	return address | (ps << 16) | ((ss + 1) << 18) | (uint32_t(segment + 1) << 21);
+}
+
+SampleProfiler::SampleProfiler(QObject* parent)
+	: PolledCollector("profile", 1000, parent)
+{
+}
+
+void SampleProfiler::setMemoryLayout(const MemoryLayout* ml)
+{
+	memLayout = ml;
+}
+
+void SampleProfiler::start(double interval)
+{
+	startCollecting(QString::number(interval, 'g', 6));
+}
+
+void SampleProfiler::reset()
+{
+	counts.clear();
+	peakCount = 0;
+	totalCount = 0;
+	emit updated();
+}
+
+int SampleProfiler::normalizedSegment(int ps, int ss, int segment) const
+{
+	// openMSX reports the mapper register of the page, which is only
+	// meaningful when the slot actually contains a memory mapper
+	if (!memLayout || memLayout->mapperSize[ps][std::max(ss, 0)] == 0) return -1;
+	return segment;
+}
+
+void SampleProfiler::processReply(const QString& message)
+{
+	// reply is a Tcl list of "pc:ps:ss:segment count" pairs
+	auto words = message.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+	if (words.size() < 2) return;
+	for (int i = 0; i + 1 < words.size(); i += 2) {
+		auto fields = words[i].split(':');
+		if (fields.size() != 4) continue;
+		bool ok1, ok2, ok4;
+		bool ok3 = true;
+		int address = fields[0].toInt(&ok1);
+		int ps = fields[1].toInt(&ok2);
+		int ss = fields[2] == "X" ? -1 : fields[2].toInt(&ok3);
+		int segment = fields[3].toInt(&ok4);
+		uint32_t n = words[i + 1].toUInt();
+		if (!(ok1 && ok2 && ok3 && ok4) || address < 0 || address > 0xFFFF ||
+		    ps < 0 || ps > 3 || ss > 3 || segment < 0 || segment > 0xFF) {
+			continue;
+		}
+		auto& c = counts[sampleKey(address, ps, ss, normalizedSegment(ps, ss, segment))];
+		c += n;
+		peakCount = std::max(peakCount, c);
+		totalCount += n;
+	}
+	emit updated();
+}
+
+uint32_t SampleProfiler::count(uint16_t address, const MemoryLayout* ml) const
+{
+	if (counts.isEmpty() || !ml) return 0;
+	int page = address >> 14;
+	int ps = ml->primarySlot[page] & 3;
+	int ss = ml->secondarySlot[page];
+	int segment = normalizedSegment(ps, ss, ml->mapperSegment[page]);
+	return counts.value(sampleKey(address, ps, ss, segment));
+}
+
+std::vector<SampleProfiler::Sample> SampleProfiler::samples() const
+{
+	std::vector<Sample> result;
+	result.reserve(counts.size());
+	for (auto it = counts.begin(); it != counts.end(); ++it) {
+		uint32_t key = it.key();
+		result.push_back({uint16_t(key & 0xFFFF),
+		                  int8_t((key >> 16) & 3),
+		                  int8_t(((key >> 18) & 7) - 1),
+		                  int16_t(int(key >> 21) - 1),
+		                  it.value()});
+	}
+	return result;
+}
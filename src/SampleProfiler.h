@@ -0,0 +1,58 @@
+#ifndef SAMPLEPROFILER_H
+#define SAMPLEPROFILER_H
+
+#include "PolledCollector.h"
+#include <QHash>
+#include <cstdint>
+#include <vector>
+
+struct MemoryLayout;
+
+/**
+ * Statistical profiler: a Tcl 'after time' loop in openMSX samples the
+ * program counter (and the slot/segment it runs from) at a fixed emulated
+ * time interval and counts the hits per address. The debugger only collects
+ * the counts gathered so far once per second, so the emulation keeps running
+ * at full speed and the connection isn't flooded with single samples.
+ */
+class SampleProfiler : public PolledCollector
+{
+	Q_OBJECT
+public:
+	struct Sample {
+		uint16_t address;
+		int8_t ps;
+		int8_t ss;      // -1 when the slot is not expanded
+		int16_t segment; // -1 when the slot has no memory mapper
+		uint32_t count;
+	};
+
+	SampleProfiler(QObject* parent = nullptr);
+
+	void setMemoryLayout(const MemoryLayout* ml);
+
+	// interval is in seconds of emulated time
+	void start(double interval);
+	void reset();
+
+	// number of samples taken at 'address' in the slot and segment that
+	// the memory layout shows for that address
+	[[nodiscard]] uint32_t count(uint16_t address, const MemoryLayout* ml) const;
+	[[nodiscard]] uint32_t peak() const { return peakCount; }
+	[[nodiscard]] uint64_t total() const { return totalCount; }
+	[[nodiscard]] std::vector<Sample> samples() const;
+
+signals:
+	void updated();
+
+private:
+	void processReply(const QString& message) override;
+	[[nodiscard]] int normalizedSegment(int ps, int ss, int segment) const;
+
+	const MemoryLayout* memLayout = nullptr;
+	QHash<uint32_t, uint32_t> counts;
+	uint32_t peakCount = 0;
+	uint64_t totalCount = 0;
+};
+
+#endif // SAMPLEPROFILER_H
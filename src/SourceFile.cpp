@@ -0,0 +1,52 @@
+#include "SourceFile.h"
+#include <cstring>
+
+SourceFile::SourceFile(const QString& fileName)
+	: name(fileName), file(fileName)
+{
+	if (!file.open(QIODevice::ReadOnly)) return;
+	size = file.size();
+	if (size == 0 || size > UINT32_MAX) return;
+	auto* map = file.map(0, size);
+	if (!map) return;
+	data = reinterpret_cast<const char*>(map);
+
+	// locate all line starts in one pass
+	lineStart.reserve(size / 32);
+	lineStart.push_back(0);
+	const char* p = data;
+	const char* end = data + size;
+	while (auto* nl = static_cast<const char*>(memchr(p, '\n', end - p))) {
+		p = nl + 1;
+		if (p == end) break;
+		lineStart.push_back(p - data);
+	}
+}
+
+SourceFile::~SourceFile()
+{
+	if (data) {
+		file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+	}
+}
+
+QString SourceFile::line(int index) const
+{
+	if (index < 0 || index >= lineCount()) return {};
+	size_t begin = lineStart[index];
+	size_t end = (index + 1 < lineCount()) ? lineStart[index + 1] : size;
+	while (end > begin && (data[end - 1] == '\n' || data[end - 1] == '\r')) --end;
+
+	QString text = QString::fromLocal8Bit(data + begin, end - begin);
+	if (!text.contains('\t')) return text;
+
+	QString expanded;
+	for (QChar c : text) {
+		if (c == '\t') {
+			expanded += QString(8 - expanded.size() % 8, ' ');
+		} else {
+			expanded += c;
+		}
+	}
+	return expanded;
+}
@@ -0,0 +1,38 @@
+#ifndef SOURCEFILE_H
+#define SOURCEFILE_H
+
+#include <QFile>
+#include <QString>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Read-only view on a (possibly very large) source file.
+ *
+ * The file is memory mapped and the start offset of every line is computed
+ * once when the file is opened, after that fetching any line is a table
+ * lookup. Only the lines that are actually displayed get decoded.
+ */
+class SourceFile
+{
+public:
+	explicit SourceFile(const QString& fileName);
+	~SourceFile();
+	SourceFile(const SourceFile&) = delete;
+	SourceFile& operator=(const SourceFile&) = delete;
+
+	[[nodiscard]] bool isOpen() const { return data != nullptr; }
+	[[nodiscard]] const QString& fileName() const { return name; }
+	[[nodiscard]] int lineCount() const { return lineStart.size(); }
+	// line text without line ending, tabs are expanded
+	[[nodiscard]] QString line(int index) const;
+
+private:
+	QString name;
+	QFile file;
+	const char* data = nullptr;
+	size_t size = 0;
+	std::vector<uint32_t> lineStart;
+};
+
+#endif // SOURCEFILE_H
@@ -0,0 +1,114 @@
+#include "SourceIndex.h"
+#include "DebuggerData.h"
+#include <algorithm>
+
+// The longest Z80 instruction, an address further away from the last
+// indexed location is not considered part of that location.
+static constexpr int MAX_INSTRUCTION_LENGTH = 4;
+
+void SourceIndex::clear()
+{
+	files.clear();
+	segments.clear();
+	sorted = true;
+}
+
+void SourceIndex::add(const QString* origin, const QString& file, int line,
+                      int segment, uint16_t address)
+{
+	// search from the back, locations mostly come from the last used files
+	size_t id = files.size();
+	for (size_t i = files.size(); i-- > 0;) {
+		if (files[i].origin == origin && files[i].name == file) {
+			id = i;
+			break;
+		}
+	}
+	if (id == files.size()) {
+		if (files.size() > 0xFFFF) return;
+		files.push_back({file, origin});
+	}
+
+	auto& entries = segments[segment];
+	if (!entries.empty() && entries.back().address > address) sorted = false;
+	entries.push_back({address, uint16_t(id), uint32_t(line)});
+}
+
+void SourceIndex::remove(const QString* origin)
+{
+	// renumber the files that remain
+	std::vector<int> newId(files.size(), -1);
+	std::vector<File> kept;
+	for (size_t i = 0; i < files.size(); ++i) {
+		if (files[i].origin == origin) continue;
+		newId[i] = kept.size();
+		kept.push_back(std::move(files[i]));
+	}
+	if (kept.size() == files.size()) return;
+	files = std::move(kept);
+
+	for (auto it = segments.begin(); it != segments.end();) {
+		auto& entries = it->second;
+		entries.erase(std::remove_if(entries.begin(), entries.end(),
+		                             [&](const Entry& e) { return newId[e.file] < 0; }),
+		              entries.end());
+		for (auto& e : entries) e.file = newId[e.file];
+		it = entries.empty() ? segments.erase(it) : std::next(it);
+	}
+}
+
+bool SourceIndex::empty() const
+{
+	return segments.empty();
+}
+
+void SourceIndex::sort() const
+{
+	if (sorted) return;
+	// stable, so for macros and repeated code the first line stays first
+	for (auto& [segment, entries] : segments) {
+		std::stable_sort(entries.begin(), entries.end(),
+		                 [](const Entry& a, const Entry& b) { return a.address < b.address; });
+	}
+	sorted = true;
+}
+
+int SourceIndex::currentSegment(uint16_t address, const MemoryLayout* ml)
+{
+	int page = address >> 14;
+	int ps = ml->primarySlot[page] & 3;
+	int ss = ml->isSubslotted[ps] ? ml->secondarySlot[page] & 3 : 0;
+	if (ml->mapperSize[ps][ss] > 0) {
+		return ml->mapperSegment[page];
+	}
+	return ml->romBlock[address >> 13]; // -1 when there's no ROM mapper
+}
+
+std::optional<SourceIndex::Location> SourceIndex::find(uint16_t address,
+                                                       const MemoryLayout* ml) const
+{
+	sort();
+
+	auto lookup = [&](int segment) -> std::optional<Location> {
+		auto sit = segments.find(segment);
+		if (sit == segments.end()) return {};
+		const auto& entries = sit->second;
+		auto it = std::upper_bound(entries.begin(), entries.end(), address,
+		                           [](uint16_t a, const Entry& e) { return a < e.address; });
+		if (it == entries.begin()) return {};
+		--it;
+		if (address - it->address >= MAX_INSTRUCTION_LENGTH) return {};
+		// the first line that generated code at this address
+		auto first = std::lower_bound(entries.begin(), it + 1, it->address,
+		                              [](const Entry& e, uint16_t a) { return e.address < a; });
+		return Location{files[first->file].name, int(first->line)};
+	};
+
+	if (ml) {
+		int segment = currentSegment(address, ml);
+		if (segment >= 0) {
+			if (auto loc = lookup(segment)) return loc;
+		}
+	}
+	return lookup(-1);
+}
@@ -0,0 +1,60 @@
+#ifndef SOURCEINDEX_H
+#define SOURCEINDEX_H
+
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <vector>
+
+struct MemoryLayout;
+
+/**
+ * Maps Z80 addresses back to the source line that generated the code at
+ * that address, as found in assembler debug output (sjasmplus SLD files,
+ * sjasm/tniASM listings).
+ *
+ * Locations are grouped per mapper segment/ROM block (or -1 when the
+ * assembler didn't record one) and kept sorted on address, so a lookup is
+ * a binary search in a compact array of 8 byte entries.
+ */
+class SourceIndex
+{
+public:
+	struct Location {
+		QString file;
+		int line; // 0-based
+	};
+
+	void clear();
+	// 'origin' is the debug file (as stored in the symbol table) that
+	// produced the location, so they can be removed together with it
+	void add(const QString* origin, const QString& file, int line,
+	         int segment, uint16_t address);
+	void remove(const QString* origin);
+
+	// Location of the code at 'address'. When a memory layout is given the
+	// segment that is currently visible at that address is preferred.
+	[[nodiscard]] std::optional<Location> find(uint16_t address,
+	                                           const MemoryLayout* ml = nullptr) const;
+	[[nodiscard]] bool empty() const;
+
+private:
+	[[nodiscard]] static int currentSegment(uint16_t address, const MemoryLayout* ml);
+	void sort() const;
+
+	struct Entry {
+		uint16_t address;
+		uint16_t file;
+		uint32_t line;
+	};
+	struct File {
+		QString name;
+		const QString* origin;
+	};
+	std::vector<File> files;
+	mutable std::map<int, std::vector<Entry>> segments;
+	mutable bool sorted = true;
+};
+
+#endif // SOURCEINDEX_H
@@ -0,0 +1,204 @@
+#include "SourceViewer.h"
+#include "SourceFile.h"
+#include "SymbolTable.h"
+#include "Settings.h"
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QFileInfo>
+#include <algorithm>
+
+SourceViewer::SourceViewer(QWidget* parent)
+	: QFrame(parent)
+{
+	setFrameStyle(WinPanel | Sunken);
+	setFocusPolicy(Qt::StrongFocus);
+	setBackgroundRole(QPalette::Base);
+	setSizePolicy(QSizePolicy(QSizePolicy::Minimum, QSizePolicy::Preferred));
+	pcMarker = QPixmap(":/icons/pcarrow.png");
+
+	scrollBar = new QScrollBar(Qt::Vertical, this);
+	scrollBar->setMinimum(0);
+	scrollBar->setMaximum(0);
+
+	updateLayout();
+
+	connect(scrollBar, &QScrollBar::valueChanged, this, [this](int value) {
+		topLine = value;
+		update();
+	});
+}
+
+SourceViewer::~SourceViewer() = default;
+
+void SourceViewer::setMemoryLayout(const MemoryLayout* ml)
+{
+	memLayout = ml;
+}
+
+void SourceViewer::setSymbolTable(const SymbolTable* st)
+{
+	symTable = st;
+}
+
+QSize SourceViewer::sizeHint() const
+{
+	return {xText + 60 * QFontMetrics(Settings::get().font(Settings::CODE_FONT)).averageCharWidth(),
+	        headerHeight + 10 * lineHeight};
+}
+
+void SourceViewer::updateLayout()
+{
+	frameL = frameT = frameB = frameWidth();
+	frameR = frameL + scrollBar->sizeHint().width();
+
+	Settings& s = Settings::get();
+	QFontMetrics lfm(s.font(Settings::LABEL_FONT));
+	QFontMetrics cfm(s.font(Settings::CODE_FONT));
+	headerHeight = lfm.height() + 2;
+	lineHeight = cfm.height();
+	lineAscent = cfm.ascent();
+	xLineNr = frameL + 18;
+	xText = xLineNr + cfm.horizontalAdvance("000000 ");
+
+	setMinimumHeight(frameT + headerHeight + 3 * lineHeight + frameB);
+	setScrollBarValues();
+	update();
+}
+
+int SourceViewer::visibleLines() const
+{
+	return std::max(0, (height() - frameT - frameB - headerHeight) / lineHeight);
+}
+
+void SourceViewer::setScrollBarValues()
+{
+	int lines = file ? file->lineCount() : 0;
+	int visible = visibleLines();
+	scrollBar->setMaximum(std::max(0, lines - visible));
+	scrollBar->setSingleStep(1);
+	scrollBar->setPageStep(std::max(1, visible));
+}
+
+void SourceViewer::resizeEvent(QResizeEvent* e)
+{
+	QFrame::resizeEvent(e);
+
+	scrollBar->setGeometry(width() - frameR, frameT + headerHeight,
+	                       scrollBar->sizeHint().width(),
+	                       height() - frameT - frameB - headerHeight);
+	setScrollBarValues();
+}
+
+void SourceViewer::wheelEvent(QWheelEvent* e)
+{
+	wheelRemainder += e->angleDelta().y();
+	const int delta = wheelRemainder / 40;
+	wheelRemainder %= 40;
+	if (delta) {
+		scrollBar->setValue(scrollBar->value() - delta);
+	}
+	e->accept();
+}
+
+void SourceViewer::refresh()
+{
+	// files may have changed on disk, map them again when needed
+	file = nullptr;
+	files.clear();
+	setProgramCounter(programAddr);
+}
+
+void SourceViewer::showFile(const QString& fileName)
+{
+	if (file && file->fileName() == fileName) return;
+
+	auto& f = files[fileName];
+	if (!f) f = std::make_unique<SourceFile>(fileName);
+	file = f.get();
+	topLine = 0;
+	setScrollBarValues();
+}
+
+void SourceViewer::scrollTo(int line)
+{
+	// only scroll when the line isn't visible (with a small margin), so
+	// stepping through the code doesn't make the view jump every time
+	int visible = visibleLines();
+	int margin = std::min(2, visible / 4);
+	if (line < topLine + margin || line >= topLine + visible - margin) {
+		topLine = std::max(0, line - visible / 3);
+	}
+	scrollBar->setValue(topLine);
+	topLine = scrollBar->value();
+}
+
+void SourceViewer::setProgramCounter(uint16_t pc)
+{
+	programAddr = pc;
+	pcLine = -1;
+	if (symTable) {
+		if (auto loc = symTable->sourceIndex().find(pc, memLayout)) {
+			showFile(loc->file);
+			pcLine = loc->line;
+			scrollTo(pcLine);
+		}
+	}
+	update();
+}
+
+void SourceViewer::paintEvent(QPaintEvent* e)
+{
+	// call parent for drawing the actual frame
+	QFrame::paintEvent(e);
+
+	QPainter p(this);
+
+	// calc and set drawing bounds
+	QRect r(e->rect());
+	if (r.left() < frameL) r.setLeft(frameL);
+	if (r.top()  < frameT) r.setTop(frameT);
+	if (r.right()  > width()  - frameR - 1) r.setRight (width()  - frameR - 1);
+	if (r.bottom() > height() - frameB - 1) r.setBottom(height() - frameB - 1);
+	p.setClipRect(r);
+
+	Settings& s = Settings::get();
+	int w = width() - frameL - frameR;
+
+	// header with the file name
+	p.fillRect(frameL, frameT, w, headerHeight, palette().color(QPalette::Button));
+	p.setFont(s.font(Settings::LABEL_FONT));
+	p.setPen(palette().color(QPalette::ButtonText));
+	QString title;
+	if (!file) {
+		title = tr("No source available");
+	} else if (!file->isOpen()) {
+		title = tr("Can't open %1").arg(file->fileName());
+	} else {
+		title = QFileInfo(file->fileName()).fileName();
+		if (pcLine < 0) title += tr(" (no source for PC)");
+	}
+	p.drawText(frameL + 4, frameT + QFontMetrics(p.font()).ascent() + 1, title);
+
+	int y = frameT + headerHeight;
+	p.fillRect(frameL, y, w, height() - y - frameB, palette().color(QPalette::Base));
+	if (!file || !file->isOpen()) return;
+
+	// only the visible lines are fetched from the file
+	p.setFont(s.font(Settings::CODE_FONT));
+	int last = std::min(file->lineCount(), topLine + visibleLines() + 1);
+	for (int line = topLine; line < last; ++line, y += lineHeight) {
+		if (line == pcLine) {
+			p.fillRect(frameL + 16, y, w - 16, lineHeight,
+			           palette().color(QPalette::Highlight));
+			p.drawPixmap(frameL + 2, y + lineHeight / 2 - 5, pcMarker);
+			p.setPen(palette().color(QPalette::HighlightedText));
+		} else {
+			p.setPen(palette().color(QPalette::Dark));
+		}
+		p.drawText(xLineNr, y + lineAscent, QString::number(line + 1));
+		if (line != pcLine) p.setPen(s.fontColor(Settings::CODE_FONT));
+		p.drawText(xText, y + lineAscent, file->line(line));
+	}
+}
@@ -0,0 +1,66 @@
+#ifndef SOURCEVIEWER_H
+#define SOURCEVIEWER_H
+
+#include <QFrame>
+#include <QPixmap>
+#include <QString>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+class QScrollBar;
+class SourceFile;
+class SymbolTable;
+struct MemoryLayout;
+
+/**
+ * Shows the assembler source line for the current program counter. The
+ * address to line mapping comes from the debug files (sld, listing) that
+ * are loaded in the symbol table.
+ */
+class SourceViewer : public QFrame
+{
+	Q_OBJECT
+public:
+	SourceViewer(QWidget* parent = nullptr);
+	~SourceViewer() override;
+
+	void setMemoryLayout(const MemoryLayout* ml);
+	void setSymbolTable(const SymbolTable* st);
+	void setProgramCounter(uint16_t pc);
+	void updateLayout();
+	// drop cached files, e.g. after the debug files were reloaded
+	void refresh();
+
+	QSize sizeHint() const override;
+
+private:
+	void resizeEvent(QResizeEvent* e) override;
+	void paintEvent(QPaintEvent* e) override;
+	void wheelEvent(QWheelEvent* e) override;
+
+	void showFile(const QString& fileName);
+	void setScrollBarValues();
+	void scrollTo(int line);
+	[[nodiscard]] int visibleLines() const;
+
+private:
+	QScrollBar* scrollBar;
+	QPixmap pcMarker;
+
+	const MemoryLayout* memLayout = nullptr;
+	const SymbolTable* symTable = nullptr;
+
+	std::map<QString, std::unique_ptr<SourceFile>> files;
+	SourceFile* file = nullptr;
+	uint16_t programAddr = 0;
+	int pcLine = -1;
+	int topLine = 0;
+
+	int wheelRemainder = 0;
+	int frameL, frameR, frameT, frameB;
+	int headerHeight, lineHeight, lineAscent;
+	int xLineNr, xText;
+};
+
+#endif // SOURCEVIEWER_H
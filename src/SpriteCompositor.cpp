@@ -0,0 +1,123 @@
+#include "SpriteCompositor.h"
+#include <algorithm>
+
+// doubles every bit of a 16 bit pattern row into 32 bits
+static uint32_t magnify(uint32_t bits)
+{
+	bits = (bits | (bits << 8)) & 0x00ff00ff;
+	bits = (bits | (bits << 4)) & 0x0f0f0f0f;
+	bits = (bits | (bits << 2)) & 0x33333333;
+	bits = (bits | (bits << 1)) & 0x55555555;
+	return bits | (bits << 1);
+}
+
+void SpriteCompositor::compose(const uint8_t* vram, const Settings& newSettings,
+                               const QRgb palette[16], QRgb background, QImage& target)
+{
+	settings = newSettings;
+	settings.lines = std::clamp(settings.lines, 0, std::min(256, target.height()));
+	collectLines(vram);
+
+	for (int y = 0; y < settings.lines; ++y) {
+		auto* out = reinterpret_cast<QRgb*>(target.scanLine(y));
+		std::fill_n(out, WIDTH, background);
+		std::fill_n(owner[y], WIDTH, int8_t(-1));
+		composeLine(vram, y, palette, out);
+	}
+}
+
+int SpriteCompositor::spriteAt(int x, int y) const
+{
+	if (x < 0 || x >= WIDTH || y < 0 || y >= settings.lines) return -1;
+	return owner[y][x];
+}
+
+void SpriteCompositor::collectLines(const uint8_t* vram)
+{
+	for (auto& l : lineSprites) l.count = 0;
+
+	int height = (settings.size16x16 ? 16 : 8) << (settings.magnified ? 1 : 0);
+	// Y = 208 (sprite mode 1) or 216 (sprite mode 2) ends the table
+	int terminator = settings.spriteMode == 2 ? 216 : 208;
+	for (int sprite = 0; sprite < MAX_SPRITES; ++sprite) {
+		int attrY = vram[settings.attributeTableAddress + 4 * sprite];
+		if (attrY == terminator) break;
+		// a sprite starts on the line after its Y coordinate
+		int top = attrY + 1 - settings.verticalScroll;
+		for (int row = 0; row < height; ++row) {
+			int y = (top + row) & 255;
+			if (y >= settings.lines) continue;
+			auto& l = lineSprites[y];
+			l.sprites[l.count++] = uint8_t(sprite);
+		}
+	}
+}
+
+SpriteCompositor::Row SpriteCompositor::spriteRow(const uint8_t* vram, int sprite, int y) const
+{
+	const uint8_t* attr = &vram[settings.attributeTableAddress + 4 * sprite];
+	int row = ((y + settings.verticalScroll - attr[0] - 1) & 255) >> (settings.magnified ? 1 : 0);
+	int pattern = settings.size16x16 ? (attr[2] & 0xfc) : attr[2];
+
+	// the right half of a 16x16 sprite is 16 bytes further
+	unsigned address = settings.patternTableAddress + 8 * pattern + row;
+	uint32_t bits = vram[address] << 8;
+	if (settings.size16x16) bits |= vram[address + 16];
+	uint32_t mask = settings.magnified ? magnify(bits) : bits << 16;
+
+	uint8_t color = settings.spriteMode == 2
+	              ? vram[settings.colorTableAddress + 16 * sprite + row]
+	              : attr[3];
+	int x = attr[1] - (color & 0x80 ? 32 : 0); // EC bit
+	return {x, mask, color, uint8_t(sprite)};
+}
+
+void SpriteCompositor::composeLine(const uint8_t* vram, int y, const QRgb palette[16], QRgb* out)
+{
+	const auto& l = lineSprites[y];
+	int n = std::min(l.count, limit());
+	if (n == 0) return;
+
+	Row rows[8];
+	int minX = WIDTH;
+	int maxX = 0;
+	for (int i = 0; i < n; ++i) {
+		rows[i] = spriteRow(vram, l.sprites[i], y);
+		minX = std::min(minX, rows[i].x);
+		maxX = std::max(maxX, rows[i].x + 32);
+	}
+	minX = std::max(minX, 0);
+	maxX = std::min(maxX, WIDTH);
+
+	bool mode2 = settings.spriteMode == 2;
+	for (int x = minX; x < maxX; ++x) {
+		int color = 0;
+		int sprite = -1;
+		bool leader = false; // a sprite with CC=0 was seen on this line
+		for (int i = 0; i < n; ++i) {
+			const Row& r = rows[i];
+			bool cc = mode2 && (r.color & 0x40);
+			if (!cc) {
+				// a higher priority sprite (group) already colors this pixel,
+				// transparent ones (color 0) let the lower priority ones through
+				if (color) break;
+				sprite = -1;
+				leader = true;
+			}
+			unsigned offset = x - r.x;
+			if (offset >= 32 || !((r.mask << offset) & 0x80000000)) continue;
+			if (cc) {
+				// CC sprites are only shown when a CC=0 sprite comes before them
+				if (!leader) continue;
+				color |= r.color & 15;
+			} else {
+				color = r.color & 15;
+			}
+			if (sprite < 0) sprite = r.sprite;
+		}
+		if (color) {
+			out[x] = palette[color];
+			owner[y][x] = int8_t(sprite);
+		}
+	}
+}
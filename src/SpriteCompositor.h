@@ -0,0 +1,68 @@
+#ifndef SPRITECOMPOSITOR_H
+#define SPRITECOMPOSITOR_H
+
+#include <QImage>
+#include <cstdint>
+
+/**
+ * Renders the sprite plane the way the VDP shows it for the current sprite
+ * attribute table. Per display line only the first 4 (sprite mode 1) or 8
+ * (sprite mode 2) sprites are shown, sprite mode 2 takes the color per line
+ * from the sprite color table and ORs sprites with the CC bit set into the
+ * sprite before them, the EC bit shifts a sprite (line) 32 pixels to the
+ * left. Besides the image it keeps, for every display line, which sprites
+ * are on it, so lines where sprites are dropped can be shown.
+ */
+class SpriteCompositor
+{
+public:
+	static constexpr int MAX_SPRITES = 32;
+	static constexpr int WIDTH = 256;
+
+	struct Settings {
+		int spriteMode = 1; // 1 or 2, as in VramSpriteView
+		bool size16x16 = false;
+		bool magnified = false;
+		unsigned patternTableAddress = 0;
+		unsigned attributeTableAddress = 0;
+		unsigned colorTableAddress = 0;
+		int lines = 192;
+		int verticalScroll = 0; // VDP register 23
+	};
+
+	struct Line {
+		uint8_t sprites[MAX_SPRITES]; // in priority order, including the dropped ones
+		int count = 0;
+	};
+
+	// Renders the sprites into the top left 256 x 'lines' pixels of 'target',
+	// pixels without sprite get 'background'.
+	void compose(const uint8_t* vram, const Settings& settings,
+	             const QRgb palette[16], QRgb background, QImage& target);
+
+	// sprites per line before the VDP drops the remaining ones
+	[[nodiscard]] int limit() const { return settings.spriteMode == 2 ? 8 : 4; }
+	[[nodiscard]] int lines() const { return settings.lines; }
+	[[nodiscard]] const Line& line(int y) const { return lineSprites[y]; }
+	// the sprite that colors this pixel, -1 if none
+	[[nodiscard]] int spriteAt(int x, int y) const;
+
+private:
+	// one line of one sprite, bit 31 is the leftmost pixel
+	struct Row {
+		int x;
+		uint32_t mask;
+		uint8_t color;
+		uint8_t sprite;
+	};
+
+	void collectLines(const uint8_t* vram);
+	[[nodiscard]] Row spriteRow(const uint8_t* vram, int sprite, int y) const;
+	void composeLine(const uint8_t* vram, int y, const QRgb palette[16], QRgb* out);
+
+	Settings settings;
+	Line lineSprites[256];
+	int8_t owner[256][WIDTH];
+};
+
+#endif // SPRITECOMPOSITOR_H
@@ -1,5 +1,6 @@
 #include "SpriteViewer.h"
 #include "VDPDataStore.h"
+#include "VDPLiveControl.h"
 #include "VramSpriteView.h"
 #include "PaletteDialog.h"
 #include "Convert.h"
@@ -52,6 +53,12 @@ SpriteViewer::SpriteViewer(QWidget* parent)
     // This allows the VDPDatastore to start asking for data as quickly as possible.
     auto& dataStore = VDPDataStore::instance();
     connect(ui->refreshButton, &QPushButton::clicked, &dataStore, &VDPDataStore::refresh);
+    // recording takes the sprite layer, the sprites as the VDP shows them
+    auto* liveControl = new VDPLiveControl();
+    liveControl->setCaptureSource([this] { return imageWidgetLayer->frame(); });
+    delete ui->liveControl_widget->parentWidget()->layout()->replaceWidget(
+        ui->liveControl_widget, liveControl);
+    delete ui->liveControl_widget;
     connect(&dataStore, &VDPDataStore::dataRefreshed, this, &SpriteViewer::VDPDataStoreDataRefreshed);
 
     imageWidget = new VramSpriteView();
@@ -99,6 +106,15 @@ SpriteViewer::SpriteViewer(QWidget* parent)
     imageWidgetColor->setVramSource(dataStore.getVramPointer());
 
 
+    imageWidgetLayer = new VramSpriteView(nullptr, VramSpriteView::SpriteLayerMode);
+    connect(&dataStore, &VDPDataStore::dataRefreshed, imageWidgetLayer, &VramSpriteView::refresh);
+    delete ui->spriteLayer_widget->parentWidget()->layout()->replaceWidget(
+        ui->spriteLayer_widget, imageWidgetLayer);
+    delete ui->spriteLayer_widget;
+
+    imageWidgetLayer->setVramSource(dataStore.getVramPointer());
+
+
     setPaletteSource(dataStore.getPalettePointer(), true);
 
     setCorrectVDPData();
@@ -121,6 +137,12 @@ SpriteViewer::SpriteViewer(QWidget* parent)
     connect(imageWidgetColor, &VramSpriteView::imageClicked,
             this, &SpriteViewer::spatwidget_mouseClickedEvent);
 
+    // Hovering a sprite on the sprite layer shows its attributes
+    connect(imageWidgetLayer, &VramSpriteView::imagePosition,
+            this, &SpriteViewer::spatwidget_mouseMoveEvent);
+    connect(imageWidgetLayer, &VramSpriteView::imageClicked,
+            this, &SpriteViewer::layerwidget_mouseClickedEvent);
+
 
     // Have spat and color the same spriteselection box synced
     connect(imageWidgetSpat, &VramSpriteView::spriteboxClicked,
@@ -157,6 +179,7 @@ void SpriteViewer::setPaletteSource(const uint8_t* palSource, bool useVDP)
     imageWidgetSingle->setPaletteSource(palSource, useVDP);
     imageWidgetSpat->setPaletteSource(palSource, useVDP);
     imageWidgetColor->setPaletteSource(palSource, useVDP);
+    imageWidgetLayer->setPaletteSource(palSource, useVDP);
 }
 
 void SpriteViewer::refresh()
@@ -220,6 +243,16 @@ void SpriteViewer::spatwidget_mouseClickedEvent(int x, int y, int character, con
                                     .arg(text));
 }
 
+void SpriteViewer::layerwidget_mouseClickedEvent(int x, int y, int sprite, const QString& text)
+{
+    if (sprite >= 0) {
+        spatwidget_mouseMoveEvent(x, y, sprite);
+    }
+    ui->plainTextEdit->setPlainText(QString("info for line %1\n%2")
+                                    .arg(y)
+                                    .arg(text));
+}
+
 void SpriteViewer::setDrawGrid(int state)
 {
     imageWidget->setDrawgrid(state == Qt::Checked);
@@ -272,6 +305,7 @@ void SpriteViewer::on_le_patterntable_textChanged(const QString& arg1)
         imageWidgetSingle->setPatternTableAddress(*i);
         imageWidgetSpat->setPatternTableAddress(*i);
         imageWidgetColor->setPatternTableAddress(*i);
+        imageWidgetLayer->setPatternTableAddress(*i);
         auto font = ui->le_patterntable->font();
         font.setItalic(false);
         ui->le_patterntable->setFont(font);
@@ -289,6 +323,7 @@ void SpriteViewer::on_le_attributentable_textChanged(const QString& arg1)
         imageWidgetSingle->setAttributeTableAddress(*i);
         imageWidgetSpat->setAttributeTableAddress(*i);
         imageWidgetColor->setAttributeTableAddress(*i);
+        imageWidgetLayer->setAttributeTableAddress(*i);
         auto font = ui->le_attributentable->font();
         font.setItalic(false);
         ui->le_attributentable->setFont(font);
@@ -339,6 +374,9 @@ void SpriteViewer::setCorrectVDPData()
     imageWidgetColor->setSize16x16(size16x16);
     imageWidgetColor->setSpritemode(spriteMode);
 
+    imageWidgetLayer->setSize16x16(size16x16);
+    imageWidgetLayer->setSpritemode(spriteMode);
+
     ui->cb_spritemode->setCurrentIndex(spriteMode);
     ui->cb_size->setCurrentIndex(size16x16?1:0);
     ui->cb_mag->setCurrentIndex(magnified?1:0);
@@ -359,6 +397,7 @@ void SpriteViewer::on_cb_size_currentIndexChanged(int index)
     imageWidgetSingle->setSize16x16(size16x16);
     imageWidgetSpat->setSize16x16(size16x16);
     imageWidgetColor->setSize16x16(size16x16);
+    imageWidgetLayer->setSize16x16(size16x16);
 }
 
 void SpriteViewer::on_cb_spritemode_currentIndexChanged(int index)
@@ -369,6 +408,7 @@ void SpriteViewer::on_cb_spritemode_currentIndexChanged(int index)
     imageWidgetSingle->setSpritemode(index);
     imageWidgetSpat->setSpritemode(index);
     imageWidgetColor->setSpritemode(index);
+    imageWidgetLayer->setSpritemode(index);
 }
 
 void SpriteViewer::on_le_colortable_textChanged(const QString& arg1)
@@ -379,6 +419,7 @@ void SpriteViewer::on_le_colortable_textChanged(const QString& arg1)
         imageWidgetSingle->setColorTableAddress(*i);
         imageWidgetSpat->setColorTableAddress(*i);
         imageWidgetColor->setColorTableAddress(*i);
+        imageWidgetLayer->setColorTableAddress(*i);
         auto font = ui->le_patterntable->font();
         font.setItalic(false);
         ui->le_patterntable->setFont(font);
@@ -409,6 +450,7 @@ void SpriteViewer::on_cb_mag_currentIndexChanged(int index)
     imageWidget->setUseMagnification(index == 1);
     imageWidgetSpat->setUseMagnification(index == 1);
     imageWidgetColor->setUseMagnification(index == 1);
+    imageWidgetLayer->setUseMagnification(index == 1);
 }
 
 void SpriteViewer::on_cb_alwaysShowColorTable_toggled(bool /*checked*/)
@@ -429,6 +471,7 @@ void SpriteViewer::on_useVDPPalette_stateChanged(int state)
     imageWidgetSingle->refresh();
     imageWidgetSpat->refresh();
     imageWidgetColor->refresh();
+    imageWidgetLayer->refresh();
     ui->editPaletteButton->setEnabled(state != Qt::Checked);
 }
 
@@ -441,5 +484,6 @@ void SpriteViewer::on_editPaletteButton_clicked(bool /*checked*/)
     connect(p, &PaletteDialog::paletteSynced, imageWidgetSingle, &VramSpriteView::refresh);
     connect(p, &PaletteDialog::paletteSynced, imageWidgetSpat, &VramSpriteView::refresh);
     connect(p, &PaletteDialog::paletteSynced, imageWidgetColor, &VramSpriteView::refresh);
+    connect(p, &PaletteDialog::paletteSynced, imageWidgetLayer, &VramSpriteView::refresh);
     p->show();
 }
@@ -22,6 +22,7 @@ private:
     void pgtwidget_mouseClickedEvent(int x, int y, int character, const QString& text);
     void spatwidget_mouseMoveEvent(int x, int y, int character);
     void spatwidget_mouseClickedEvent(int x, int y, int character, const QString& text);
+    void layerwidget_mouseClickedEvent(int x, int y, int sprite, const QString& text);
 
     void setDrawGrid(int state);
 
@@ -51,6 +52,7 @@ private:
     VramSpriteView* imageWidgetSingle;
     VramSpriteView* imageWidgetSpat;
     VramSpriteView* imageWidgetColor;
+    VramSpriteView* imageWidgetLayer;
 
     int spriteMode = 0;
     bool size16x16 = false;
@@ -0,0 +1,27 @@
+#include "SymbolCompleter.h"
+#include "SymbolTable.h"
+#include <QStringListModel>
+
+SymbolCompleter::SymbolCompleter(SymbolTable& symtable, bool includeVars_,
+                                 const MemoryLayout* ml, QObject* parent)
+	: QCompleter(parent), symTable(symtable)
+	, labels(new QStringListModel(this)), memLayout(ml), includeVars(includeVars_)
+{
+	setModel(labels);
+	// the list is already filtered and ranked by the label index
+	setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+	setCaseSensitivity(Qt::CaseInsensitive);
+}
+
+void SymbolCompleter::update(const QString& text)
+{
+	if (text.isEmpty()) {
+		labels->setStringList({});
+		return;
+	}
+	labels->setStringList(symTable.labelIndex().complete(text, MAX_RESULTS,
+		[&](const Symbol* sym) {
+			if (sym->type() == Symbol::VARIABLELABEL && !includeVars) return false;
+			return sym->isSlotValid(memLayout);
+		}));
+}
@@ -0,0 +1,34 @@
+#ifndef SYMBOLCOMPLETER_H
+#define SYMBOLCOMPLETER_H
+
+#include <QCompleter>
+
+class QStringListModel;
+class SymbolTable;
+struct MemoryLayout;
+
+/**
+ * Completer for address labels, backed by the label index of the symbol
+ * table. Instead of filtering a full list of labels, the list is replaced
+ * by the (prefix and fuzzy) matches from the index every time update() is
+ * called with the current text of the edit field.
+ */
+class SymbolCompleter : public QCompleter
+{
+	Q_OBJECT
+public:
+	SymbolCompleter(SymbolTable& symtable, bool includeVars,
+	                const MemoryLayout* ml = nullptr, QObject* parent = nullptr);
+
+	void update(const QString& text);
+
+private:
+	static constexpr int MAX_RESULTS = 50;
+
+	SymbolTable& symTable;
+	QStringListModel* labels;
+	const MemoryLayout* memLayout;
+	bool includeVars;
+};
+
+#endif // SYMBOLCOMPLETER_H
@@ -1,7 +1,7 @@
 #include "SymbolManager.h"
 #include "SymbolTable.h"
+#include "SymbolTableModel.h"
 #include "Settings.h"
-#include "Convert.h"
 #include <QComboBox>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -12,6 +12,12 @@ SymbolManager::SymbolManager(SymbolTable& symtable, QWidget* parent)
 {
 	setupUi(this);
 
+	symbolModel = new SymbolTableModel(symTable, this);
+	treeLabels->setModel(symbolModel);
+	treeLabels->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+	cmbFilterMode->addItem(tr("Contains"));
+	cmbFilterMode->addItem(tr("Starts with"));
+
 	// restore layout
 	Settings& s = Settings::get();
 	restoreGeometry(s.value("SymbolManager/WindowGeometry", saveGeometry()).toByteArray());
@@ -21,7 +27,6 @@ SymbolManager::SymbolManager(SymbolTable& symtable, QWidget* parent)
 	                                   treeLabels->header()->saveState()).toByteArray());
 
 	treeLabelsUpdateCount = 0;
-	editColumn = -1;
 
 	// put slot checkboxes in a convenience array
 	chkSlots[ 0] = chk00; chkSlots[ 1] = chk01; chkSlots[ 2] = chk02; chkSlots[ 3] = chk03;
@@ -38,9 +43,10 @@ SymbolManager::SymbolManager(SymbolTable& symtable, QWidget* parent)
 	connect(btnAddFile,     &QPushButton::clicked, this, &SymbolManager::addFile);
 	connect(btnRemoveFile,  &QPushButton::clicked, this, &SymbolManager::removeFile);
 	connect(btnReloadFiles, &QPushButton::clicked, this, &SymbolManager::reloadFiles);
-	connect(treeLabels, &QTreeWidget::itemSelectionChanged, this, &SymbolManager::labelSelectionChanged);
-	connect(treeLabels, &QTreeWidget::itemDoubleClicked,    this, &SymbolManager::labelEdit);
-	connect(treeLabels, &QTreeWidget::itemChanged,          this, &SymbolManager::labelChanged);
+	connect(treeLabels->selectionModel(), &QItemSelectionModel::selectionChanged, this, &SymbolManager::labelSelectionChanged);
+	connect(symbolModel, &SymbolTableModel::dataChanged, this, &SymbolManager::labelChanged);
+	connect(edtFilter, &QLineEdit::textChanged, this, &SymbolManager::filterChanged);
+	connect(cmbFilterMode, qOverload<int>(&QComboBox::currentIndexChanged), this, &SymbolManager::filterChanged);
 	connect(btnAddSymbol,    &QPushButton::clicked, this, &SymbolManager::addLabel);
 	connect(btnRemoveSymbol, &QPushButton::clicked, this, &SymbolManager::removeLabel);
 	connect(radJump,  &QRadioButton::toggled, this, &SymbolManager::changeType);
@@ -86,8 +92,8 @@ SymbolManager::SymbolManager(SymbolTable& symtable, QWidget* parent)
 	btnRemoveFile->setEnabled(false);
 	btnRemoveSymbol->setEnabled(false);
 
+	// the symbol list was filled when the model was created
 	initFileList();
-	initSymbolList();
 }
 
 void SymbolManager::closeEvent(QCloseEvent* e)
@@ -158,7 +164,7 @@ void SymbolManager::addFile()
 	// create dialog
 	auto* d = new QFileDialog(this);
 	QStringList types;
-	types << "All supported files (*.omds *.sym *.map *.noi *.symbol *.publics *.sys)"
+	types << "All supported files (*.omds *.sym *.map *.noi *.symbol *.publics *.sys *.sld *.lst)"
 		  << "OpenMSX Debugger session files (*.omds)"
 	      << "tniASM 0.x symbol files (*.sym)"
 	      << "tniASM 1.x symbol files (*.sym)"
@@ -166,7 +172,9 @@ void SymbolManager::addFile()
 	      << "HiTech C symbol files (*.sym)"
 	      << "HiTech C link map files (*.map)"
 	      << "NoICE command files (*.noi)"
-	      << "pasmo symbol files (*.symbol *.publics *.sys)";
+	      << "pasmo symbol files (*.symbol *.publics *.sys)"
+	      << "sjasmplus source level debug files (*.sld)"
+	      << "sjasm/tniASM listing files (*.lst)";
 	d->setNameFilters(types);
 	d->setAcceptMode(QFileDialog::AcceptOpen);
 	d->setFileMode(QFileDialog::ExistingFile);
@@ -194,6 +202,10 @@ void SymbolManager::addFile()
 			read = symTable.readFile(n, SymbolTable::NOICE_FILE);
 		} else if (f.startsWith("pasmo")) {
 			read = symTable.readFile(n, SymbolTable::PASMO_FILE);
+		} else if (f.startsWith("sjasmplus source")) {
+			read = symTable.readFile(n, SymbolTable::SLD_FILE);
+		} else if (f.startsWith("sjasm/tniASM listing")) {
+			read = symTable.readFile(n, SymbolTable::LISTING_FILE);
 		} else {
 			read = symTable.readFile(n);
 		}
@@ -255,48 +267,32 @@ void SymbolManager::fileSelectionChange()
 	btnRemoveFile->setEnabled(!treeFiles->selectedItems().empty());
 }
 
-void SymbolManager::labelEdit(QTreeWidgetItem* item, int column)
-{
-	// only symbol name and value are editable
-	if (column == 0 || column == 2) {
-		// open editor if manually added symbol
-		auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-		if (!sym->source()) {
-			// first close possible existing editor
-			closeEditor();
-			// open new editor
-			treeLabels->openPersistentEditor(item, column);
-			editItem = item;
-			editColumn = column;
-		}
-	}
-}
-
 /*
  * Symbol support functions
  */
 
 void SymbolManager::initSymbolList()
 {
-	treeLabels->clear();
 	beginTreeLabelsUpdate();
-	for (Symbol* sym = symTable.findFirstAddressSymbol(0);
-			sym != nullptr;
-			sym = symTable.findNextAddressSymbol()) {
-		auto* item = new QTreeWidgetItem(treeLabels);
-		// attach a pointer to the symbol object to the tree item
-		item->setData(0L, Qt::UserRole, quintptr(sym));
-		// update columns
-		updateItemName(item);
-		updateItemType(item);
-		updateItemValue(item);
-		updateItemSlots(item);
-		updateItemSegments(item);
-		updateItemRegisters(item);
-	}
+	symbolModel->reload();
 	endTreeLabelsUpdate();
 }
 
+QList<Symbol*> SymbolManager::selectedSymbols() const
+{
+	QList<Symbol*> result;
+	for (const auto& index : treeLabels->selectionModel()->selectedRows()) {
+		if (auto* sym = symbolModel->symbolAt(index)) result.append(sym);
+	}
+	return result;
+}
+
+void SymbolManager::filterChanged()
+{
+	symbolModel->setFilter(edtFilter->text(),
+	                       SymbolTableModel::FilterMode(cmbFilterMode->currentIndex()));
+}
+
 void SymbolManager::beginTreeLabelsUpdate()
 {
 	++treeLabelsUpdateCount;
@@ -309,36 +305,19 @@ void SymbolManager::endTreeLabelsUpdate()
 	}
 }
 
-void SymbolManager::closeEditor()
-{
-	if (editColumn >= 0) {
-		treeLabels->closePersistentEditor(editItem, editColumn);
-		editColumn = -1;
-	}
-}
-
 void SymbolManager::addLabel()
 {
 	// create an empty symbol
 	auto* sym = symTable.add(std::make_unique<Symbol>(tr("New symbol"), 0));
 
 	beginTreeLabelsUpdate();
-	auto* item = new QTreeWidgetItem(treeLabels);
-	item->setData(0, Qt::UserRole, quintptr(sym));
-	updateItemName(item);
-	updateItemType(item);
-	updateItemValue(item);
-	updateItemSlots(item);
-	updateItemSegments(item);
-	updateItemRegisters(item);
+	symbolModel->insertSymbol(sym);
 	endTreeLabelsUpdate();
-	closeEditor();
+	auto index = symbolModel->indexOf(sym);
 	treeLabels->setFocus();
-	treeLabels->setCurrentItem(item, 0);
-	treeLabels->scrollToItem(item);
-	treeLabels->openPersistentEditor(item, 0);
-	editItem = item;
-	editColumn = 0;
+	treeLabels->setCurrentIndex(index);
+	treeLabels->scrollTo(index);
+	treeLabels->edit(index);
 
 	// emit notification that something has changed
 	emit symbolTableChanged();
@@ -346,14 +325,12 @@ void SymbolManager::addLabel()
 
 void SymbolManager::removeLabel()
 {
-	QList<QTreeWidgetItem*> selection = treeLabels->selectedItems();
+	QList<Symbol*> selection = selectedSymbols();
 	// check for selection
 	if (selection.empty()) return;
 	// remove selected items
 	bool deleted = false;
-	for (auto* sel : selection) {
-		// get symbol
-		Symbol* sym = reinterpret_cast<Symbol*>(sel->data(0, Qt::UserRole).value<quintptr>());
+	for (auto* sym : selection) {
 		// check if symbol is from symbol file
 		if (!sym->source()) {
 			// remove from table
@@ -368,24 +345,10 @@ void SymbolManager::removeLabel()
 	}
 }
 
-void SymbolManager::labelChanged(QTreeWidgetItem* item, int column)
+void SymbolManager::labelChanged()
 {
+	// the model already updated the symbol after an edit in the view
 	if (!treeLabelsUpdateCount) {
-		auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-		// Set symbol text from tree item if any
-		QString symText = item->text(0).trimmed();
-		if (symText.isEmpty()) symText = "[unnamed]";
-		sym->setText(symText);
-		// set value TODO: proper decoding of value
-		auto value = stringToValue<uint16_t>(item->text(2));
-		if (value) sym->setValue(*value);
-		treeLabels->closePersistentEditor(item, column);
-		editColumn = -1;
-		// update item name and value
-		beginTreeLabelsUpdate();
-		updateItemName(item);
-		updateItemValue(item);
-		endTreeLabelsUpdate();
 		// notify change
 		emit symbolTableChanged();
 	}
@@ -419,15 +382,12 @@ void SymbolManager::wipeSelectedItem()
 	}
 
 	txtSegments->setText("");
-	treeLabels->setCurrentItem(nullptr);
+	treeLabels->selectionModel()->clear();
 }
 
 void SymbolManager::labelSelectionChanged()
 {
-	// remove possible editor
-	closeEditor();
-
-	QList<QTreeWidgetItem*> selection = treeLabels->selectedItems();
+	QList<Symbol*> selection = selectedSymbols();
 	// check if is available at all
 	if (selection.empty()) {
 		wipeSelectedItem();
@@ -449,8 +409,7 @@ void SymbolManager::labelSelectionChanged()
 	int slotMask, slotMaskMultiple = 0;
 	int regMask, regMaskMultiple = 0;
 	for (auto selit = selection.begin(); selit != selection.end(); ++selit) {
-		// get symbol
-		auto* sym = reinterpret_cast<Symbol*>((*selit)->data(0, Qt::UserRole).value<quintptr>());
+		auto* sym = *selit;
 		// check if symbol is from symbol file
 		if (sym->source()) removeButActive = false;
 
@@ -530,23 +489,18 @@ void SymbolManager::changeSlot(int id, int state)
 
 	// disallow another tristate selection
 	chkSlots[id]->setTristate(false);
-	// get selected items
-	QList<QTreeWidgetItem*> selection = treeLabels->selectedItems();
-
-	// update items
+	// update selected symbols
 	beginTreeLabelsUpdate();
 	int bit = 1 << id;
-	for (auto* sel : selection) {
-		auto* sym = reinterpret_cast<Symbol*>(sel->data(0, Qt::UserRole).value<quintptr>());
+	for (auto* sym : selectedSymbols()) {
 		// set or clear bit
 		if (state == Qt::Checked) {
 			sym->setValidSlots(sym->validSlots() |  bit);
 		} else {
 			sym->setValidSlots(sym->validSlots() & ~bit);
 		}
-		// update item in treewidget
-		updateItemSlots(sel);
 	}
+	symbolModel->refreshColumn(SymbolTableModel::SLOTS);
 	endTreeLabelsUpdate();
 	// notify change
 	emit symbolTableChanged();
@@ -558,23 +512,18 @@ void SymbolManager::changeRegister(int id, int state)
 
 	// disallow another tristate selection
 	chkRegs[id]->setTristate(false);
-	// get selected items
-	QList<QTreeWidgetItem*> selection = treeLabels->selectedItems();
-
-	// update items
+	// update selected symbols
 	beginTreeLabelsUpdate();
 	int bit = 1 << id;
-	for (auto* sel : selection) {
-		auto* sym = reinterpret_cast<Symbol*>(sel->data(0, Qt::UserRole).value<quintptr>());
+	for (auto* sym : selectedSymbols()) {
 		// set or clear bit
 		if (state == Qt::Checked) {
 			sym->setValidRegisters(sym->validRegisters() |  bit);
 		} else {
 			sym->setValidRegisters(sym->validRegisters() & ~bit);
 		}
-		// update item in treewidget
-		updateItemRegisters(sel);
 	}
+	symbolModel->refreshColumn(SymbolTableModel::REGISTERS);
 	endTreeLabelsUpdate();
 	// notify change
 	emit symbolTableChanged();
@@ -592,160 +541,18 @@ void SymbolManager::changeType(bool /*checked*/)
 		newType = Symbol::VALUE;
 	}
 
-	// get selected items
-	QList<QTreeWidgetItem*> selection = treeLabels->selectedItems();
-
-	// update items
+	// update selected symbols
 	beginTreeLabelsUpdate();
-	for (auto* sel : selection) {
-		auto* sym = reinterpret_cast<Symbol*>(sel->data(0, Qt::UserRole).value<quintptr>());
+	for (auto* sym : selectedSymbols()) {
 		sym->setType(newType);
-		updateItemType(sel);
 	}
+	symbolModel->refreshColumn(SymbolTableModel::TYPE);
 	endTreeLabelsUpdate();
 	// notify change
 	emit symbolTableChanged();
 }
 
 
-/*
- * Symbol tree layout functions
- */
-
-void SymbolManager::updateItemName(QTreeWidgetItem* item)
-{
-	auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-	// set text and icon
-	item->setText(0, sym->text());
-	if (sym->source()) {
-		item->setIcon(0, QIcon(":/icons/symfil.png"));
-		item->setText(6, *sym->source());
-	} else {
-		item->setIcon(0, QIcon(":/icons/symman.png"));
-	}
-	// set color based on status as well as status in 2nd column
-	switch (sym->status()) {
-	case Symbol::HIDDEN:
-		item->setForeground(0, QColor(128, 128, 128));
-		break;
-	case Symbol::LOST:
-		item->setForeground(0, QColor(128, 0, 0));
-		break;
-	default:
-		break;
-	}
-}
-
-void SymbolManager::updateItemType(QTreeWidgetItem* item)
-{
-	auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-	// set symbol type in 2nd column
-	switch (sym->type()) {
-	case Symbol::JUMPLABEL:
-		item->setText(1, tr("Jump label"));
-		break;
-	case Symbol::VARIABLELABEL:
-		item->setText(1, tr("Variable label"));
-		break;
-	case Symbol::VALUE:
-		item->setText(1, tr("Value"));
-		break;
-	}
-}
-
-void SymbolManager::updateItemValue(QTreeWidgetItem* item)
-{
-	auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-
-	// symbol value in 3rd column
-	item->setText(2, hexValue(sym->value(), 4));
-}
-
-void SymbolManager::updateItemSlots(QTreeWidgetItem* item)
-{
-	auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-
-	QString slotText;
-	int slotmask = sym->validSlots();
-	// value represents 16 bits for 4 subslots in 4 slots
-	if (slotmask == 0xFFFF) {
-		slotText = tr("All");
-	} else if (slotmask == 0) {
-		slotText = tr("None");
-	} else {
-		// create a list of valid slots
-		// loop over all primary slots
-		for (int ps = 0; ps < 4; ++ps) {
-			QString subText;
-			int subslots = (slotmask >> (4 * ps)) & 15;
-			if (subslots == 15) {
-				// all subslots are ok
-				subText = QString("%1-*").arg(ps);
-			} else if (subslots) {
-				// some subslots are ok
-				if (subslots & 1) subText += "/0";
-				if (subslots & 2) subText += "/1";
-				if (subslots & 4) subText += "/2";
-				if (subslots & 8) subText += "/3";
-				subText = QString("%1-").arg(ps) + subText.mid(1);
-			}
-			// add to string if any subslots were ok
-			if (!subText.isEmpty()) {
-				if (!slotText.isEmpty()) slotText += ", ";
-				slotText += subText;
-			}
-		}
-	}
-
-	// valid slots in 4th column
-	item->setText(3, slotText);
-}
-
-void SymbolManager::updateItemSegments(QTreeWidgetItem* item)
-{
-	item->data(0, Qt::UserRole).value<quintptr>();
-}
-
-void SymbolManager::updateItemRegisters(QTreeWidgetItem* item)
-{
-	auto* sym = reinterpret_cast<Symbol*>(item->data(0, Qt::UserRole).value<quintptr>());
-
-	QString regText;
-	int regmask = sym->validRegisters();
-	// value represents 16 bits for 4 subslots in 4 slots
-	if (regmask == 0x3FFFF) {
-		regText = tr("All");
-	} else if (regmask == 0) {
-		regText = tr("None");
-	} else {
-		if ((regmask & Symbol::REG_ALL8) == Symbol::REG_ALL8) {
-			// all 8 bit registers selected
-			regText = "All 8 bit, ";
-			regmask ^= Symbol::REG_ALL8;
-		} else if ((regmask & Symbol::REG_ALL16) == Symbol::REG_ALL16) {
-			// all 16 bit registers selected
-			regText = "All 16 bit, ";
-			regmask ^= Symbol::REG_ALL16;
-		}
-		// register list for remaining registers
-		static const char* const registers[] = {
-			"A", "B", "C", "D", "E", "H", "L", "BC", "DE", "HL",
-		        "IX", "IY", "IXL", "IXH", "IYL", "IYH", "Offset", "I"
-		};
-		for (const char* reg : registers) {
-			if (regmask & 1) {
-				regText += QString("%1, ").arg(reg);
-			}
-			regmask >>= 1;
-		}
-		regText.chop(2);
-	}
-
-	// valid slots in 4th column
-	item->setText(5, regText);
-}
-
-
 // load of functions that shouldn't really be necessary
 void SymbolManager::changeSlot00(int state)
 {
@@ -3,8 +3,9 @@
 
 #include "ui_SymbolManager.h"
 
+class Symbol;
 class SymbolTable;
-class QTreeWidgetItem;
+class SymbolTableModel;
 
 class SymbolManager : public QDialog, private Ui::SymbolManager
 {
@@ -23,16 +24,7 @@ private:
 	void initFileList();
 	void createComboBox(int row);
 	void initSymbolList();
-
-	void closeEditor();
-
-	// formatting functions
-	void updateItemName(QTreeWidgetItem* item);
-	void updateItemType(QTreeWidgetItem* item);
-	void updateItemValue(QTreeWidgetItem* item);
-	void updateItemSlots(QTreeWidgetItem* item);
-	void updateItemSegments(QTreeWidgetItem* item);
-	void updateItemRegisters(QTreeWidgetItem* item);
+	QList<Symbol*> selectedSymbols() const;
 
 	void beginTreeLabelsUpdate();
 	void endTreeLabelsUpdate();
@@ -44,9 +36,9 @@ private:
 	void addSymbolFileDestination(int fileIndex, int validSlot);
 	void addLabel();
 	void removeLabel();
-	void labelEdit(QTreeWidgetItem* item, int column);
-	void labelChanged(QTreeWidgetItem* item, int column);
+	void labelChanged();
 	void labelSelectionChanged();
+	void filterChanged();
 	void changeType(bool checked);
 	void changeSlot(int id, int state);
 	void changeSlot00(int state);
@@ -88,11 +80,10 @@ private:
 
 private:
 	SymbolTable& symTable;
+	SymbolTableModel* symbolModel;
 	int treeLabelsUpdateCount;
 	QCheckBox* chkSlots[16];
 	QCheckBox* chkRegs[18];
-	QTreeWidgetItem* editItem;
-	int editColumn;
 };
 
 #endif // SYMBOLMANAGER_OPENMSX_H
@@ -6,6 +6,7 @@
 #include <QStringList>
 #include <QRegExp>
 #include <QFileInfo>
+#include <QDir>
 #include <QXmlStreamReader>
 #include <QXmlStreamWriter>
 #include <QMap>
@@ -51,6 +52,7 @@ std::unique_ptr<Symbol> SymbolTable::remove(Symbol* symbol)
 
 void SymbolTable::clear()
 {
+	labelsDirty = true;
 	addressSymbols.clear();
 	valueSymbols.clear();
 	symbols.clear();
@@ -61,8 +63,15 @@ int SymbolTable::size() const
 	return symbols.size();
 }
 
+Symbol* SymbolTable::symbolAt(int index) const
+{
+	assert(index >= 0 && size_t(index) < symbols.size());
+	return symbols[index].get();
+}
+
 void SymbolTable::mapSymbol(Symbol* symbol)
 {
+	labelsDirty = true;
 	if (symbol->type() != Symbol::VALUE) {
 		addressSymbols.insert(symbol->value(), symbol);
 	}
@@ -73,6 +82,7 @@ void SymbolTable::mapSymbol(Symbol* symbol)
 
 void SymbolTable::unmapSymbol(Symbol* symbol)
 {
+	labelsDirty = true;
 	QMutableMapIterator<int, Symbol*> i(addressSymbols);
 	while (i.hasNext()) {
 		i.next();
@@ -97,6 +107,23 @@ void SymbolTable::symbolValueChanged(Symbol* symbol)
 	mapSymbol(symbol);
 }
 
+void SymbolTable::symbolTextChanged(Symbol* /*symbol*/)
+{
+	labelsDirty = true;
+}
+
+const LabelIndex& SymbolTable::labelIndex() const
+{
+	if (labelsDirty) {
+		std::vector<Symbol*> list;
+		list.reserve(addressSymbols.size());
+		for (auto* sym : addressSymbols) list.push_back(sym);
+		labels.build(std::move(list));
+		labelsDirty = false;
+	}
+	return labels;
+}
+
 Symbol* SymbolTable::findFirstAddressSymbol(int addr, MemoryLayout* ml)
 {
 	for (currentAddress = addressSymbols.begin();
@@ -147,17 +174,25 @@ Symbol* SymbolTable::getAddressSymbol(int addr, MemoryLayout* ml)
 	return nullptr;
 }
 
-Symbol* SymbolTable::getAddressSymbol(const QString& label, bool case_sensitive)
+Symbol* SymbolTable::findEnclosingAddressSymbol(int addr, const MemoryLayout* ml) const
 {
-	for (auto it = addressSymbols.begin(); it != addressSymbols.end(); ++it) {
-		if (it.value()->text().compare(label, Qt::CaseSensitive)==0)
-			return it.value();
-		if (!case_sensitive && it.value()->text().compare(label, Qt::CaseInsensitive)==0)
-			return it.value();
+	auto it = addressSymbols.upperBound(addr);
+	while (it != addressSymbols.begin()) {
+		--it;
+		auto* sym = it.value();
+		if (sym->type() == Symbol::JUMPLABEL && sym->status() != Symbol::HIDDEN &&
+		    sym->isSlotValid(ml)) {
+			return sym;
+		}
 	}
 	return nullptr;
 }
 
+Symbol* SymbolTable::getAddressSymbol(const QString& label, bool case_sensitive)
+{
+	return labelIndex().find(label, case_sensitive);
+}
+
 QStringList SymbolTable::labelList(bool include_vars, const MemoryLayout* ml) const
 {
 	QStringList labels;
@@ -228,6 +263,12 @@ bool SymbolTable::readFile(const QString& filename, FileType type)
 			 * pasmo manpage in Debian -> pasmo [options]  file.asm file.bin [file.sys]
 			*/
 			type = PASMO_FILE;
+		} else if (fname.endsWith(".sld")) {
+			// sjasmplus source level debugging data
+			type = SLD_FILE;
+		} else if (fname.endsWith(".lst")) {
+			// sjasm/tniASM listing
+			type = LISTING_FILE;
 		}
 	}
 	switch (type) {
@@ -249,6 +290,10 @@ bool SymbolTable::readFile(const QString& filename, FileType type)
 		return readNoICEFile(filename);
 	case PASMO_FILE:
 		return readPASMOFile(filename);
+	case SLD_FILE:
+		return readSLDFile(filename);
+	case LISTING_FILE:
+		return readListingFile(filename);
 	default:
 		return false;
 	}
@@ -507,6 +552,74 @@ bool SymbolTable::readLinkMapFile(const QString& filename)
 	return true;
 }
 
+bool SymbolTable::readSLDFile(const QString& filename)
+{
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return false;
+	}
+	QTextStream in(&file);
+	if (!in.readLine().startsWith("|SLD.data.version|")) return false;
+
+	appendFile(filename, SLD_FILE);
+	const auto* source = &symbolFiles.back().fileName;
+
+	// source names are relative to where sjasmplus was started, which
+	// normally is the directory the sld file is written to
+	QDir dir = QFileInfo(filename).absoluteDir();
+	QString lastName, lastPath;
+
+	// <file>|<line>|<def file>|<def line>|<page>|<value>|<type>|<data>
+	while (!in.atEnd()) {
+		QString line = in.readLine();
+		if (line.startsWith('|')) continue; // comment
+		auto fields = line.splitRef('|');
+		// only trace records point at generated code
+		if (fields.size() < 7 || fields[6] != "T") continue;
+
+		// the line may be followed by a column range: line:col1:col2
+		auto lineField = fields[1].left(fields[1].indexOf(':'));
+		bool ok1, ok2, ok3;
+		int srcLine = lineField.toInt(&ok1);
+		int page = fields[4].toInt(&ok2);
+		int value = fields[5].toInt(&ok3);
+		if (!ok1 || !ok2 || !ok3 || srcLine < 1) continue;
+
+		if (fields[0] != lastName) {
+			lastName = fields[0].toString();
+			lastPath = QDir::cleanPath(dir.absoluteFilePath(lastName));
+		}
+		sources.add(source, lastPath, srcLine - 1, page, value & 0xFFFF);
+	}
+	return true;
+}
+
+bool SymbolTable::readListingFile(const QString& filename)
+{
+	// [line nr] [page:]address bytes source, e.g.
+	//   12+  8000 3E 01        ld a,1      (sjasmplus)
+	//   12.  01:8000 3E 01     ld a,1      (sjasm)
+	QRegExp rx("^\\s*(?:\\d+[+.:]*\\s+)?(?:([0-9A-Fa-f]{2}):)?([0-9A-Fa-f]{4})[: ]\\s*[0-9A-Fa-f]{2}(?:\\s|$)");
+
+	QFile file(filename);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return false;
+	}
+	appendFile(filename, LISTING_FILE);
+	const auto* source = &symbolFiles.back().fileName;
+
+	// the listing itself is the source shown for each address
+	QString path = QFileInfo(filename).absoluteFilePath();
+	QTextStream in(&file);
+	for (int lineNr = 0; !in.atEnd(); ++lineNr) {
+		QString line = in.readLine();
+		if (rx.indexIn(line) < 0) continue;
+		int page = rx.cap(1).isEmpty() ? -1 : rx.cap(1).toInt(nullptr, 16);
+		sources.add(source, path, lineNr, page, rx.cap(2).toInt(nullptr, 16));
+	}
+	return true;
+}
+
 void SymbolTable::fileChanged(const QString& path)
 {
 	emit symbolFileChanged();
@@ -575,6 +688,8 @@ void SymbolTable::unloadFile(const QString& file, bool keepSymbols)
 	}
 	if (index >= 0) {
 		QString* name = &symbolFiles[index].fileName;
+		labelsDirty = true;
+		sources.remove(name);
 
 		if (!keepSymbols) {
 			// remove symbols from address map
@@ -634,6 +749,12 @@ void SymbolTable::saveSymbols(QXmlStreamWriter& xml)
 		case LINKMAP_FILE:
 			xml.writeAttribute("type","linkmap");
 			break;
+		case SLD_FILE:
+			xml.writeAttribute("type","sld");
+			break;
+		case LISTING_FILE:
+			xml.writeAttribute("type","listing");
+			break;
 		default:
 			break;
 		}
@@ -696,6 +817,16 @@ void SymbolTable::loadSymbols(QXmlStreamReader& xml)
 					type = ASMSX_FILE;
 				} else if (ftype == "linkmap") {
 					type = LINKMAP_FILE;
+				} else if (ftype == "sld") {
+					type = SLD_FILE;
+				} else if (ftype == "listing") {
+					type = LISTING_FILE;
+				}
+				// source lines aren't stored in the session, read
+				// them from the file itself
+				if ((type == SLD_FILE || type == LISTING_FILE) &&
+				    readFile(fname, type)) {
+					continue;
 				}
 				// append file
 				appendFile(fname, type);
@@ -773,6 +904,14 @@ Symbol::Symbol(const Symbol& symbol)
 	symType      = symbol.symType;
 }
 
+void Symbol::setText(const QString& str)
+{
+	if (str == symText) return;
+
+	symText = str;
+	if (table) table->symbolTextChanged(this);
+}
+
 void Symbol::setValue(int addr)
 {
 	if (addr == symValue) return;
@@ -1,6 +1,8 @@
 #ifndef SYMBOLTABLE_H
 #define SYMBOLTABLE_H
 
+#include "LabelIndex.h"
+#include "SourceIndex.h"
 #include <QString>
 #include <QList>
 #include <QMultiMap>
@@ -43,7 +45,7 @@ public:
 	                REG_ALL = REG_ALL8 | REG_ALL16 };
 
 	[[nodiscard]] const QString& text() const { return symText; }
-	void setText(const QString& str) { symText = str; }
+	void setText(const QString& str);
 	[[nodiscard]] int value() const { return symValue; }
 	void setValue(int addr);
 	[[nodiscard]] uint16_t validSlots() const { return symSlots; }
@@ -89,7 +91,9 @@ public:
 		LINKMAP_FILE,
 		HTC_FILE,
 		NOICE_FILE,
-		PASMO_FILE
+		PASMO_FILE,
+		SLD_FILE,
+		LISTING_FILE
 	};
 
 	SymbolTable();
@@ -99,6 +103,7 @@ public:
 	std::unique_ptr<Symbol> remove(Symbol *symbol);
 	void clear();
 	[[nodiscard]] int size() const;
+	[[nodiscard]] Symbol* symbolAt(int index) const;
 
 	// xml session file functions
 	void saveSymbols(QXmlStreamWriter& xml);
@@ -111,11 +116,17 @@ public:
 	[[nodiscard]] Symbol* getValueSymbol(int val, Symbol::Register reg, MemoryLayout* ml = nullptr);
 	[[nodiscard]] Symbol* getAddressSymbol(int val, MemoryLayout* ml = nullptr);
 	[[nodiscard]] Symbol* getAddressSymbol(const QString& label, bool case_sensitive = false);
+	// the closest jump label at or before 'addr', i.e. the routine it is part of
+	[[nodiscard]] Symbol* findEnclosingAddressSymbol(int addr, const MemoryLayout* ml = nullptr) const;
 
 	[[nodiscard]] QStringList labelList(bool include_vars = false, const MemoryLayout* ml = nullptr) const;
+	[[nodiscard]] const LabelIndex& labelIndex() const;
+	// source lines from assembler debug files (sld, listing)
+	[[nodiscard]] const SourceIndex& sourceIndex() const { return sources; }
 
 	void symbolTypeChanged(Symbol* symbol);
 	void symbolValueChanged(Symbol* symbol);
+	void symbolTextChanged(Symbol* symbol);
 
 	[[nodiscard]] int symbolFilesSize() const;
 	[[nodiscard]] const QString& symbolFile(int index) const;
@@ -141,6 +152,8 @@ private:
 	bool readNoICEFile(const QString& filename);
 	bool readLinkMapFile(const QString& filename);
 	bool readPASMOFile(const QString& filename);
+	bool readSLDFile(const QString& filename);
+	bool readListingFile(const QString& filename);
 
 	void mapSymbol(Symbol* symbol);
 	void unmapSymbol(Symbol* symbol);
@@ -152,6 +165,10 @@ private:
 	QMultiMap<int, Symbol*> addressSymbols;
 	QMultiHash<int, Symbol*> valueSymbols;
 	QMultiMap<int, Symbol*>::iterator currentAddress;
+	// name index of the address symbols, rebuilt on first use after a change
+	mutable LabelIndex labels;
+	mutable bool labelsDirty = true;
+	SourceIndex sources;
 
 	struct SymbolFileRecord {
 		QString fileName;
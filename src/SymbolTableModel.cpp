@@ -0,0 +1,353 @@
+#include "SymbolTableModel.h"
+#include "SymbolTable.h"
+#include "Convert.h"
+#include <QColor>
+#include <QHash>
+#include <algorithm>
+
+SymbolTableModel::SymbolTableModel(SymbolTable& symtable, QObject* parent)
+	: QAbstractTableModel(parent), symTable(symtable)
+	, fileIcon(":/icons/symfil.png"), manualIcon(":/icons/symman.png")
+{
+	reload();
+}
+
+void SymbolTableModel::reload()
+{
+	beginResetModel();
+	allSymbols.clear();
+	allSymbols.reserve(symTable.size());
+	for (int i = 0; i < symTable.size(); ++i) {
+		allSymbols.push_back(symTable.symbolAt(i));
+	}
+	sortSymbols(allSymbols);
+	applyFilter(false);
+	endResetModel();
+}
+
+void SymbolTableModel::insertSymbol(Symbol* symbol)
+{
+	// keep both lists in sort order, the prefix search in applyFilter()
+	// depends on it
+	auto position = [&](std::vector<Symbol*>& list) {
+		if (sortColumn < 0) return list.end();
+		return std::upper_bound(list.begin(), list.end(), symbol,
+			[&](const Symbol* a, const Symbol* b) { return lessThan(a, b); });
+	};
+	allSymbols.insert(position(allSymbols), symbol);
+	if (!matches(symbol)) return;
+
+	auto it = position(rows);
+	int row = std::distance(rows.begin(), it);
+	beginInsertRows({}, row, row);
+	rows.insert(it, symbol);
+	endInsertRows();
+}
+
+void SymbolTableModel::refreshColumn(int column)
+{
+	if (rows.empty()) return;
+	emit dataChanged(index(0, column), index(rows.size() - 1, column));
+}
+
+void SymbolTableModel::setFilter(const QString& text, FilterMode mode)
+{
+	if (text == filterText && mode == filterMode) return;
+
+	// When the new filter is a refinement of the previous one it can only
+	// remove rows, so only the currently visible rows need to be checked.
+	bool narrowing = mode == filterMode &&
+		(mode == CONTAINS ? text.contains(filterText, Qt::CaseInsensitive)
+		                  : text.startsWith(filterText, Qt::CaseInsensitive));
+
+	beginResetModel();
+	filterText = text;
+	filterMode = mode;
+	applyFilter(narrowing);
+	endResetModel();
+}
+
+bool SymbolTableModel::matches(const Symbol* symbol) const
+{
+	if (filterMode == STARTS_WITH) {
+		return symbol->text().startsWith(filterText, Qt::CaseInsensitive);
+	}
+	return symbol->text().contains(filterText, Qt::CaseInsensitive);
+}
+
+void SymbolTableModel::applyFilter(bool narrowing)
+{
+	if (filterText.isEmpty()) {
+		rows = allSymbols;
+	} else if (narrowing) {
+		rows.erase(std::remove_if(rows.begin(), rows.end(),
+		                          [&](Symbol* s) { return !matches(s); }),
+		           rows.end());
+	} else if (filterMode == STARTS_WITH && sortColumn == NAME &&
+	           sortOrder == Qt::AscendingOrder) {
+		// all names with the same prefix form one block in the sorted list
+		auto first = std::lower_bound(allSymbols.begin(), allSymbols.end(), filterText,
+			[](const Symbol* s, const QString& t) {
+				return s->text().compare(t, Qt::CaseInsensitive) < 0;
+			});
+		auto last = std::find_if(first, allSymbols.end(),
+		                         [&](Symbol* s) { return !matches(s); });
+		rows.assign(first, last);
+	} else {
+		rows.clear();
+		std::copy_if(allSymbols.begin(), allSymbols.end(), std::back_inserter(rows),
+		             [&](Symbol* s) { return matches(s); });
+	}
+}
+
+bool SymbolTableModel::lessThan(const Symbol* a, const Symbol* b) const
+{
+	if (sortOrder == Qt::DescendingOrder) std::swap(a, b);
+	switch (sortColumn) {
+	case NAME:
+		return a->text().compare(b->text(), Qt::CaseInsensitive) < 0;
+	case TYPE:
+		return a->type() < b->type();
+	case VALUE:
+		return a->value() < b->value();
+	case SLOTS:
+		return a->validSlots() < b->validSlots();
+	case REGISTERS:
+		return a->validRegisters() < b->validRegisters();
+	case SOURCE: {
+		auto* sa = a->source();
+		auto* sb = b->source();
+		if (!sa || !sb) return sa == nullptr && sb != nullptr;
+		return sa->compare(*sb) < 0;
+	}
+	default:
+		return false;
+	}
+}
+
+void SymbolTableModel::sortSymbols(std::vector<Symbol*>& list) const
+{
+	if (sortColumn < 0) return;
+	std::stable_sort(list.begin(), list.end(),
+	                 [&](const Symbol* a, const Symbol* b) { return lessThan(a, b); });
+}
+
+void SymbolTableModel::sort(int column, Qt::SortOrder order)
+{
+	emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+	// remember which symbol each persistent index (selection, current item,
+	// open editor) refers to, so it can be moved along with the symbol
+	QModelIndexList oldIndices = persistentIndexList();
+	std::vector<Symbol*> oldSymbols;
+	oldSymbols.reserve(oldIndices.size());
+	for (const auto& idx : oldIndices) {
+		oldSymbols.push_back(symbolAt(idx));
+	}
+
+	sortColumn = column;
+	sortOrder = order;
+	sortSymbols(allSymbols);
+	sortSymbols(rows);
+
+	if (!oldIndices.empty()) {
+		QHash<const Symbol*, int> newRows;
+		newRows.reserve(rows.size());
+		for (size_t i = 0; i < rows.size(); ++i) {
+			newRows.insert(rows[i], int(i));
+		}
+		QModelIndexList newIndices;
+		newIndices.reserve(oldIndices.size());
+		for (int i = 0; i < oldIndices.size(); ++i) {
+			auto it = newRows.constFind(oldSymbols[i]);
+			newIndices.append(it == newRows.constEnd()
+			                  ? QModelIndex()
+			                  : index(*it, oldIndices[i].column()));
+		}
+		changePersistentIndexList(oldIndices, newIndices);
+	}
+
+	emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
+
+Symbol* SymbolTableModel::symbolAt(const QModelIndex& index) const
+{
+	if (!index.isValid() || index.row() >= int(rows.size())) return nullptr;
+	return rows[index.row()];
+}
+
+QModelIndex SymbolTableModel::indexOf(const Symbol* symbol, int column) const
+{
+	auto it = std::find(rows.begin(), rows.end(), symbol);
+	if (it == rows.end()) return {};
+	return index(std::distance(rows.begin(), it), column);
+}
+
+int SymbolTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : rows.size();
+}
+
+int SymbolTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant SymbolTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+
+	switch (section) {
+	case NAME:      return tr("Symbol");
+	case TYPE:      return tr("Type");
+	case VALUE:     return tr("Value");
+	case SLOTS:     return tr("Slots");
+	case SEGMENTS:  return tr("Segments");
+	case REGISTERS: return tr("Registers");
+	case SOURCE:    return tr("Source");
+	default:        return {};
+	}
+}
+
+Qt::ItemFlags SymbolTableModel::flags(const QModelIndex& index) const
+{
+	auto f = QAbstractTableModel::flags(index);
+	// only the name and value of manually added symbols are editable
+	if (auto* sym = symbolAt(index)) {
+		if (!sym->source() && (index.column() == NAME || index.column() == VALUE)) {
+			f |= Qt::ItemIsEditable;
+		}
+	}
+	return f;
+}
+
+QVariant SymbolTableModel::data(const QModelIndex& index, int role) const
+{
+	auto* sym = symbolAt(index);
+	if (!sym) return {};
+
+	switch (role) {
+	case Qt::DisplayRole:
+	case Qt::EditRole:
+		switch (index.column()) {
+		case NAME:      return sym->text();
+		case TYPE:      return typeText(sym);
+		case VALUE:     return hexValue(sym->value(), 4);
+		case SLOTS:     return slotText(sym);
+		case REGISTERS: return registerText(sym);
+		case SOURCE:    return sym->source() ? *sym->source() : QString();
+		default:        return {};
+		}
+	case Qt::DecorationRole:
+		if (index.column() != NAME) return {};
+		return sym->source() ? fileIcon : manualIcon;
+	case Qt::ForegroundRole:
+		if (index.column() != NAME) return {};
+		// set color based on status
+		switch (sym->status()) {
+		case Symbol::HIDDEN: return QColor(128, 128, 128);
+		case Symbol::LOST:   return QColor(128, 0, 0);
+		default:             return {};
+		}
+	default:
+		return {};
+	}
+}
+
+bool SymbolTableModel::setData(const QModelIndex& index, const QVariant& value, int role)
+{
+	auto* sym = symbolAt(index);
+	if (!sym || role != Qt::EditRole || sym->source()) return false;
+
+	if (index.column() == NAME) {
+		QString symText = value.toString().trimmed();
+		if (symText.isEmpty()) symText = "[unnamed]";
+		sym->setText(symText);
+	} else if (index.column() == VALUE) {
+		// TODO: proper decoding of value
+		auto v = stringToValue<uint16_t>(value.toString());
+		if (!v) return false;
+		sym->setValue(*v);
+	} else {
+		return false;
+	}
+	emit dataChanged(this->index(index.row(), 0), this->index(index.row(), COLUMN_COUNT - 1));
+	// the edited symbol may have to move, its row stays visible until the
+	// filter changes
+	if (index.column() == sortColumn) sort(sortColumn, sortOrder);
+	return true;
+}
+
+QString SymbolTableModel::typeText(const Symbol* symbol) const
+{
+	switch (symbol->type()) {
+	case Symbol::JUMPLABEL:     return tr("Jump label");
+	case Symbol::VARIABLELABEL: return tr("Variable label");
+	case Symbol::VALUE:         return tr("Value");
+	}
+	return {};
+}
+
+QString SymbolTableModel::slotText(const Symbol* symbol) const
+{
+	int slotmask = symbol->validSlots();
+	// value represents 16 bits for 4 subslots in 4 slots
+	if (slotmask == 0xFFFF) return tr("All");
+	if (slotmask == 0) return tr("None");
+
+	// create a list of valid slots
+	// loop over all primary slots
+	QString text;
+	for (int ps = 0; ps < 4; ++ps) {
+		QString subText;
+		int subslots = (slotmask >> (4 * ps)) & 15;
+		if (subslots == 15) {
+			// all subslots are ok
+			subText = QString("%1-*").arg(ps);
+		} else if (subslots) {
+			// some subslots are ok
+			if (subslots & 1) subText += "/0";
+			if (subslots & 2) subText += "/1";
+			if (subslots & 4) subText += "/2";
+			if (subslots & 8) subText += "/3";
+			subText = QString("%1-").arg(ps) + subText.mid(1);
+		}
+		// add to string if any subslots were ok
+		if (!subText.isEmpty()) {
+			if (!text.isEmpty()) text += ", ";
+			text += subText;
+		}
+	}
+	return text;
+}
+
+QString SymbolTableModel::registerText(const Symbol* symbol) const
+{
+	int regmask = symbol->validRegisters();
+	if (regmask == 0x3FFFF) return tr("All");
+	if (regmask == 0) return tr("None");
+
+	QString text;
+	if ((regmask & Symbol::REG_ALL8) == Symbol::REG_ALL8) {
+		// all 8 bit registers selected
+		text = "All 8 bit, ";
+		regmask ^= Symbol::REG_ALL8;
+	} else if ((regmask & Symbol::REG_ALL16) == Symbol::REG_ALL16) {
+		// all 16 bit registers selected
+		text = "All 16 bit, ";
+		regmask ^= Symbol::REG_ALL16;
+	}
+	// register list for remaining registers
+	static const char* const registers[] = {
+		"A", "B", "C", "D", "E", "H", "L", "BC", "DE", "HL",
+		"IX", "IY", "IXL", "IXH", "IYL", "IYH", "Offset", "I"
+	};
+	for (const char* reg : registers) {
+		if (regmask & 1) {
+			text += QString("%1, ").arg(reg);
+		}
+		regmask >>= 1;
+	}
+	text.chop(2);
+	return text;
+}
@@ -0,0 +1,71 @@
+#ifndef SYMBOLTABLEMODEL_H
+#define SYMBOLTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QIcon>
+#include <vector>
+
+class Symbol;
+class SymbolTable;
+
+/**
+ * Item model that exposes the symbols of a SymbolTable to a view without
+ * copying them. The model only keeps (sorted, filtered) lists of pointers
+ * into the table, so opening a view on a table with many thousands of
+ * symbols only costs a sort of those pointers.
+ */
+class SymbolTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Columns { NAME = 0, TYPE, VALUE, SLOTS, SEGMENTS, REGISTERS, SOURCE, COLUMN_COUNT };
+	enum FilterMode { CONTAINS = 0, STARTS_WITH };
+
+	SymbolTableModel(SymbolTable& symtable, QObject* parent = nullptr);
+
+	// rebuild the model after symbols were added to/removed from the table
+	void reload();
+	// add a single (new) symbol at its sorted position, it only gets a row
+	// when it passes the filter
+	void insertSymbol(Symbol* symbol);
+	// notify views that a column changed for all symbols
+	void refreshColumn(int column);
+
+	void setFilter(const QString& text, FilterMode mode);
+
+	[[nodiscard]] Symbol* symbolAt(const QModelIndex& index) const;
+	[[nodiscard]] QModelIndex indexOf(const Symbol* symbol, int column = NAME) const;
+
+	int rowCount(const QModelIndex& parent = {}) const override;
+	int columnCount(const QModelIndex& parent = {}) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+	Qt::ItemFlags flags(const QModelIndex& index) const override;
+	bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+	void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+private:
+	[[nodiscard]] bool matches(const Symbol* symbol) const;
+	void applyFilter(bool narrowing);
+	[[nodiscard]] bool lessThan(const Symbol* a, const Symbol* b) const;
+	void sortSymbols(std::vector<Symbol*>& list) const;
+
+	[[nodiscard]] QString typeText(const Symbol* symbol) const;
+	[[nodiscard]] QString slotText(const Symbol* symbol) const;
+	[[nodiscard]] QString registerText(const Symbol* symbol) const;
+
+private:
+	SymbolTable& symTable;
+	std::vector<Symbol*> allSymbols; // all symbols in sort order
+	std::vector<Symbol*> rows;       // the symbols that pass the filter
+
+	QString filterText;
+	FilterMode filterMode = CONTAINS;
+	int sortColumn = -1;
+	Qt::SortOrder sortOrder = Qt::AscendingOrder;
+
+	QIcon fileIcon;
+	QIcon manualIcon;
+};
+
+#endif // SYMBOLTABLEMODEL_H
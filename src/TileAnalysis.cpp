@@ -0,0 +1,91 @@
+#include "TileAnalysis.h"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+void TileAnalysis::analyze(const uint8_t* vram, const Settings& newSettings)
+{
+	settings = newSettings;
+	bool thirds = settings.screenMode == 2 || settings.screenMode == 4;
+	patternCount = thirds ? MAX_PATTERNS : 256;
+
+	countNames(vram);
+	findDuplicates(vram);
+	unused = int(std::count(counts, counts + patternCount, 0));
+}
+
+int TileAnalysis::nameCount(uint8_t name) const
+{
+	int total = 0;
+	for (int p = name; p < patternCount; p += 256) {
+		total += counts[p];
+	}
+	return total;
+}
+
+void TileAnalysis::countNames(const uint8_t* vram)
+{
+	std::fill_n(counts, MAX_PATTERNS, 0);
+
+	// In screen 2 and 4 each block of 256 names (8 rows) uses its own
+	// patterns, rows beyond the third block keep using the last one.
+	int total = settings.columns * settings.rows;
+	const uint8_t* names = vram + settings.nameTableAddress;
+	for (int start = 0; start < total; start += 256) {
+		int end = std::min(start + 256, total);
+		int* bank = counts + std::min(start, patternCount - 256);
+
+		// Four partial histograms: runs of the same name (very common)
+		// then don't have to wait for the previous increment.
+		int partial[4][256] = {};
+		int i = start;
+		for (; i + 4 <= end; i += 4) {
+			++partial[0][names[i + 0]];
+			++partial[1][names[i + 1]];
+			++partial[2][names[i + 2]];
+			++partial[3][names[i + 3]];
+		}
+		for (; i < end; ++i) ++partial[0][names[i]];
+		for (int n = 0; n < 256; ++n) {
+			bank[n] += partial[0][n] + partial[1][n] + partial[2][n] + partial[3][n];
+		}
+	}
+}
+
+void TileAnalysis::findDuplicates(const uint8_t* vram)
+{
+	// All 8 rows of a pattern, and of its colors, as one 64 bit word each
+	struct Cell {
+		uint64_t pattern;
+		uint64_t colors;
+		bool operator==(const Cell& other) const {
+			return pattern == other.pattern && colors == other.colors;
+		}
+	};
+	struct CellHash {
+		size_t operator()(const Cell& c) const {
+			return size_t((c.pattern * 0x9E3779B97F4A7C15ull) ^ (c.colors * 0xC2B2AE3D27D4EB4Full));
+		}
+	};
+
+	std::unordered_map<Cell, int16_t, CellHash> seen;
+	seen.reserve(patternCount);
+	duplicates = 0;
+	for (int p = 0; p < patternCount; ++p) {
+		Cell cell{0, 0};
+		memcpy(&cell.pattern, vram + settings.patternTableAddress + 8 * p, 8);
+		switch (settings.screenMode) {
+		case 1:
+			// one color byte per 8 patterns
+			cell.colors = vram[settings.colorTableAddress + (p >> 3)];
+			break;
+		case 2:
+		case 4:
+			memcpy(&cell.colors, vram + settings.colorTableAddress + 8 * p, 8);
+			break;
+		}
+		auto [it, inserted] = seen.try_emplace(cell, int16_t(p));
+		originals[p] = it->second;
+		if (!inserted) ++duplicates;
+	}
+}
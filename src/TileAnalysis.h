@@ -0,0 +1,56 @@
+#ifndef TILEANALYSIS_H
+#define TILEANALYSIS_H
+
+#include <cstdint>
+
+/**
+ * Usage statistics of the patterns of a tile based screen, gathered in one
+ * pass over the name table and one over the pattern and color tables: how
+ * often each pattern is used in the name table, which patterns are not
+ * used at all, and which patterns have the same 8x8 pattern and color
+ * data as a lower numbered one. In screen 2 and 4 every third of the
+ * screen has its own 256 patterns, they're numbered 0-767 here as in
+ * VramTiledView.
+ */
+class TileAnalysis
+{
+public:
+	static constexpr int MAX_PATTERNS = 768;
+
+	struct Settings {
+		int screenMode = 0; // as in VramTiledView, 0-4 and 80
+		unsigned nameTableAddress = 0;
+		unsigned patternTableAddress = 0;
+		unsigned colorTableAddress = 0;
+		int columns = 32;
+		int rows = 24;
+	};
+
+	void analyze(const uint8_t* vram, const Settings& settings);
+	void clear() { patternCount = 0; unused = 0; duplicates = 0; }
+
+	// 256, 768 in screen 2 and 4, 0 after clear()
+	[[nodiscard]] int patterns() const { return patternCount; }
+	// how often 'pattern' is in the name table
+	[[nodiscard]] int usage(int pattern) const { return counts[pattern]; }
+	// how often the byte 'name' is in the name table, over all thirds of the screen
+	[[nodiscard]] int nameCount(uint8_t name) const;
+	// the lowest numbered pattern with the same pattern and color data,
+	// 'pattern' itself when there is none
+	[[nodiscard]] int original(int pattern) const { return originals[pattern]; }
+	[[nodiscard]] int unusedCount() const { return unused; }
+	[[nodiscard]] int duplicateCount() const { return duplicates; }
+
+private:
+	void countNames(const uint8_t* vram);
+	void findDuplicates(const uint8_t* vram);
+
+	Settings settings;
+	int patternCount = 256;
+	int counts[MAX_PATTERNS] = {};
+	int16_t originals[MAX_PATTERNS] = {};
+	int unused = 0;
+	int duplicates = 0;
+};
+
+#endif // TILEANALYSIS_H
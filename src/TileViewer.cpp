@@ -2,9 +2,11 @@
 #include "ui_TileViewer.h"
 #include "VramTiledView.h"
 #include "VDPDataStore.h"
+#include "VDPLiveControl.h"
 #include "PaletteDialog.h"
 #include "Convert.h"
 #include <QMessageBox>
+#include <QStringList>
 
 
 static uint8_t currentPalette[32] = { 0 };
@@ -39,6 +41,7 @@ TileViewer::TileViewer(QWidget* parent)
 
     const QFont fixedFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
     plainTextEdit->setFont(fixedFont);
+    usageTextEdit->setFont(fixedFont);
     label_charpat->setFont(fixedFont);
     label_charadr->setFont(fixedFont);
 
@@ -47,6 +50,11 @@ TileViewer::TileViewer(QWidget* parent)
     // This allows the VDPDatastore to start asking for data as quickly as possible.
     connect(refreshButton, &QPushButton::clicked,
             &VDPDataStore::instance(), &VDPDataStore::refresh);
+    auto* liveControl = new VDPLiveControl();
+    liveControl->setCaptureSource([this] { return imageWidget->frame(); });
+    delete liveControl_widget->parentWidget()->layout()->replaceWidget(
+        liveControl_widget, liveControl);
+    delete liveControl_widget;
     connect(&VDPDataStore::instance(), &VDPDataStore::dataRefreshed,
             this, &TileViewer::VDPDataStoreDataRefreshed);
 
@@ -72,6 +80,8 @@ TileViewer::TileViewer(QWidget* parent)
             this, &TileViewer::imageMouseOver);
     connect(imageWidget, &VramTiledView::imageClicked,
             this, &TileViewer::displayCharInfo);
+    connect(imageWidget, &VramTiledView::analyzed,
+            this, &TileViewer::updateUsageInfo);
 
     VDPDataStore::instance().refresh();
 }
@@ -94,6 +104,43 @@ void TileViewer::highlightInfo(uint8_t character, int count)
                      : QString("%1 (%2 in nametabel)").arg(hexValue(character, 2)).arg(count));
 }
 
+// "00-1F 40 7E-FF", the patterns for which 'select' is true
+template<typename Select>
+static QString patternRanges(int count, Select select)
+{
+    QStringList ranges;
+    for (int p = 0; p < count; ++p) {
+        if (!select(p)) continue;
+        int first = p;
+        while (p + 1 < count && select(p + 1)) ++p;
+        ranges << (first == p ? hexValue(p, 2)
+                              : QString("%1-%2").arg(hexValue(first, 2), hexValue(p, 2)));
+    }
+    return ranges.join(' ');
+}
+
+void TileViewer::updateUsageInfo()
+{
+    const auto& analysis = imageWidget->getAnalysis();
+    int patterns = analysis.patterns();
+    if (patterns == 0) {
+        usageTextEdit->clear();
+        return;
+    }
+    QString text = QString("%1 of %2 patterns used, %3 with the same pattern and colors as a lower numbered one\n")
+        .arg(patterns - analysis.unusedCount()).arg(patterns).arg(analysis.duplicateCount());
+    text += "Unused: " + patternRanges(patterns, [&](int p) { return analysis.usage(p) == 0; }) + '\n';
+
+    QStringList duplicates;
+    for (int p = 0; p < patterns; ++p) {
+        int original = analysis.original(p);
+        if (original != p) duplicates << QString("%1=%2").arg(hexValue(p, 2), hexValue(original, 2));
+    }
+    text += "Duplicates: " + duplicates.join(' ');
+    // keeps the scroll position while nothing changes in live mode
+    if (text != usageTextEdit->toPlainText()) usageTextEdit->setPlainText(text);
+}
+
 void TileViewer::update_label_characterimage()
 {
     imageWidget->drawCharAtImage(mouseOverChar, mouseOverX, mouseOverY, image4label);
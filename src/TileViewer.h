@@ -39,6 +39,7 @@ private:
 
     void VDPDataStoreDataRefreshed();
     void highlightInfo(uint8_t character, int count);
+    void updateUsageInfo();
     void update_label_characterimage();
     void imageMouseOver(int screenX, int screenY, int character);
 
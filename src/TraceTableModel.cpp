@@ -0,0 +1,167 @@
+#include "TraceTableModel.h"
+#include "SymbolTable.h"
+#include "Convert.h"
+#include <algorithm>
+
+TraceTableModel::TraceTableModel(Tracer& tr, QObject* parent)
+	: QAbstractTableModel(parent), tracer(tr)
+{
+	connect(&tracer, &Tracer::recordsChanged, this, &TraceTableModel::recordsChanged);
+	reload();
+}
+
+void TraceTableModel::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+	reload();
+}
+
+void TraceTableModel::reload()
+{
+	beginResetModel();
+	rows.clear();
+	for (size_t i = 0; i < tracer.size(); ++i) {
+		const auto& r = tracer.record(i);
+		if (matches(r)) rows.push_back(r.sequence);
+	}
+	endResetModel();
+}
+
+void TraceTableModel::setFilter(const QString& text)
+{
+	if (text == filterText) return;
+
+	// a refinement of the previous filter can only remove rows
+	bool narrowing = text.contains(filterText, Qt::CaseInsensitive);
+	filterText = text;
+	if (!narrowing) {
+		reload();
+		return;
+	}
+	beginResetModel();
+	rows.erase(std::remove_if(rows.begin(), rows.end(),
+	                          [&](uint64_t seq) { return !matches(record(seq)); }),
+	           rows.end());
+	endResetModel();
+}
+
+void TraceTableModel::recordsChanged(size_t removed, size_t added)
+{
+	if (removed) {
+		// records are only dropped at the front, so are their rows
+		size_t count = rows.size();
+		if (tracer.size()) {
+			uint64_t first = tracer.record(0).sequence;
+			count = std::lower_bound(rows.begin(), rows.end(), first) - rows.begin();
+		}
+		if (count) {
+			beginRemoveRows({}, 0, count - 1);
+			rows.erase(rows.begin(), rows.begin() + count);
+			endRemoveRows();
+		}
+	}
+
+	std::vector<uint64_t> newRows;
+	size_t size = tracer.size();
+	for (size_t i = size - std::min(added, size); i < size; ++i) {
+		const auto& r = tracer.record(i);
+		if (matches(r)) newRows.push_back(r.sequence);
+	}
+	if (!newRows.empty()) {
+		beginInsertRows({}, rows.size(), rows.size() + newRows.size() - 1);
+		rows.insert(rows.end(), newRows.begin(), newRows.end());
+		endInsertRows();
+	}
+}
+
+const Tracer::Record& TraceTableModel::record(uint64_t sequence) const
+{
+	return tracer.record(sequence - tracer.record(0).sequence);
+}
+
+const Tracer::Record* TraceTableModel::recordAt(const QModelIndex& index) const
+{
+	if (!index.isValid() || index.row() >= int(rows.size())) return nullptr;
+	return &record(rows[index.row()]);
+}
+
+bool TraceTableModel::matches(const Tracer::Record& r) const
+{
+	if (filterText.isEmpty()) return true;
+	return tracepointText(r).contains(filterText, Qt::CaseInsensitive)
+	    || registerText(r).contains(filterText, Qt::CaseInsensitive)
+	    || memoryText(r).contains(filterText, Qt::CaseInsensitive);
+}
+
+QString TraceTableModel::tracepointText(const Tracer::Record& r) const
+{
+	uint16_t address = tracer.tracepoints()[r.tracepoint].address;
+	if (symTable) {
+		if (Symbol* s = symTable->getAddressSymbol(address)) return s->text();
+	}
+	return hexValue(address, 4);
+}
+
+QString TraceTableModel::registerText(const Tracer::Record& r) const
+{
+	const auto& names = tracer.tracepoints()[r.tracepoint].registers;
+	QStringList parts;
+	for (size_t i = 0; i < r.values.size(); ++i) {
+		const QString& name = names[i];
+		// 8 bit registers have single letter names, except for 'im'
+		int width = name.size() == 1 || name == "im" ? 2 : 4;
+		parts << QString("%1=%2").arg(name, hexValue(r.values[i], width));
+	}
+	return parts.join(' ');
+}
+
+QString TraceTableModel::memoryText(const Tracer::Record& r) const
+{
+	return QString::fromLatin1(r.memory.toHex(' ')).toUpper();
+}
+
+int TraceTableModel::rowCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : rows.size();
+}
+
+int TraceTableModel::columnCount(const QModelIndex& parent) const
+{
+	return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant TraceTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+	if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return {};
+
+	switch (section) {
+	case SEQUENCE:   return tr("#");
+	case TIME:       return tr("Time");
+	case TRACEPOINT: return tr("Tracepoint");
+	case PC:         return tr("PC");
+	case REGISTERS:  return tr("Registers");
+	case MEMORY:     return tr("Memory");
+	default:         return {};
+	}
+}
+
+QVariant TraceTableModel::data(const QModelIndex& index, int role) const
+{
+	const auto* r = recordAt(index);
+	if (!r) return {};
+
+	if (role == Qt::TextAlignmentRole && index.column() <= TIME) {
+		return int(Qt::AlignRight | Qt::AlignVCenter);
+	}
+	if (role != Qt::DisplayRole) return {};
+
+	switch (index.column()) {
+	case SEQUENCE:   return qulonglong(r->sequence);
+	case TIME:       return QString::number(r->time, 'f', 6);
+	case TRACEPOINT: return tracepointText(*r);
+	case PC:         return hexValue(r->pc, 4);
+	case REGISTERS:  return registerText(*r);
+	case MEMORY:     return memoryText(*r);
+	default:         return {};
+	}
+}
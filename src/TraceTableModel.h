@@ -0,0 +1,51 @@
+#ifndef TRACETABLEMODEL_H
+#define TRACETABLEMODEL_H
+
+#include "Tracer.h"
+#include <QAbstractTableModel>
+#include <vector>
+
+class SymbolTable;
+
+/**
+ * Item model on the records of a Tracer. Like SymbolTableModel it only keeps
+ * the (filtered) list of record sequence numbers, and text is only formatted
+ * for the rows a view actually shows, so views stay responsive with hundreds
+ * of thousands of records.
+ */
+class TraceTableModel : public QAbstractTableModel
+{
+	Q_OBJECT
+public:
+	enum Columns { SEQUENCE = 0, TIME, TRACEPOINT, PC, REGISTERS, MEMORY, COLUMN_COUNT };
+
+	TraceTableModel(Tracer& tracer, QObject* parent = nullptr);
+
+	void setSymbolTable(SymbolTable* st);
+	// rebuild the model, e.g. after symbols changed
+	void reload();
+	void setFilter(const QString& text);
+
+	[[nodiscard]] const Tracer::Record* recordAt(const QModelIndex& index) const;
+
+	int rowCount(const QModelIndex& parent = {}) const override;
+	int columnCount(const QModelIndex& parent = {}) const override;
+	QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+	QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+	void recordsChanged(size_t removed, size_t added);
+	[[nodiscard]] bool matches(const Tracer::Record& r) const;
+	[[nodiscard]] const Tracer::Record& record(uint64_t sequence) const;
+
+	[[nodiscard]] QString tracepointText(const Tracer::Record& r) const;
+	[[nodiscard]] QString registerText(const Tracer::Record& r) const;
+	[[nodiscard]] QString memoryText(const Tracer::Record& r) const;
+
+	Tracer& tracer;
+	SymbolTable* symTable = nullptr;
+	std::vector<uint64_t> rows; // sequence numbers of the records that pass the filter
+	QString filterText;
+};
+
+#endif // TRACETABLEMODEL_H
@@ -0,0 +1,216 @@
+#include "TraceViewer.h"
+#include "Tracer.h"
+#include "TraceTableModel.h"
+#include "SymbolTable.h"
+#include "SymbolCompleter.h"
+#include "Convert.h"
+#include <QCheckBox>
+#include <QFormLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListWidget>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTableView>
+#include <QVBoxLayout>
+
+TraceViewer::TraceViewer(QWidget* parent)
+	: QWidget(parent)
+{
+	addressEdit = new QLineEdit();
+	addressEdit->setPlaceholderText(tr("Label or address"));
+	conditionEdit = new QLineEdit();
+	conditionEdit->setPlaceholderText(tr("Tcl expression (optional)"));
+	registersEdit = new QLineEdit("af bc de hl");
+	registersEdit->setToolTip(tr("Registers to record, separated by spaces"));
+	memoryEdit = new QLineEdit();
+	memoryEdit->setPlaceholderText(tr("Register or address"));
+	memoryEdit->setToolTip(tr("Memory to record, from a register or a fixed address"));
+	memCountBox = new QSpinBox();
+	memCountBox->setRange(0, 16);
+	memCountBox->setSuffix(tr(" bytes"));
+	addButton = new QPushButton(tr("Add"));
+	removeButton = new QPushButton(tr("Remove"));
+	tracepointList = new QListWidget();
+	tracepointList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+
+	startButton = new QPushButton(tr("Start"));
+	clearButton = new QPushButton(tr("Clear"));
+	followBox = new QCheckBox(tr("Follow"));
+	followBox->setToolTip(tr("Keep the newest record in view"));
+	followBox->setChecked(true);
+	filterEdit = new QLineEdit();
+	filterEdit->setPlaceholderText(tr("Filter"));
+	filterEdit->setClearButtonEnabled(true);
+	statusLabel = new QLabel();
+
+	table = new QTableView();
+	table->verticalHeader()->hide();
+	// fixed row heights, so the view never measures all rows
+	table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+	table->verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 2);
+	table->horizontalHeader()->setStretchLastSection(true);
+	table->setSelectionBehavior(QAbstractItemView::SelectRows);
+	table->setWordWrap(false);
+
+	auto* form = new QFormLayout();
+	form->setMargin(0);
+	form->addRow(tr("Address"), addressEdit);
+	form->addRow(tr("Condition"), conditionEdit);
+	form->addRow(tr("Registers"), registersEdit);
+	auto* mhbox = new QHBoxLayout();
+	mhbox->setMargin(0);
+	mhbox->addWidget(memoryEdit, 1);
+	mhbox->addWidget(memCountBox);
+	form->addRow(tr("Memory"), mhbox);
+
+	auto* lhbox = new QHBoxLayout();
+	lhbox->setMargin(0);
+	lhbox->addWidget(addButton);
+	lhbox->addWidget(removeButton);
+
+	auto* listBox = new QWidget();
+	auto* lvbox = new QVBoxLayout();
+	lvbox->setMargin(0);
+	lvbox->addLayout(form);
+	lvbox->addLayout(lhbox);
+	lvbox->addWidget(tracepointList);
+	listBox->setLayout(lvbox);
+
+	auto* splitter = new QSplitter(Qt::Horizontal);
+	splitter->addWidget(listBox);
+	splitter->addWidget(table);
+	splitter->setStretchFactor(1, 1);
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(startButton);
+	hbox->addWidget(clearButton);
+	hbox->addWidget(followBox);
+	hbox->addWidget(filterEdit, 1);
+	hbox->addWidget(statusLabel);
+
+	auto* vbox = new QVBoxLayout();
+	vbox->setMargin(0);
+	vbox->addLayout(hbox);
+	vbox->addWidget(splitter);
+	setLayout(vbox);
+
+	connect(addressEdit, &QLineEdit::returnPressed, this, &TraceViewer::addTracepoint);
+	connect(addButton, &QPushButton::clicked, this, &TraceViewer::addTracepoint);
+	connect(removeButton, &QPushButton::clicked, this, &TraceViewer::removeTracepoints);
+	connect(startButton, &QPushButton::clicked, this, &TraceViewer::startStop);
+	connect(table, &QTableView::doubleClicked, this, &TraceViewer::rowActivated);
+}
+
+void TraceViewer::setTracer(Tracer* t)
+{
+	tracer = t;
+	model = new TraceTableModel(*tracer, this);
+	table->setModel(model);
+	table->resizeColumnsToContents();
+
+	connect(clearButton, &QPushButton::clicked, tracer, &Tracer::clear);
+	connect(filterEdit, &QLineEdit::textChanged, model, &TraceTableModel::setFilter);
+	connect(tracer, &Tracer::runningChanged, this, &TraceViewer::runningChanged);
+	connect(tracer, &Tracer::recordsChanged, this, &TraceViewer::recordsChanged);
+}
+
+void TraceViewer::setSymbolTable(SymbolTable* st)
+{
+	symTable = st;
+	if (model) model->setSymbolTable(symTable);
+
+	auto* completer = new SymbolCompleter(*symTable, false, nullptr, this);
+	addressEdit->setCompleter(completer);
+	connect(addressEdit, &QLineEdit::textEdited, completer, &SymbolCompleter::update);
+}
+
+void TraceViewer::symbolsChanged()
+{
+	if (model) model->reload();
+}
+
+void TraceViewer::addTracepoint()
+{
+	QString text = addressEdit->text().trimmed();
+	auto addr = stringToValue<uint16_t>(text);
+	QString name = addr ? hexValue(*addr, 4) : text;
+	if (!addr && symTable) {
+		if (Symbol* s = symTable->getAddressSymbol(text)) {
+			addr = s->value();
+			name = s->text();
+		}
+	}
+	if (!addr) return;
+
+	Tracer::Tracepoint tp;
+	tp.address = *addr;
+	tp.condition = conditionEdit->text().trimmed();
+	tp.registers = registersEdit->text().toLower().split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+	tp.memAddress = memoryEdit->text().trimmed().toLower();
+	tp.memCount = tp.memAddress.isEmpty() ? 0 : memCountBox->value();
+	tp.active = true;
+	// the names and the address are passed on to Tcl, reject anything else
+	for (const auto& r : tp.registers) {
+		if (!Tracer::isRegister(r)) {
+			registersEdit->setFocus();
+			return;
+		}
+	}
+	if (!tp.memAddress.isEmpty() && !stringToValue<uint16_t>(tp.memAddress) &&
+	    !Tracer::isRegister(tp.memAddress)) {
+		memoryEdit->setFocus();
+		return;
+	}
+	int index = tracer->addTracepoint(tp);
+
+	QString description = name;
+	if (!tp.condition.isEmpty()) description += tr(" if %1").arg(tp.condition);
+	if (!tp.registers.isEmpty()) description += ": " + tp.registers.join(' ');
+	if (tp.memCount) description += QString(" (%1)x%2").arg(tp.memAddress).arg(tp.memCount);
+	auto* item = new QListWidgetItem(description);
+	item->setData(Qt::UserRole, index);
+	tracepointList->addItem(item);
+	addressEdit->clear();
+}
+
+void TraceViewer::removeTracepoints()
+{
+	for (auto* item : tracepointList->selectedItems()) {
+		tracer->removeTracepoint(item->data(Qt::UserRole).toInt());
+		delete item;
+	}
+}
+
+void TraceViewer::startStop()
+{
+	if (tracer->isRunning()) {
+		tracer->stop();
+	} else {
+		tracer->start();
+	}
+}
+
+void TraceViewer::runningChanged(bool running)
+{
+	startButton->setText(running ? tr("Stop") : tr("Start"));
+}
+
+void TraceViewer::recordsChanged()
+{
+	QString status = tr("%1 records").arg(tracer->size());
+	if (tracer->lostRecords()) status += tr(", %1 lost").arg(tracer->lostRecords());
+	statusLabel->setText(status);
+	if (followBox->isChecked()) table->scrollToBottom();
+}
+
+void TraceViewer::rowActivated(const QModelIndex& index)
+{
+	if (const auto* r = model->recordAt(index)) {
+		emit addressSelected(r->pc);
+	}
+}
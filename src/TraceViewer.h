@@ -0,0 +1,66 @@
+#ifndef TRACEVIEWER_H
+#define TRACEVIEWER_H
+
+#include <QWidget>
+#include <cstdint>
+
+class Tracer;
+class TraceTableModel;
+class SymbolTable;
+class QCheckBox;
+class QLabel;
+class QLineEdit;
+class QListWidget;
+class QModelIndex;
+class QPushButton;
+class QSpinBox;
+class QTableView;
+
+/**
+ * Editor for the tracepoints and a filterable table of the records they
+ * collected.
+ */
+class TraceViewer : public QWidget
+{
+	Q_OBJECT
+public:
+	TraceViewer(QWidget* parent = nullptr);
+
+	void setTracer(Tracer* tracer);
+	void setSymbolTable(SymbolTable* st);
+
+	void symbolsChanged();
+
+signals:
+	void addressSelected(uint16_t addr);
+
+private:
+	void addTracepoint();
+	void removeTracepoints();
+	void startStop();
+	void runningChanged(bool running);
+	void recordsChanged();
+	void rowActivated(const QModelIndex& index);
+
+	QLineEdit* addressEdit;
+	QLineEdit* conditionEdit;
+	QLineEdit* registersEdit;
+	QLineEdit* memoryEdit;
+	QSpinBox* memCountBox;
+	QPushButton* addButton;
+	QPushButton* removeButton;
+	QListWidget* tracepointList;
+
+	QPushButton* startButton;
+	QPushButton* clearButton;
+	QCheckBox* followBox;
+	QLineEdit* filterEdit;
+	QLabel* statusLabel;
+	QTableView* table;
+
+	Tracer* tracer = nullptr;
+	TraceTableModel* model = nullptr;
+	SymbolTable* symTable = nullptr;
+};
+
+#endif // TRACEVIEWER_H
@@ -0,0 +1,135 @@
+#include "Tracer.h"
+#include "OpenMSXConnection.h"
+#include "CommClient.h"
+#include "Convert.h"
+#include <QRegExp>
+#include <algorithm>
+
+Tracer::Tracer(QObject* parent)
+	: PolledCollector("trace", 1000, parent)
+{
+}
+
+bool Tracer::isRegister(const QString& name)
+{
+	static const QStringList names = {
+		"a", "f", "b", "c", "d", "e", "h", "l",
+		"a2", "f2", "b2", "c2", "d2", "e2", "h2", "l2",
+		"ixh", "ixl", "iyh", "iyl", "pch", "pcl", "sph", "spl",
+		"i", "r", "im", "iff",
+		"af", "bc", "de", "hl", "af2", "bc2", "de2", "hl2",
+		"ix", "iy", "pc", "sp"
+	};
+	return names.contains(name);
+}
+
+int Tracer::addTracepoint(const Tracepoint& tp)
+{
+	int index = points.size();
+	points.push_back(tp);
+	auto& added = points.back();
+	added.active = true;
+	// they end up in Tcl, see sendAdd(), and the records must have a field
+	// for every register that is kept
+	added.registers.erase(std::remove_if(added.registers.begin(), added.registers.end(),
+	                                     [](const QString& r) { return !isRegister(r); }),
+	                      added.registers.end());
+	if (!stringToValue<uint16_t>(added.memAddress) && !isRegister(added.memAddress.trimmed())) {
+		added.memAddress.clear();
+		added.memCount = 0;
+	}
+	if (isRunning()) sendAdd(index);
+	return index;
+}
+
+void Tracer::removeTracepoint(int index)
+{
+	if (index < 0 || index >= int(points.size()) || !points[index].active) return;
+	points[index].active = false;
+	if (isRunning()) {
+		CommClient::instance().sendCommand(new SimpleCommand(
+			QString("debug_trace_remove %1").arg(index)));
+	}
+}
+
+void Tracer::sendAdd(int index)
+{
+	const auto& tp = points[index];
+	// the memory address is evaluated when the tracepoint hits,
+	// addTracepoint() only kept register names and numbers
+	QString mem = tp.memAddress.trimmed();
+	if (mem.isEmpty() || tp.memCount <= 0) {
+		mem = "0";
+	} else if (auto addr = stringToValue<uint16_t>(mem)) {
+		mem = QString::number(*addr);
+	} else {
+		mem = QString("[reg %1]").arg(mem);
+	}
+	QString cond = tp.condition.trimmed();
+	CommClient::instance().sendCommand(new SimpleCommand(
+		QString("debug_trace_add %1 %2 %3 {%4} {%5} %6")
+			.arg(index)
+			.arg(tp.address)
+			.arg(escapeXML(cond.isEmpty() ? QString("{}") : QString("{%1}").arg(cond)))
+			.arg(tp.registers.join(' '))
+			.arg(mem)
+			.arg(mem == "0" ? 0 : tp.memCount)));
+}
+
+void Tracer::start()
+{
+	if (isRunning()) return;
+	startCollecting(QString::number(BUFFER_SIZE));
+	for (size_t i = 0; i < points.size(); ++i) {
+		if (points[i].active) sendAdd(i);
+	}
+}
+
+void Tracer::clear()
+{
+	size_t removed = records.size();
+	records.clear();
+	lost = 0;
+	emit recordsChanged(removed, 0);
+}
+
+void Tracer::processReply(const QString& message)
+{
+	// "lost {index time pc value .. ?hex?} ..."
+	bool ok;
+	lost += message.section(' ', 0, 0).toULongLong(&ok);
+	if (!ok) return;
+
+	QRegExp rx("\\{([^}]*)\\}");
+	size_t added = 0;
+	for (int pos = 0; (pos = rx.indexIn(message, pos)) != -1; pos += rx.matchedLength()) {
+		auto fields = rx.cap(1).split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+		if (fields.size() < 3) continue;
+		int index = fields[0].toInt();
+		if (index < 0 || index >= int(points.size())) continue;
+		const auto& tp = points[index];
+		int nregs = tp.registers.size();
+		bool hasMemory = !tp.memAddress.trimmed().isEmpty() && tp.memCount > 0;
+		if (fields.size() != 3 + nregs + (hasMemory ? 1 : 0)) continue;
+
+		Record r;
+		r.sequence = nextSequence++;
+		r.time = fields[1].toDouble();
+		r.tracepoint = index;
+		r.pc = fields[2].toUShort();
+		r.values.reserve(nregs);
+		for (int i = 0; i < nregs; ++i) {
+			r.values.push_back(fields[3 + i].toUShort());
+		}
+		if (hasMemory) r.memory = QByteArray::fromHex(fields.last().toLatin1());
+		records.push_back(std::move(r));
+		++added;
+	}
+
+	size_t removed = 0;
+	while (records.size() > CAPACITY) {
+		records.pop_front();
+		++removed;
+	}
+	if (added || removed) emit recordsChanged(removed, added);
+}
@@ -0,0 +1,74 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include "PolledCollector.h"
+#include <QStringList>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/**
+ * Tracepoints: breakpoints that don't stop the emulation but append a record
+ * (the emulated time, PC, a selection of registers and a few memory bytes) to
+ * a ring buffer in openMSX. The debugger drains that buffer in bulk, once per
+ * second while running and when the emulation breaks, and keeps the most
+ * recent records.
+ */
+class Tracer : public PolledCollector
+{
+	Q_OBJECT
+public:
+	struct Tracepoint {
+		uint16_t address;
+		QString condition;
+		QStringList registers; // names as understood by the 'reg' command
+		QString memAddress;    // register name or address, empty for none
+		int memCount;
+		bool active;
+	};
+
+	struct Record {
+		uint64_t sequence;
+		double time;
+		uint16_t tracepoint;
+		uint16_t pc;
+		std::vector<uint16_t> values; // one per register of the tracepoint
+		QByteArray memory;
+	};
+
+	// records kept in openMSX between two fetches / in the debugger
+	static constexpr int BUFFER_SIZE = 65536;
+	static constexpr size_t CAPACITY = 1000000;
+
+	Tracer(QObject* parent = nullptr);
+
+	// whether 'name' (lower case) is a register name of the 'reg' command
+	[[nodiscard]] static bool isRegister(const QString& name);
+
+	// returns the index of the new tracepoint
+	int addTracepoint(const Tracepoint& tp);
+	void removeTracepoint(int index);
+	[[nodiscard]] const std::vector<Tracepoint>& tracepoints() const { return points; }
+
+	void start();
+	void clear();
+
+	[[nodiscard]] size_t size() const { return records.size(); }
+	[[nodiscard]] const Record& record(size_t i) const { return records[i]; }
+	[[nodiscard]] uint64_t lostRecords() const { return lost; }
+
+signals:
+	// 'removed' records were dropped at the front, 'added' appended
+	void recordsChanged(size_t removed, size_t added);
+
+private:
+	void sendAdd(int index);
+	void processReply(const QString& message) override;
+
+	std::vector<Tracepoint> points; // removed ones stay, records refer to them
+	std::deque<Record> records;
+	uint64_t nextSequence = 0;
+	uint64_t lost = 0;
+};
+
+#endif // TRACER_H
@@ -1,5 +1,7 @@
 #include "VDPDataStore.h"
 #include "CommClient.h"
+#include "VramWriteMap.h"
+#include <algorithm>
 
 // static vector to feed PaletteDialog and be used when VDP colors aren't selected
 static const uint8_t defaultPalette[32] = {
@@ -110,8 +112,14 @@ static constexpr unsigned MAX_TOTAL_SIZE = MAX_VRAM_SIZE + 32 + 16 + 64 + 2 + 3
 
 VDPDataStore::VDPDataStore()
 	: vram(MAX_TOTAL_SIZE)
+	, incoming(MAX_TOTAL_SIZE)
 {
-	CommClient::instance().sendCommand(new VDPDataStoreVersionCheck(*this));
+	liveTimer.setSingleShot(true);
+	connect(&liveTimer, &QTimer::timeout, this, &VDPDataStore::liveRefresh);
+	auto& comm = CommClient::instance();
+	connect(&comm, &CommClient::updateParsed, this, &VDPDataStore::statusUpdate);
+	connect(&comm, &CommClient::connectionTerminated, this, [this] { setLive(false); });
+	comm.sendCommand(new VDPDataStoreVersionCheck(*this));
 }
 
 VDPDataStore& VDPDataStore::instance()
@@ -132,6 +140,59 @@ void VDPDataStore::refresh()
 	}
 }
 
+void VDPDataStore::setLive(bool enabled)
+{
+	if (live == enabled) return;
+	live = enabled;
+	skippedFrames = 0;
+	if (live) {
+		if (!requesting) liveRefresh();
+	} else {
+		liveTimer.stop();
+	}
+	emit liveChanged(live);
+}
+
+void VDPDataStore::setLiveRate(int fps)
+{
+	liveRate = std::clamp(fps, 1, 60);
+}
+
+void VDPDataStore::liveRefresh()
+{
+	// the VDP doesn't change while the CPU is in break
+	if (!live || requesting || !cpuRunning) return;
+	if (!debuggableNameVRAM || recheck) {
+		recheck = false;
+		refresh();
+	} else if (VramWriteMap::instance().isRunning()) {
+		refreshWritten();
+	} else {
+		refresh3();
+	}
+}
+
+void VDPDataStore::scheduleLiveRefresh()
+{
+	// The time between the request and the viewers having decoded the
+	// reply decides in which frame the next request can go out.
+	qint64 busy = requestTime.elapsed();
+	refreshTime = refreshTime == 0.0f ? float(busy) : 0.8f * refreshTime + 0.2f * float(busy);
+	qint64 frame = 1000 / liveRate;
+	qint64 frames = std::max<qint64>(1, (busy + frame - 1) / frame);
+	skippedFrames += unsigned(frames - 1);
+	liveTimer.start(int(frames * frame - busy));
+}
+
+void VDPDataStore::statusUpdate(const QString& type, const QString& name, const QString& message)
+{
+	if (type != "status" || name != "cpu") return;
+	cpuRunning = message != "suspended";
+	if (live && cpuRunning && !requesting && !liveTimer.isActive()) {
+		liveRefresh();
+	}
+}
+
 void VDPDataStore::refresh1()
 {
 	CommClient::instance().sendCommand(new VDPDataStoreVRAMSizeCheck(*this));
@@ -142,11 +203,9 @@ void VDPDataStore::refresh2()
 	CommClient::instance().sendCommand(new VDPDataStoreDebuggableChecks(*this));
 }
 
-void VDPDataStore::refresh3()
+QString VDPDataStore::registersRequest() const
 {
-	QString req = QString(
-		"debug_bin2hex "
-		"[debug read_block {" + QString::fromStdString(*debuggableNameVRAM) + "} 0 " + QString::number(vramSize) + "]"
+	return QString(
 		"[debug read_block {VDP palette} 0 32]"
 		"[debug read_block {VDP status regs} 0 16]"
 		"[debug read_block {VDP regs} 0 64]"
@@ -155,15 +214,93 @@ void VDPDataStore::refresh3()
 		.arg(paletteLatchAvailable ? "[debug read_block {VDP palette latch status} 0 1]" : "")
 		.arg(dataLatchAvailable ? "[debug read_block {VDP data latch value} 0 1]" : "")
 		.arg(vramAccessStatusAvailable ? "[debug read_block {VRAM access status} 0 1]" : "");
+}
 
-	int total = MAX_TOTAL_SIZE - MAX_VRAM_SIZE + vramSize - !registerLatchAvailable
+size_t VDPDataStore::registersSize() const
+{
+	return MAX_TOTAL_SIZE - MAX_VRAM_SIZE - !registerLatchAvailable
 		- !paletteLatchAvailable - !dataLatchAvailable - !vramAccessStatusAvailable;
-	new SimpleHexRequest(req, total, &vram[0], *this);
+}
+
+void VDPDataStore::refresh3()
+{
+	QString req = "debug_bin2hex "
+		"[debug read_block {" + QString::fromStdString(*debuggableNameVRAM) + "} 0 " + QString::number(vramSize) + "]"
+		+ registersRequest();
+
+	int total = int(vramSize + registersSize());
+	requesting = true;
+	requestTime.start();
+	new SimpleHexRequest(req, total, &incoming[0], *this);
 }
 
 void VDPDataStore::DataHexRequestReceived()
 {
+	// Viewers keep pointers into 'vram', so the complete reply is copied
+	// instead of swapping the buffers. A reply never lands in the data
+	// the viewers are decoding.
+	requesting = false;
+	std::copy(incoming.begin(), incoming.end(), vram.begin());
 	emit dataRefreshed();
+	if (live) scheduleLiveRefresh();
+}
+
+void VDPDataStore::refreshWritten()
+{
+	// only the VRAM blocks written since the previous request, see VramWriteMap
+	QString req = QString("debug_vwrite_read {%1} %2 [debug_bin2hex %3]")
+		.arg(QString::fromStdString(*debuggableNameVRAM))
+		.arg(vramSize)
+		.arg(registersRequest());
+	requesting = true;
+	requestTime.start();
+	auto* command = new Command(req,
+		[this](const QString& message) { writtenReceived(message); },
+		[this](const QString& /*error*/) { DataHexRequestCanceled(); });
+	CommClient::instance().sendCommand(command);
+}
+
+void VDPDataStore::writtenReceived(const QString& message)
+{
+	// "all <hex>" after a VDP command, else "{block ...} <hex>"
+	int split = message.lastIndexOf(' ');
+	QString blocks = message.left(split).remove('{').remove('}');
+	QByteArray data = QByteArray::fromHex(message.mid(split + 1).toLatin1());
+	size_t tail = registersSize();
+
+	if (blocks == "all") {
+		if (size_t(data.size()) != vramSize + tail) {
+			DataHexRequestCanceled();
+			return;
+		}
+		std::copy(data.begin(), data.end(), incoming.begin());
+	} else {
+		auto list = blocks.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts);
+		constexpr size_t BLOCK_SIZE = 1 << VramWriteMap::BLOCK_SHIFT;
+		if (size_t(data.size()) != list.size() * BLOCK_SIZE + tail) {
+			DataHexRequestCanceled();
+			return;
+		}
+		// 'incoming' still holds the previous snapshot
+		auto src = data.begin();
+		for (const auto& block : list) {
+			size_t address = block.toUInt() << VramWriteMap::BLOCK_SHIFT;
+			if (address + BLOCK_SIZE <= vramSize) {
+				std::copy_n(src, BLOCK_SIZE, incoming.begin() + address);
+			}
+			src += BLOCK_SIZE;
+		}
+		std::copy(src, data.end(), incoming.begin() + vramSize);
+	}
+	DataHexRequestReceived();
+}
+
+void VDPDataStore::DataHexRequestCanceled()
+{
+	// maybe the VRAM size changed (other machine), check again
+	requesting = false;
+	recheck = true;
+	if (live) liveTimer.start(1000 / liveRate);
 }
 
 const uint8_t* VDPDataStore::getVramPointer() const
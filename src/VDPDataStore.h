@@ -2,7 +2,9 @@
 #define VDPDATASTORE_H
 
 #include "SimpleHexRequest.h"
+#include <QElapsedTimer>
 #include <QObject>
+#include <QTimer>
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -30,8 +32,21 @@ public:
 
 	void refresh();
 
+	// Live mode refreshes at most 'rate' times per second while the
+	// emulation runs. When a refresh (transfer plus decoding by the
+	// viewers) takes longer than a frame, the frames in between are
+	// skipped instead of queueing requests. While the VramWriteMap runs
+	// only the written parts of VRAM are transferred.
+	void setLive(bool enabled);
+	void setLiveRate(int fps);
+	bool isLive() const { return live; }
+	int getLiveRate() const { return liveRate; }
+	unsigned getSkippedFrames() const { return skippedFrames; }
+	float getRefreshTime() const { return refreshTime; } // in ms, averaged
+
 signals:
         void dataRefreshed(); // The refresh got the new data
+	void liveChanged(bool live);
 
 	/** This might become handy later on, for now we only need the dataRefreshed
 	 *
@@ -46,13 +61,22 @@ private:
 	VDPDataStore();
 
 	void DataHexRequestReceived() override;
+	void DataHexRequestCanceled() override;
+	void liveRefresh();
+	void refreshWritten();
+	void writtenReceived(const QString& message);
+	void scheduleLiveRefresh();
+	void statusUpdate(const QString& type, const QString& name, const QString& message);
 
 	void refresh1();
 	void refresh2();
 	void refresh3();
+	QString registersRequest() const;
+	size_t registersSize() const;
 
 private:
 	std::vector<uint8_t> vram;
+	std::vector<uint8_t> incoming; // requests write here, copied to 'vram' when complete
 	size_t vramSize;
 
 	std::optional<std::string> debuggableNameVRAM; // VRAM debuggable name
@@ -62,6 +86,16 @@ private:
 	bool dataLatchAvailable = false;
 	bool vramAccessStatusAvailable = false;
 
+	QTimer liveTimer;
+	QElapsedTimer requestTime;
+	bool live = false;
+	bool requesting = false;
+	bool recheck = false;    // redo the VRAM size checks before the next live refresh
+	bool cpuRunning = true;
+	int liveRate = 50;
+	unsigned skippedFrames = 0;
+	float refreshTime = 0.0f;
+
 	friend class VDPDataStoreVersionCheck;
 	friend class VDPDataStoreDebuggableChecks;
 	friend class VDPDataStoreVRAMSizeCheck;
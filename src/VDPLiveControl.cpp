@@ -0,0 +1,133 @@
+#include "VDPLiveControl.h"
+#include "VDPDataStore.h"
+#include "VramWriteMap.h"
+#include <QCheckBox>
+#include <QFileDialog>
+#include <QHBoxLayout>
+#include <QInputDialog>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+
+VDPLiveControl::VDPLiveControl(QWidget* parent)
+	: QWidget(parent)
+{
+	auto& dataStore = VDPDataStore::instance();
+
+	liveBox = new QCheckBox(tr("Live"));
+	liveBox->setToolTip(tr("Keep taking VRAM snapshots while the emulation runs"));
+	liveBox->setChecked(dataStore.isLive());
+	rateBox = new QSpinBox();
+	rateBox->setRange(1, 60);
+	rateBox->setSuffix(tr(" fps"));
+	rateBox->setValue(dataStore.getLiveRate());
+	rateBox->setToolTip(tr("Maximum number of snapshots per second"));
+	writesBox = new QCheckBox(tr("Writes"));
+	writesBox->setToolTip(tr("Highlight recently written VRAM; live snapshots "
+	                         "then only transfer the written parts"));
+	writesBox->setChecked(VramWriteMap::instance().isRunning());
+	statusLabel = new QLabel();
+	statusLabel->setToolTip(tr("Time per snapshot and the number of frames skipped "
+	                           "because the previous one wasn't done yet"));
+	recordButton = new QPushButton(tr("Record..."));
+	recordButton->setToolTip(tr("Save every refreshed image to a PNG sequence or a raw video file"));
+	recordButton->hide();
+	recordLabel = new QLabel();
+
+	auto* hbox = new QHBoxLayout();
+	hbox->setMargin(0);
+	hbox->addWidget(liveBox);
+	hbox->addWidget(rateBox);
+	hbox->addWidget(writesBox);
+	hbox->addWidget(statusLabel, 1);
+	hbox->addWidget(recordLabel);
+	hbox->addWidget(recordButton);
+	setLayout(hbox);
+
+	connect(liveBox, &QCheckBox::toggled, &dataStore, &VDPDataStore::setLive);
+	connect(rateBox, qOverload<int>(&QSpinBox::valueChanged), &dataStore, &VDPDataStore::setLiveRate);
+	connect(&dataStore, &VDPDataStore::liveChanged, this, [this](bool live) {
+		liveBox->setChecked(live);
+		rateBox->setValue(VDPDataStore::instance().getLiveRate());
+		updateStatus();
+	});
+	connect(&dataStore, &VDPDataStore::dataRefreshed, this, &VDPLiveControl::updateStatus);
+
+	auto& writeMap = VramWriteMap::instance();
+	connect(writesBox, &QCheckBox::toggled, &writeMap, [](bool on) {
+		auto& map = VramWriteMap::instance();
+		if (on) map.start(); else map.stop();
+	});
+	connect(&writeMap, &VramWriteMap::runningChanged, writesBox, &QCheckBox::setChecked);
+
+	connect(recordButton, &QPushButton::clicked, this, &VDPLiveControl::record);
+	connect(&recorder, &FrameRecorder::recordingChanged, this, &VDPLiveControl::recordingChanged);
+	connect(&recorder, &FrameRecorder::progress, this, [this](int written, int dropped) {
+		recordLabel->setText(tr("%1 frames, %2 dropped").arg(written).arg(dropped));
+	});
+	// queued, so the viewers have decoded the new data when the frame is taken
+	connect(&dataStore, &VDPDataStore::dataRefreshed,
+	        this, &VDPLiveControl::captureFrame, Qt::QueuedConnection);
+}
+
+void VDPLiveControl::setCaptureSource(std::function<QImage()> source)
+{
+	capture = std::move(source);
+	recordButton->setVisible(bool(capture));
+}
+
+void VDPLiveControl::record()
+{
+	if (recorder.isRecording()) {
+		recorder.stop();
+		return;
+	}
+	QString filter;
+	QString path = QFileDialog::getSaveFileName(this, tr("Record frames"), QString(),
+		tr("PNG sequence (*.png);;Raw BGRA video (*.rgb)"), &filter);
+	if (path.isEmpty()) return;
+	bool ok;
+	int frames = QInputDialog::getInt(this, tr("Record frames"),
+		tr("Stop after this number of frames:"), 1000, 1, 100000, 100, &ok);
+	if (!ok) return;
+
+	auto format = filter.contains("*.rgb") ? FrameRecorder::RAW_BGRA : FrameRecorder::PNG_SEQUENCE;
+	if (!recorder.start(path, format, frames)) {
+		QMessageBox::warning(this, tr("Record frames"),
+			tr("Can't record to %1: %2").arg(path, recorder.errorString()));
+		return;
+	}
+	captureFrame(); // the image currently shown is the first frame
+}
+
+void VDPLiveControl::captureFrame()
+{
+	if (capture && recorder.isRecording()) recorder.addFrame(capture());
+}
+
+void VDPLiveControl::recordingChanged(bool recording)
+{
+	recordButton->setText(recording ? tr("Stop") : tr("Record..."));
+	if (recording) {
+		recordLabel->clear();
+		return;
+	}
+	if (QSize size = recorder.frameSize(); size.isValid()) {
+		// what a video tool needs to read the raw file
+		recordLabel->setText(tr("%1 frames of %2x%3 BGRA")
+			.arg(recorder.writtenFrames()).arg(size.width()).arg(size.height()));
+	}
+}
+
+void VDPLiveControl::updateStatus()
+{
+	const auto& dataStore = VDPDataStore::instance();
+	if (!dataStore.isLive()) {
+		statusLabel->clear();
+		return;
+	}
+	statusLabel->setText(tr("%1 ms, %2 skipped")
+		.arg(int(dataStore.getRefreshTime() + 0.5f))
+		.arg(dataStore.getSkippedFrames()));
+}
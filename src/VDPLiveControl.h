@@ -0,0 +1,47 @@
+#ifndef VDPLIVECONTROL_H
+#define VDPLIVECONTROL_H
+
+#include "FrameRecorder.h"
+#include <QImage>
+#include <QWidget>
+#include <functional>
+
+class QCheckBox;
+class QLabel;
+class QPushButton;
+class QSpinBox;
+
+/**
+ * Switches the live mode of the VDPDataStore on and off and sets its rate.
+ * All VDP viewers share the data store, so the controls of all viewers
+ * follow each other. The same goes for the VramWriteMap.
+ *
+ * A viewer that sets a capture source also gets a record button, which
+ * hands every refreshed image of that viewer to a FrameRecorder.
+ */
+class VDPLiveControl : public QWidget
+{
+	Q_OBJECT
+public:
+	VDPLiveControl(QWidget* parent = nullptr);
+
+	void setCaptureSource(std::function<QImage()> source);
+
+private:
+	void updateStatus();
+	void record();
+	void captureFrame();
+	void recordingChanged(bool recording);
+
+	QCheckBox* liveBox;
+	QSpinBox* rateBox;
+	QCheckBox* writesBox;
+	QLabel* statusLabel;
+	QPushButton* recordButton;
+	QLabel* recordLabel;
+
+	FrameRecorder recorder;
+	std::function<QImage()> capture;
+};
+
+#endif // VDPLIVECONTROL_H
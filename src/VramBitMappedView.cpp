@@ -1,8 +1,13 @@
 #include "VramBitMappedView.h"
+#include "YjkDecoder.h"
+#include "PaletteLut.h"
+#include "VramWriteMap.h"
 #include "ranges.h"
+#include <QHash>
 #include <QPainter>
+#include <QTimer>
 #include <algorithm>
-#include <cstdio>
+#include <cstring>
 
 VramBitMappedView::VramBitMappedView(QWidget* parent)
 	: QWidget(parent)
@@ -14,6 +19,10 @@ VramBitMappedView::VramBitMappedView(QWidget* parent)
 	// Mouse update events when mouse is moved over the image, Quibus likes this
 	// better than my preferred click-on-the-image.
 	setMouseTracking(true);
+
+	auto& writeMap = VramWriteMap::instance();
+	connect(&writeMap, &VramWriteMap::updated, this, qOverload<>(&QWidget::update));
+	connect(&writeMap, &VramWriteMap::runningChanged, this, qOverload<>(&QWidget::update));
 }
 
 void VramBitMappedView::setZoom(float zoom)
@@ -23,168 +32,193 @@ void VramBitMappedView::setZoom(float zoom)
 	update();
 }
 
+void VramBitMappedView::scheduleDecode()
+{
+	// setters tend to come in bunches, decode once after all of them
+	if (decodePending) return;
+	decodePending = true;
+	QTimer::singleShot(0, this, [this] { if (decodePending) decode(); });
+}
+
 void VramBitMappedView::decode()
 {
+	decodePending = false;
 	if (!vramBase) return;
+	decodePallet();
 
-	printf("\n"
-	       "screenMode: %i\n"
-	       "vram to start decoding: %i\n",
-	       screenMode, vramAddress);
-	switch (screenMode) {
-		case  5: decodeSCR5();  break;
-		case  6: decodeSCR6();  break;
-		case  7: decodeSCR7();  break;
-		case  8: decodeSCR8();  break;
-		case 10:
-		case 11: decodeSCR10(); break;
-		case 12: decodeSCR12(); break;
-	}
+	decodePage(image, vramAddress);
 	pixImage = QPixmap::fromImage(image);
 	update();
+	emit imageChanged();
 }
 
-void VramBitMappedView::decodePallet()
+void VramBitMappedView::decodePage(QImage& target, unsigned address) const
 {
-	if (!palette) return;
-
-	for (int i = 0; i < 16; ++i) {
-		int r = (palette[2 * i + 0] & 0xf0) >> 4;
-		int b = (palette[2 * i + 0] & 0x0f);
-		int g = (palette[2 * i + 1] & 0x0f);
-		auto scale = [](int x) { return (x >> 1) | (x << 2) | (x << 5); };
-		msxPalette[i] = qRgb(scale(r), scale(g), scale(b));
+	if (!vramBase) return;
+
+	switch (screenMode) {
+		case  5: decodeSCR5(target, address);  break;
+		case  6: decodeSCR6(target, address);  break;
+		case  7: decodeSCR7(target, address);  break;
+		case  8: decodeSCR8(target, address);  break;
+		case 10:
+		case 11: decodeSCR10(target, address); break;
+		case 12: decodeSCR12(target, address); break;
 	}
 }
 
-static unsigned interleave(unsigned x)
+uint32_t VramBitMappedView::decodeKey() const
+{
+	uint32_t key = qHashBits(msxPalette, sizeof(msxPalette));
+	return key ^ qHash(screenMode) ^ qHash(lines << 8) ^ qHash(borderColor << 16);
+}
+
+bool VramBitMappedView::decodePallet()
 {
-	return (x >> 1) | ((x & 1) << 16);
+	const auto& colors = PaletteLut::instance().colors(palette);
+	if (colors.version == paletteVersion) return false;
+	paletteVersion = colors.version;
+	std::copy_n(colors.rgb, 16, msxPalette);
+	return true;
 }
 
-void VramBitMappedView::setPixel2x2(int x, int y, QRgb c)
+// from screen 7 on the pixels are interleaved over the two 64kB banks,
+// the expansion RAM after them (up to 64kB) is not interleaved
+static unsigned interleave(unsigned x)
 {
-	image.setPixel(2 * x + 0, 2 * y + 0, c);
-	image.setPixel(2 * x + 1, 2 * y + 0, c);
-	image.setPixel(2 * x + 0, 2 * y + 1, c);
-	image.setPixel(2 * x + 1, 2 * y + 1, c);
+	return x < 0x20000 ? (x >> 1) | ((x & 1) << 16) : x;
 }
 
-void VramBitMappedView::setPixel1x2(int x, int y, QRgb c)
+// first of the two image lines of MSX line 'y'
+static QRgb* scanLine(QImage& image, int y)
 {
-	image.setPixel(x, 2 * y + 0, c);
-	image.setPixel(x, 2 * y + 1, c);
+	return reinterpret_cast<QRgb*>(image.scanLine(2 * y));
 }
 
-static QRgb decodeYJK(int y, int j, int k)
+static void duplicateLine(QImage& image, int y)
 {
-	int r = std::clamp(y + j, 0, 31);
-	int g = std::clamp(y + k, 0, 31);
-	int b = std::clamp((5 * y - 2 * j - k) / 4, 0, 31);
-	auto scale = [](int x) { return (x << 3) | (x >> 2); };
-	return qRgb(scale(r), scale(g), scale(b));
+	// every MSX line is shown as two image lines
+	memcpy(image.scanLine(2 * y + 1), image.scanLine(2 * y), 512 * sizeof(QRgb));
 }
 
-void VramBitMappedView::decodeSCR12()
+void VramBitMappedView::decodeSCR12(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
+		QRgb* line = scanLine(target, y);
 		for (int x = 0; x < 256; x += 4) {
 			uint8_t p[4];
 			p[0] = vramBase[interleave(offset++)];
 			p[1] = vramBase[interleave(offset++)];
 			p[2] = vramBase[interleave(offset++)];
 			p[3] = vramBase[interleave(offset++)];
-			int j = (p[2] & 7) + ((p[3] & 3) << 3) - ((p[3] & 4) << 3);
-			int k = (p[0] & 7) + ((p[1] & 3) << 3) - ((p[1] & 4) << 3);
+			QRgb c[4];
+			decodeYJK(p, c);
 			for (int n = 0; n < 4; ++n) {
-				setPixel2x2(x + n, y, decodeYJK(p[n] >> 3, j, k));
+				line[2 * (x + n) + 0] = line[2 * (x + n) + 1] = c[n];
 			}
 		}
+		duplicateLine(target, y);
 	}
 }
 
-void VramBitMappedView::decodeSCR10()
+void VramBitMappedView::decodeSCR10(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
+		QRgb* line = scanLine(target, y);
 		for (int x = 0; x < 256; x += 4) {
 			uint8_t p[4];
 			p[0] = vramBase[interleave(offset++)];
 			p[1] = vramBase[interleave(offset++)];
 			p[2] = vramBase[interleave(offset++)];
 			p[3] = vramBase[interleave(offset++)];
-			int j = (p[2] & 7) + ((p[3] & 3) << 3) - ((p[3] & 4) << 3);
-			int k = (p[0] & 7) + ((p[1] & 3) << 3) - ((p[1] & 4) << 3);
+			QRgb c[4];
+			decodeYJKYAE(p, msxPalette, c);
 			for (int n = 0; n < 4; ++n) {
-				QRgb c = (p[n] & 0x08) ? msxPalette[p[n] >> 4] // YAE
-				                       : decodeYJK(p[n] >> 3, j, k); // YJK
-				setPixel2x2(x + n, y, c);
+				line[2 * (x + n) + 0] = line[2 * (x + n) + 1] = c[n];
 			}
 		}
+		duplicateLine(target, y);
 	}
 }
 
-void VramBitMappedView::decodeSCR8()
+void VramBitMappedView::decodeSCR8(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	// the screen 8 colors don't depend on the palette
+	const auto& colors = PaletteLut::screen8();
+
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
+		QRgb* line = scanLine(target, y);
 		for (int x = 0; x < 256; ++x) {
-			uint8_t val = vramBase[interleave(offset++)];
-			int b = val & 0x03;
-			int r = val & 0x1C;
-			int g = val & 0xE0;
-
-			b = b | (b << 2) | (b << 4) | (b << 6);
-			r = (r >> 2) | r | (r << 3);
-			g = g | (g >> 3) | (g >> 6);
-
-			setPixel2x2(x, y, qRgb(r, g, b));
+			line[2 * x + 0] = line[2 * x + 1] = colors[vramBase[interleave(offset++)]];
 		}
+		duplicateLine(target, y);
 	}
 }
 
-QRgb VramBitMappedView::getColor(int c)
+QRgb VramBitMappedView::getColor(int c) const
 {
 	// TODO do we need to look at the TP bit???
-	return msxPalette[c ? c : borderColor];
+	return PaletteLut::shown(msxPalette, c, borderColor);
 }
 
-void VramBitMappedView::decodeSCR7()
+void VramBitMappedView::decodeSCR7(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	// two pixels per byte
+	QRgb lut[256][2];
+	for (int val = 0; val < 256; ++val) {
+		lut[val][0] = getColor(val >> 4);
+		lut[val][1] = getColor(val & 15);
+	}
+
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
+		QRgb* line = scanLine(target, y);
 		for (int x = 0; x < 512; x += 2) {
-			int val = vramBase[interleave(offset++)];
-			setPixel1x2(x + 0, y, getColor((val >> 4) & 15));
-			setPixel1x2(x + 1, y, getColor((val >> 0) & 15));
+			memcpy(line + x, lut[vramBase[interleave(offset++)]], sizeof(lut[0]));
 		}
+		duplicateLine(target, y);
 	}
 }
 
-void VramBitMappedView::decodeSCR6()
+void VramBitMappedView::decodeSCR6(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	// four pixels per byte
+	QRgb lut[256][4];
+	for (int val = 0; val < 256; ++val) {
+		for (int n = 0; n < 4; ++n) {
+			lut[val][n] = getColor((val >> (6 - 2 * n)) & 3);
+		}
+	}
+
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
+		QRgb* line = scanLine(target, y);
 		for (int x = 0; x < 512; x += 4) {
-			int val = vramBase[offset++];
-			setPixel1x2(x + 0, y, getColor((val >> 6) & 3));
-			setPixel1x2(x + 1, y, getColor((val >> 4) & 3));
-			setPixel1x2(x + 2, y, getColor((val >> 2) & 3));
-			setPixel1x2(x + 3, y, getColor((val >> 0) & 3));
+			memcpy(line + x, lut[vramBase[offset++]], sizeof(lut[0]));
 		}
+		duplicateLine(target, y);
 	}
 }
 
-void VramBitMappedView::decodeSCR5()
+void VramBitMappedView::decodeSCR5(QImage& target, unsigned address) const
 {
-	auto offset = vramAddress;
+	// two pixels per byte, both shown two wide
+	QRgb lut[256][4];
+	for (int val = 0; val < 256; ++val) {
+		lut[val][0] = lut[val][1] = getColor(val >> 4);
+		lut[val][2] = lut[val][3] = getColor(val & 15);
+	}
+
+	auto offset = address;
 	for (int y = 0; y < lines; ++y) {
-		for (int x = 0; x < 256; x += 2) {
-			int val = vramBase[offset++];
-			setPixel2x2(x + 0, y, getColor((val >> 4) & 15));
-			setPixel2x2(x + 1, y, getColor((val >> 0) & 15));
+		QRgb* line = scanLine(target, y);
+		for (int x = 0; x < 512; x += 4) {
+			memcpy(line + x, lut[vramBase[offset++]], sizeof(lut[0]));
 		}
+		duplicateLine(target, y);
 	}
 }
 
@@ -195,13 +229,34 @@ void VramBitMappedView::paintEvent(QPaintEvent* /*event*/)
 	QPainter qp(this);
 	//qp.drawImage(rect(),image,srcRect);
 	qp.drawPixmap(dstRect, pixImage, srcRect);
+	if (VramWriteMap::instance().isRunning()) drawWriteOverlay(qp);
+}
+
+void VramBitMappedView::drawWriteOverlay(QPainter& qp) const
+{
+	// recently written VRAM in red, per 8 bytes of a line
+	const auto& writeMap = VramWriteMap::instance();
+	unsigned bytesPerLine = screenMode <= 6 ? 128 : 256;
+	float width = 512.0f * 8.0f / float(bytesPerLine) * zoomFactor;
+	float height = 2.0f * zoomFactor;
+	for (int y = 0; y < lines; ++y) {
+		unsigned lineAddress = vramAddress + bytesPerLine * y;
+		for (unsigned x = 0; x < bytesPerLine; x += 8) {
+			unsigned addr = lineAddress + x;
+			// 8 bytes of an interleaved line come from both banks
+			float heat = screenMode >= 7
+			           ? std::max(writeMap.heat(interleave(addr)), writeMap.heat(interleave(addr + 1)))
+			           : writeMap.heat(addr);
+			if (heat <= 0.0f) continue;
+			qp.fillRect(QRectF(float(x / 8) * width, float(y) * height, width, height),
+			            QColor(255, 0, 0, int(160.0f * heat)));
+		}
+	}
 }
 
 void VramBitMappedView::refresh()
 {
-	decodePallet();
 	decode();
-	update();
 }
 
 void VramBitMappedView::mouseMoveEvent(QMouseEvent* e)
@@ -270,55 +325,45 @@ void VramBitMappedView::mousePressEvent(QMouseEvent* e)
 	// since mouseMove only emits the correct signal we reuse/abuse that method
 	mouseMoveEvent(e);
 
-	decodePallet();
-	decode();
-	update();
+	if (decodePallet()) decode();
 }
 
 void VramBitMappedView::setBorderColor(int value)
 {
-	borderColor = std::clamp(value, 0, 15);
-	decodePallet();
-	decode();
-	update();
+	value = std::clamp(value, 0, 15);
+	if (borderColor == value) return;
+	borderColor = value;
+	scheduleDecode();
 }
 
 void VramBitMappedView::setScreenMode(int mode)
 {
 	screenMode = mode;
-	decode();
-	update();
+	scheduleDecode();
 }
 
 void VramBitMappedView::setLines(int nrLines)
 {
 	lines = nrLines;
-	decode();
 	setFixedSize(int(512.0f * zoomFactor), int(float(lines) * 2.0f * zoomFactor));
-	update();
-	//setZoom(zoomFactor);
+	scheduleDecode();
 }
 
 void VramBitMappedView::setVramAddress(int adr)
 {
 	vramAddress = adr;
-	decodePallet();
-	decode();
-	update();
+	scheduleDecode();
 }
 
 void VramBitMappedView::setVramSource(const uint8_t* adr)
 {
 	vramBase = adr;
-	decodePallet();
-	decode();
-	update();
+	scheduleDecode();
 }
 
 void VramBitMappedView::setPaletteSource(const uint8_t* adr)
 {
 	palette = adr;
-	decodePallet();
-	decode();
-	update();
+	// another source with the same colors doesn't change the image
+	if (decodePallet()) scheduleDecode();
 }
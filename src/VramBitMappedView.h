@@ -8,6 +8,8 @@
 #include <QColor>
 #include <cstdint>
 
+class QPainter;
+
 class VramBitMappedView : public QWidget
 {
 	Q_OBJECT
@@ -27,6 +29,14 @@ public:
 	void mouseMoveEvent (QMouseEvent* e) override;
 
 	void refresh();
+	// the decoded image of the shown lines, unzoomed
+	[[nodiscard]] QImage frame() const { return image.copy(0, 0, 512, 2 * lines); }
+
+	// decode a page of VRAM as the view would show it, into a 512x512 RGB32
+	// image; safe to call from several threads at once
+	void decodePage(QImage& target, unsigned address) const;
+	// changes whenever decoding the same VRAM gives a different image
+	[[nodiscard]] uint32_t decodeKey() const;
 
 signals:
 	void imageChanged();
@@ -37,18 +47,18 @@ signals:
 
 private:
 	void paintEvent(QPaintEvent* e) override;
+	void drawWriteOverlay(QPainter& qp) const;
 
 	void decode();
-	void decodePallet();
-	void decodeSCR5();
-	void decodeSCR6();
-	void decodeSCR7();
-	void decodeSCR8();
-	void decodeSCR10();
-	void decodeSCR12();
-	void setPixel2x2(int x, int y, QRgb c);
-	void setPixel1x2(int x, int y, QRgb c);
-	QRgb getColor(int c);
+	void scheduleDecode();
+	bool decodePallet(); // false when the palette didn't change
+	void decodeSCR5(QImage& target, unsigned address) const;
+	void decodeSCR6(QImage& target, unsigned address) const;
+	void decodeSCR7(QImage& target, unsigned address) const;
+	void decodeSCR8(QImage& target, unsigned address) const;
+	void decodeSCR10(QImage& target, unsigned address) const;
+	void decodeSCR12(QImage& target, unsigned address) const;
+	QRgb getColor(int c) const;
 
 private:
 	QRgb msxPalette[16];
@@ -61,6 +71,8 @@ private:
 	int lines = 212;
 	int screenMode = 5;
 	int borderColor = 0;
+	uint32_t paletteVersion = 0; // of the colors in msxPalette
+	bool decodePending = false;
 };
 
 #endif // VRAMBITMAPPEDVIEW
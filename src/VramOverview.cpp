@@ -0,0 +1,108 @@
+#include "VramOverview.h"
+#include "VramBitMappedView.h"
+#include <QHash>
+#include <QPainter>
+#include <QRunnable>
+#include <iterator>
+
+static constexpr int COLUMNS = 2;
+static constexpr int SPACING = 4;
+static constexpr int LABEL_HEIGHT = 16;
+
+class PageDecoder : public QRunnable
+{
+public:
+	PageDecoder(const VramBitMappedView& v, QImage& img, unsigned addr)
+		: view(v), image(img), address(addr) {}
+
+	void run() override { view.decodePage(image, address); }
+
+private:
+	const VramBitMappedView& view;
+	QImage& image;
+	unsigned address;
+};
+
+VramOverview::VramOverview(const VramBitMappedView& v, QWidget* parent)
+	: QWidget(parent), view(v)
+{
+}
+
+void VramOverview::setPages(unsigned size, int count, int nrLines)
+{
+	if (size == pageSize && count == int(pages.size()) && nrLines == lines) return;
+	pageSize = size;
+	lines = nrLines;
+	pages.assign(count, Page());
+	for (auto& page : pages) {
+		page.image = QImage(512, 512, QImage::Format_RGB32);
+		page.image.fill(Qt::black);
+	}
+	updateGeometry();
+	resize(sizeHint());
+	refresh();
+}
+
+void VramOverview::setVramSource(const uint8_t* vram)
+{
+	vramBase = vram;
+	for (auto& page : pages) page.valid = false;
+}
+
+QSize VramOverview::sizeHint() const
+{
+	int rows = (int(pages.size()) + COLUMNS - 1) / COLUMNS;
+	return {COLUMNS * (256 + SPACING), rows * (lines + LABEL_HEIGHT + SPACING)};
+}
+
+uint32_t VramOverview::pageChecksum(int page) const
+{
+	// the bytes decodePage() reads for this page
+	unsigned address = page * pageSize;
+	if (pageSize < 0x10000 || address >= 0x20000) {
+		return qHashBits(vramBase + address, pageSize);
+	}
+	// from screen 7 on the pixels are interleaved over the two 64kB banks,
+	// only the expansion RAM is not
+	return qHashBits(vramBase + address / 2, pageSize / 2)
+	     ^ qHashBits(vramBase + 0x10000 + address / 2, pageSize / 2, 1);
+}
+
+void VramOverview::refresh()
+{
+	if (!vramBase || pageSize == 0 || !isVisible()) return;
+
+	uint32_t key = view.decodeKey();
+	bool all = key != decodeKey;
+	decodeKey = key;
+
+	bool changed = false;
+	for (size_t p = 0; p < pages.size(); ++p) {
+		auto& page = pages[p];
+		uint32_t checksum = pageChecksum(p);
+		if (page.valid && !all && checksum == page.checksum) continue;
+		page.checksum = checksum;
+		page.valid = true;
+		// the view only reads its settings, the image is private to the task
+		pool.start(new PageDecoder(view, page.image, p * pageSize));
+		changed = true;
+	}
+	// wait here, VRAM may change with the next refresh
+	pool.waitForDone();
+	if (changed) update();
+}
+
+void VramOverview::paintEvent(QPaintEvent* /*e*/)
+{
+	static const char* const names[] = {"0", "1", "2", "3", "E0", "E1"};
+	QPainter p(this);
+	p.setRenderHint(QPainter::SmoothPixmapTransform);
+	for (size_t i = 0; i < pages.size(); ++i) {
+		int x = (i % COLUMNS) * (256 + SPACING);
+		int y = (i / COLUMNS) * (lines + LABEL_HEIGHT + SPACING);
+		p.drawText(QRect(x, y, 256, LABEL_HEIGHT), Qt::AlignCenter,
+		           i < std::size(names) ? tr("Page %1").arg(names[i]) : QString::number(i));
+		p.drawImage(QRect(x, y + LABEL_HEIGHT, 256, lines),
+		            pages[i].image, QRect(0, 0, 512, 2 * lines));
+	}
+}
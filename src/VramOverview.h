@@ -0,0 +1,50 @@
+#ifndef VRAMOVERVIEW_H
+#define VRAMOVERVIEW_H
+
+#include <QImage>
+#include <QThreadPool>
+#include <QWidget>
+#include <cstdint>
+#include <vector>
+
+class VramBitMappedView;
+
+/**
+ * All VRAM pages of a bitmap mode side by side, at half size. The pages are
+ * decoded in parallel on a thread pool, with the settings of the bitmap view
+ * they belong to. A page is only decoded again when its VRAM or those
+ * settings changed since the previous refresh.
+ */
+class VramOverview : public QWidget
+{
+	Q_OBJECT
+public:
+	VramOverview(const VramBitMappedView& view, QWidget* parent = nullptr);
+
+	void setPages(unsigned pageSize, int pageCount, int lines);
+	void setVramSource(const uint8_t* vram);
+
+	void refresh();
+
+	QSize sizeHint() const override;
+
+private:
+	void paintEvent(QPaintEvent* e) override;
+	[[nodiscard]] uint32_t pageChecksum(int page) const;
+
+	struct Page {
+		QImage image;
+		uint32_t checksum = 0;
+		bool valid = false;
+	};
+
+	const VramBitMappedView& view;
+	const uint8_t* vramBase = nullptr;
+	std::vector<Page> pages;
+	unsigned pageSize = 0;
+	int lines = 212;
+	uint32_t decodeKey = 0;
+	QThreadPool pool;
+};
+
+#endif // VRAMOVERVIEW_H
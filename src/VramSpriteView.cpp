@@ -1,6 +1,8 @@
 #include "VramSpriteView.h"
 #include "VDPDataStore.h"
+#include "PaletteLut.h"
 #include <QPainter>
+#include <QTimer>
 #include <algorithm>
 #include <cstdio>
 #include "Convert.h"
@@ -18,6 +20,13 @@ VramSpriteView::VramSpriteView(QWidget* parent, mode drawer, bool singleSprite)
         zoomFactor = 4;
         nrOfSpritesToShow = 1;
         recalcSpriteLayout(sizeOfSpritesHorizontal * zoomFactor);
+    } else if (drawer == SpriteLayerMode) {
+        setSizePolicy(QSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed));
+        nrOfSpritesToShow = 32;
+        nrOfSpritesHorizontal = 1;
+        nrOfSpritesVertical = 1;
+        zoomFactor = 2;
+        recalcSpriteLayout(0); // size only depends on the number of lines
     } else {
         QSizePolicy sizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
         sizePolicy.setHeightForWidth(true);
@@ -30,6 +39,7 @@ VramSpriteView::VramSpriteView(QWidget* parent, mode drawer, bool singleSprite)
                 break;
             case SpriteAttributeMode:
             case ColorMode:
+            case SpriteLayerMode:
                 nrOfSpritesToShow = 32;
                 nrOfSpritesHorizontal = 16;
                 nrOfSpritesVertical = 2;
@@ -46,6 +56,8 @@ VramSpriteView::VramSpriteView(QWidget* parent, mode drawer, bool singleSprite)
 
 int VramSpriteView::heightForWidth(int width) const
 {
+    if (drawMode == SpriteLayerMode) return imageHeight;
+
     // How many sprites do fit in this width?
     float x = int(width / (sizeOfSpritesHorizontal * zoomFactor)); // Does an int divided by an int gives an int that would be converted to float?
     int h = int(ceilf(float(nrOfSpritesToShow) / x)) * sizeOfSpritesVertical * zoomFactor;
@@ -69,8 +81,7 @@ void VramSpriteView::setVramSource(const uint8_t* adr)
 {
     if (vramBase == adr) return;
     vramBase = adr;
-    decodePalette();
-    decode();
+    scheduleDecode();
 }
 
 void VramSpriteView::setPaletteSource(const uint8_t* adr, bool useVDP)
@@ -78,12 +89,21 @@ void VramSpriteView::setPaletteSource(const uint8_t* adr, bool useVDP)
     useVDPpalette = useVDP;
     if (palette == adr) return;
     palette = adr;
-    decodePalette();
-    decode();
+    // another source with the same colors doesn't change the image
+    if (decodePalette()) scheduleDecode();
 }
 
 void VramSpriteView::mousePressEvent(QMouseEvent* e)
 {
+    if (drawMode == SpriteLayerMode) {
+        int x = e->x() / zoomFactor;
+        int y = e->y() / zoomFactor;
+        if (vramBase && y >= 0 && y < layerLines) {
+            emit imageClicked(x, y, compositor.spriteAt(x, y), lineInfo(y));
+        }
+        return;
+    }
+
     int x = 0; // TODO is this correct? 'x' and 'y' always remain '0'.
     int y = 0;
 
@@ -113,6 +133,16 @@ void VramSpriteView::mousePressEvent(QMouseEvent* e)
 
 void VramSpriteView::mouseMoveEvent(QMouseEvent* e)
 {
+    if (drawMode == SpriteLayerMode) {
+        int x = e->x() / zoomFactor;
+        int y = e->y() / zoomFactor;
+        int sprite = compositor.spriteAt(x, y);
+        if (vramBase && sprite >= 0) {
+            emit imagePosition(x, y, sprite);
+        }
+        return;
+    }
+
     int x = 0; // TODO is this correct? 'x' and 'y' always remain '0'.
     int y = 0;
     if (auto info = infoFromMouseEvent(e)) {
@@ -149,6 +179,14 @@ void VramSpriteView::warningImage()
     qp.drawText(16, 16, "No sprites in this screenmode!");
 }
 
+QImage VramSpriteView::frame() const
+{
+    if (drawMode == SpriteLayerMode) {
+        return image.copy(0, 0, SpriteCompositor::WIDTH, layerLines);
+    }
+    return image.copy();
+}
+
 void VramSpriteView::setZoom(float zoom)
 {
     zoomFactor = std::max(1, int(zoom));
@@ -157,6 +195,13 @@ void VramSpriteView::setZoom(float zoom)
 
 void VramSpriteView::paintEvent(QPaintEvent* /*e*/)
 {
+    if (drawMode == SpriteLayerMode) {
+        // the sprite layer is decoded at VDP resolution and scaled here
+        QPainter qp(this);
+        qp.drawPixmap(QRect(0, 0, imageWidth, imageHeight), pixImage);
+        return;
+    }
+
     QRect srcRect(0, 0, imageWidth, imageHeight);
     QRect dstRect(0, 0, imageWidth, imageHeight);
     //QRect dstRect(0, 0, int(2 * imageWidth * zoomFactor), int(2 * imageHeight * zoomFactor));
@@ -178,9 +223,19 @@ void VramSpriteView::paintEvent(QPaintEvent* /*e*/)
 //                arg(nrOfSpritesVertical * nrOfSpritesHorizontal));
 }
 
+void VramSpriteView::scheduleDecode()
+{
+    // setters tend to come in bunches, decode once after all of them
+    if (decodePending) return;
+    decodePending = true;
+    QTimer::singleShot(0, this, [this] { if (decodePending) decode(); });
+}
+
 void VramSpriteView::decode()
 {
+    decodePending = false;
     if (!vramBase) return;
+    decodePalette();
     image.fill(Qt::lightGray);
     if (spriteMode == 0) {
         warningImage();
@@ -195,9 +250,12 @@ void VramSpriteView::decode()
             case ColorMode:
                 decodeCol();
                 break;
+            case SpriteLayerMode:
+                decodeLayer();
+                break;
             }
         //and now draw grid if any
-        if (!isSingleSpriteDrawer && gridEnabled && spriteMode) {
+        if (!isSingleSpriteDrawer && gridEnabled && spriteMode && drawMode != SpriteLayerMode) {
             drawGrid();
         }
     }
@@ -247,18 +305,13 @@ void VramSpriteView::drawGrid()
     }
 }
 
-void VramSpriteView::decodePalette()
+bool VramSpriteView::decodePalette()
 {
-    if (!palette) return;
-
-    for (int i = 0; i < 16; ++i) {
-        int r = (palette[2 * i + 0] & 0xf0) >> 4;
-        int b = (palette[2 * i + 0] & 0x0f);
-        int g = (palette[2 * i + 1] & 0x0f);
-
-        auto scale = [](int x) { return (x >> 1) | (x << 2) | (x << 5); };
-        msxPalette[i] = qRgb(scale(r), scale(g), scale(b));
-    }
+    const auto& colors = PaletteLut::instance().colors(palette);
+    if (colors.version == paletteVersion) return false;
+    paletteVersion = colors.version;
+    std::copy_n(colors.rgb, 16, msxPalette);
+    return true;
 }
 
 void VramSpriteView::decodePgt()
@@ -320,6 +373,73 @@ void VramSpriteView::decodeCol()
     }
 }
 
+void VramSpriteView::decodeLayer()
+{
+    const auto* regs = VDPDataStore::instance().getRegsPointer();
+    int lines = regs[9] & 128 ? 212 : 192;
+    if (lines != layerLines) {
+        layerLines = lines;
+        recalcSpriteLayout(0); // decodes again with the new image size
+        return;
+    }
+
+    SpriteCompositor::Settings settings;
+    settings.spriteMode = spriteMode;
+    settings.size16x16 = size16x16;
+    settings.magnified = useMagnification;
+    settings.patternTableAddress = patternTableAddress;
+    settings.attributeTableAddress = attributeTableAddress;
+    settings.colorTableAddress = colorTableAddress;
+    settings.lines = layerLines;
+    settings.verticalScroll = spriteMode == 2 ? regs[23] : 0;
+    compositor.compose(vramBase, settings, msxPalette, msxPalette[regs[7] & 15], image);
+    drawLineOverlay();
+}
+
+void VramSpriteView::drawLineOverlay()
+{
+    // To the right of the screen one pixel per sprite on that line: green
+    // for the ones that are shown, red for the ones the VDP drops.
+    QRgb back    = QColor(Qt::lightGray).rgb();
+    QRgb limitBg = QColor(Qt::gray).rgb();
+    QRgb shown   = QColor(Qt::darkGreen).rgb();
+    QRgb dropped = QColor(Qt::red).rgb();
+    int limit = compositor.limit();
+    for (int y = 0; y < layerLines; ++y) {
+        auto* out = reinterpret_cast<QRgb*>(image.scanLine(y)) + SpriteCompositor::WIDTH;
+        int count = compositor.line(y).count;
+        std::fill_n(out, OVERLAY_WIDTH, back);
+        out += 4;
+        for (int i = 0; i < SpriteCompositor::MAX_SPRITES; ++i) {
+            if (i < count) {
+                out[i] = i < limit ? shown : dropped;
+            } else if (i == limit) {
+                out[i] = limitBg;
+            }
+        }
+    }
+}
+
+QString VramSpriteView::lineInfo(int line) const
+{
+    const auto& l = compositor.line(line);
+    int limit = compositor.limit();
+    QString info = QString("%1 sprite(s) on this line, %2 shown\n")
+                       .arg(l.count)
+                       .arg(std::min(l.count, limit));
+    for (int i = 0; i < l.count; ++i) {
+        int sprite = l.sprites[i];
+        auto addr = attributeTableAddress + 4 * sprite;
+        info.append(QString("sprite %1  y %2  x %3  pattern %4%5\n")
+                        .arg(sprite, 2)
+                        .arg(vramBase[addr + 0], 3)
+                        .arg(vramBase[addr + 1], 3)
+                        .arg(vramBase[addr + 2], 3)
+                        .arg(i < limit ? "" : "  dropped"));
+    }
+    return info;
+}
+
 void VramSpriteView::drawColSprite(int entry, QColor& /*bgcolor*/)
 {
     int color = vramBase[attributeTableAddress + 4 * entry + 3];
@@ -414,13 +534,13 @@ QRgb VramSpriteView::getColor(int c)
 void VramSpriteView::setAttributeTableAddress(int value)
 {
     attributeTableAddress = value;
-    decode();
+    scheduleDecode();
 }
 
 void VramSpriteView::setColorTableAddress(int value)
 {
     colorTableAddress = value;
-    decode();
+    scheduleDecode();
 }
 
 QString VramSpriteView::colorInfo(uint8_t color) const
@@ -524,7 +644,7 @@ QString VramSpriteView::byteAsPattern(uint8_t byte)
 void VramSpriteView::setPatternTableAddress(int value)
 {
     patternTableAddress = value;
-    decode();
+    scheduleDecode();
 }
 
 void VramSpriteView::setDrawgrid(bool value)
@@ -568,6 +688,15 @@ void VramSpriteView::setCharacterClicked(int charBox)
 
 void VramSpriteView::recalcSpriteLayout(int width)
 {
+    if (drawMode == SpriteLayerMode) {
+        imageWidth  = (SpriteCompositor::WIDTH + OVERLAY_WIDTH) * zoomFactor;
+        imageHeight = layerLines * zoomFactor;
+        image = QImage(SpriteCompositor::WIDTH + OVERLAY_WIDTH, layerLines, QImage::Format_RGB32);
+        setFixedSize(imageWidth, imageHeight);
+        refresh();
+        return;
+    }
+
     nrOfSpritesHorizontal = std::max(1, width / (zoomFactor * sizeOfSpritesHorizontal)); // If to small to fit, then still set at least 1 otherwise we would be dividing by zero down the line!!
     nrOfSpritesVertical = int(ceilf(float(nrOfSpritesToShow) / float(nrOfSpritesHorizontal)));
 
@@ -585,11 +714,10 @@ void VramSpriteView::resizeEvent(QResizeEvent *event)
 void VramSpriteView::refresh()
 {
     // Reset pointers in case during boot these pointers weren't correctly set due to openMSX not having send over vram size...
-    setVramSource(VDPDataStore::instance().getVramPointer());
+    vramBase = VDPDataStore::instance().getVramPointer();
     if (useVDPpalette) {
-        setPaletteSource(VDPDataStore::instance().getPalettePointer(), true);
+        palette = VDPDataStore::instance().getPalettePointer();
     }
-    decodePalette();
     decode();
 }
 
@@ -1,6 +1,7 @@
 #ifndef VRAMSPRITEVIEW_H
 #define VRAMSPRITEVIEW_H
 
+#include "SpriteCompositor.h"
 #include <QWidget>
 #include <QString>
 #include <QImage>
@@ -18,7 +19,8 @@ public:
     {
         PatternMode,
         SpriteAttributeMode,
-        ColorMode
+        ColorMode,
+        SpriteLayerMode // all sprites composed as the VDP shows them
     };
 
     explicit VramSpriteView(QWidget* parent = nullptr, mode drawer = PatternMode, bool singleSprite = false);
@@ -40,12 +42,15 @@ public:
     void setColorTableAddress(int value);
 
     QString patternInfo(int character, int spriteNr = -1);
+    QString lineInfo(int line) const;
     QString byteAsPattern(uint8_t byte);
 
     void calculateImageSize();
     void recalcSpriteLayout(int width);
 
     void refresh();
+    // the decoded image, for SpriteLayerMode without the per line overlay
+    [[nodiscard]] QImage frame() const;
     void setZoom(float zoom);
     void setDrawgrid(bool value);
     void setUseMagnification(bool value);
@@ -71,10 +76,13 @@ private:
     void paintEvent(QPaintEvent* e) override;
 
     void decode();
-    void decodePalette();
+    void scheduleDecode();
+    bool decodePalette(); // false when the palette didn't change
     void decodePgt();
     void decodeSpat();
     void decodeCol();
+    void decodeLayer();
+    void drawLineOverlay();
 
     void setSpritePixel(int x, int y, QRgb c);
     QRgb getColor(int c);
@@ -95,6 +103,8 @@ private:
 
 private:
     QRgb msxPalette[16];
+    uint32_t paletteVersion = 0; // of the colors in msxPalette
+    bool decodePending = false;
     QImage image;
     QPixmap pixImage;
     const uint8_t* palette = nullptr;
@@ -123,6 +133,11 @@ private:
     bool useMagnification = false; // only used when useECbit is true! if not this simply acts as zoomfactor...
     int charToDisplay = 0;
     int currentSpriteboxSelected = -1;
+
+    // SpriteLayerMode: the screen, with the sprites per line to the right
+    static constexpr int OVERLAY_WIDTH = 40;
+    SpriteCompositor compositor;
+    int layerLines = 212;
 };
 
 #endif // VRAMSPRITEVIEW_H
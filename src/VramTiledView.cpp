@@ -1,14 +1,18 @@
 #include "VramTiledView.h"
 #include "VDPDataStore.h"
+#include "PaletteLut.h"
+#include "VramWriteMap.h"
 #include "Convert.h"
 #include "ranges.h"
 #include <QPainter>
+#include <QTimer>
 #include <algorithm>
 #include <cstdio>
 
 VramTiledView::VramTiledView(QWidget* parent)
 	: QWidget(parent)
 	, image(512, 512, QImage::Format_RGB32)
+	, atlas(2 * ATLAS_CHARS)
 {
 	ranges::fill(msxPalette, qRgb(80, 80, 80));
 	setZoom(1.0f);
@@ -16,6 +20,10 @@ VramTiledView::VramTiledView(QWidget* parent)
 	// Mouse update events when mouse is moved over the image, Quibus likes this
 	// better than my preferred click-on-the-image.
 	setMouseTracking(true);
+
+	auto& writeMap = VramWriteMap::instance();
+	connect(&writeMap, &VramWriteMap::updated, this, qOverload<>(&QWidget::update));
+	connect(&writeMap, &VramWriteMap::runningChanged, this, qOverload<>(&QWidget::update));
 }
 
 void VramTiledView::setZoom(float zoom)
@@ -27,28 +35,45 @@ void VramTiledView::setZoom(float zoom)
 	} else {
 		lines = (forcedScreenRows != 0.0f) ? int(8 * forcedScreenRows) : 192;
 	}
-	int imageW = screenMode ==  0 ? 40 * 6 * 2
-	           : screenMode == 80 ? 80 * 6
-		                      : 512;
-	setFixedSize(int(zoomFactor * float(imageW)),
+	setFixedSize(int(zoomFactor * float(imageWidth())),
 	             int(zoomFactor * float(lines) * 2));
 	update();
 }
 
+int VramTiledView::imageWidth() const
+{
+	return screenMode ==  0 ? 40 * 6 * 2
+	     : screenMode == 80 ? 80 * 6
+	                        : 512;
+}
+
+QImage VramTiledView::frame() const
+{
+	return image.copy(0, 0, imageWidth(), 2 * lines);
+}
+
+void VramTiledView::scheduleDecode()
+{
+	// setters tend to come in bunches, decode once after all of them
+	if (decodePending) return;
+	decodePending = true;
+	QTimer::singleShot(0, this, [this] { if (decodePending) decode(); });
+}
+
 void VramTiledView::decode()
 {
+	decodePending = false;
 	if (!vramBase) return;
+	decodePalette();
 
 	//also everytime we decode we adjust height of widget to the correct screenheight
 	const auto* regs = VDPDataStore::instance().getRegsPointer();
 	lines = (forcedScreenRows != 0.0f) ? int(8 * forcedScreenRows) : (regs[9] & 128 ? 212 : 192);
-	int imageW = screenMode ==  0 ? 40 * 6 * 2
-	           : screenMode == 80 ? 80 * 6
-		                      : 512;
-	setFixedSize(int(zoomFactor * float(imageW)),
+	setFixedSize(int(zoomFactor * float(imageWidth())),
 	             int(zoomFactor * float(lines) * 2));
 
 	image.fill(Qt::gray);
+	validateAtlas();
 
 	switch (tableToShow) {
 		case 0:
@@ -76,24 +101,18 @@ void VramTiledView::decode()
 		}
 	}
 
+	analyzeTiles();
 	pixImage = QPixmap::fromImage(image);
 	update();
 }
 
-void VramTiledView::decodePalette()
+bool VramTiledView::decodePalette()
 {
-	if (!palette) return;
-	//printf("VramTiledView::decodePallet  palletpointer %p \n", palette);
-
-	for (int i = 0; i < 16; ++i) {
-		int r = (palette[2 * i + 0] & 0xf0) >> 4;
-		int b = (palette[2 * i + 0] & 0x0f);
-		int g = (palette[2 * i + 1] & 0x0f);
-
-		auto scale = [](int x) { return (x >> 1) | (x << 2) | (x << 5); };
-		msxPalette[i] = qRgb(scale(r), scale(g), scale(b));
-		//printf("VramTiledView::decodePallet  color %d => r %d  g %d  b %d \n", i, r, g, b);
-	}
+	const auto& colors = PaletteLut::instance().colors(palette);
+	if (colors.version == paletteVersion) return false;
+	paletteVersion = colors.version;
+	std::copy_n(colors.rgb, 16, msxPalette);
+	return true;
 }
 
 void VramTiledView::decodePatternTable()
@@ -135,11 +154,9 @@ void VramTiledView::warningImage()
 
 void VramTiledView::decodeNameTable()
 {
-	const auto* regs = VDPDataStore::instance().getRegsPointer();
-
 	screenWidth = 32;
 	charWidth = 8;
-	screenHeight = (forcedScreenRows != 0.0f) ? int(forcedScreenRows + 0.5) : (regs[9] & 128 ? 27 : 24); // Check LN bit of vdp reg #9 to determine screenheight
+	screenHeight = nameTableRows();
 
 	switch (screenMode) {
 	case 0:
@@ -193,12 +210,6 @@ void VramTiledView::overLayNameTable()
 	}
 }
 
-void VramTiledView::setPixel1x2(int x, int y, QRgb c)
-{
-	image.setPixel(x, 2 * y + 0, c);
-	image.setPixel(x, 2 * y + 1, c);
-}
-
 void VramTiledView::setPixel2x2(int x, int y, QRgb c)
 {
 	image.setPixel(2 * x + 0, 2 * y + 0, c);
@@ -210,8 +221,7 @@ void VramTiledView::setPixel2x2(int x, int y, QRgb c)
 
 QRgb VramTiledView::getColor(int c)
 {
-	// TODO do we need to look at the TP bit???
-	return msxPalette[c ? c : (tpBit ? 0 : borderColor)];
+	return PaletteLut::shown(msxPalette, c, borderColor, tpBit);
 }
 
 const uint8_t *VramTiledView::getPaletteSource() const
@@ -229,18 +239,39 @@ void VramTiledView::setHighlightChar(int value)
 	if (highlightChar == value) return;
 
 	highlightChar = value;
-	decode();
+	scheduleDecode(); // also emits the new highlightCount
+}
 
-	if (vramBase == nullptr || value < 0 || value > 255) return;
+int VramTiledView::nameTableRows() const
+{
+	// Check LN bit of vdp reg #9 to determine screenheight
+	const auto* regs = VDPDataStore::instance().getRegsPointer();
+	return (forcedScreenRows != 0.0f) ? int(forcedScreenRows + 0.5) : (regs[9] & 128 ? 27 : 24);
+}
 
-	// Count how many 'value'-characters there are in the nametable
-	int count = 0;
-	for (int i = 0; i < screenHeight * screenWidth; ++i) {
-		if (vramBase[nameTableAddress + i] == value) {
-			count++;
-		}
+void VramTiledView::analyzeTiles()
+{
+	switch (screenMode) {
+	case 0: case 1: case 2: case 3: case 4: case 80:
+		break;
+	default:
+		analysis.clear();
+		emit analyzed();
+		return;
+	}
+	TileAnalysis::Settings settings;
+	settings.screenMode = screenMode;
+	settings.nameTableAddress = nameTableAddress;
+	settings.patternTableAddress = patternTableAddress;
+	settings.colorTableAddress = colorTableAddress;
+	settings.columns = screenMode == 0 ? 40 : screenMode == 80 ? 80 : 32;
+	settings.rows = nameTableRows();
+	analysis.analyze(vramBase, settings);
+	emit analyzed();
+
+	if (highlightChar >= 0 && highlightChar <= 255) {
+		emit highlightCount(uint8_t(highlightChar), analysis.nameCount(uint8_t(highlightChar)));
 	}
-	emit highlightCount(value & 255, count);
 }
 
 void VramTiledView::setForcedScreenRows(float value)
@@ -249,21 +280,21 @@ void VramTiledView::setForcedScreenRows(float value)
 
 	forcedScreenRows = value;
 	setZoom(zoomFactor); // Redo fixed size of widget
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setUseBlink(bool value)
 {
 	if (useBlink == value) return;
 	useBlink = value;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setTpBit(bool value)
 {
 	if (tpBit == value) return;
 	tpBit = value;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::decodePatternTableRegularChars()
@@ -333,18 +364,24 @@ void VramTiledView::decodeNameTableMultiColor()
 }
 
 uint8_t VramTiledView::getCharColorByte(int character, int x, int y, int row)
+{
+	return getCharColorByte(character, row, isBlinking(x, y));
+}
+
+bool VramTiledView::isBlinking(int x, int y)
+{
+	// If blink bit set then show alternate colors
+	return screenMode == 80 && useBlink && (tableToShow > 0) &&
+	       (vramBase[colorTableAddress + (x >> 3) + 10 * y] & (1 << (7 - (7 & x))));
+}
+
+uint8_t VramTiledView::getCharColorByte(int character, int row, bool blink)
 {
 	const auto* regs = VDPDataStore::instance().getRegsPointer();
-	uint8_t colorByte = regs[7];
+	uint8_t colorByte = blink ? regs[12] : regs[7];
 	switch (screenMode) {
 	case 0:
-		break;
 	case 80:
-		// If blink bit set then show alternate colors
-		if (useBlink && (tableToShow > 0) &&
-		    (vramBase[colorTableAddress + (x >> 3) + 10 * y] & (1 << (7 - (7 & x))))) {
-			colorByte = regs[12];
-		}
 		break;
 	case 2:
 	case 4:
@@ -360,19 +397,68 @@ uint8_t VramTiledView::getCharColorByte(int character, int x, int y, int row)
 	return colorByte;
 }
 
+void VramTiledView::validateAtlas()
+{
+	// Palette, border color or TP bit changes affect all tiles at once
+	if (paletteVersion != atlasPaletteVersion || borderColor != atlasBorderColor || tpBit != atlasTpBit) {
+		atlasPaletteVersion = paletteVersion;
+		atlasBorderColor = borderColor;
+		atlasTpBit = tpBit;
+		for (auto& tile : atlas) tile.valid = false;
+	}
+	// VRAM bytes are compared again in this pass, at most once per tile
+	++decodePass;
+}
+
+const VramTiledView::Tile& VramTiledView::getTile(int character, bool blink)
+{
+	Tile& tile = atlas[(character & (ATLAS_CHARS - 1)) + (blink ? ATLAS_CHARS : 0)];
+	if (tile.valid && tile.checked == decodePass) return tile;
+	tile.checked = decodePass;
+
+	uint8_t pattern[8];
+	uint8_t colors[8];
+	for (int charRow = 0; charRow < 8; ++charRow) {
+		pattern[charRow] = vramBase[patternTableAddress + 8 * character + charRow];
+		colors[charRow] = getCharColorByte(character, charRow, blink);
+	}
+	if (tile.valid && std::equal(pattern, pattern + 8, tile.pattern) &&
+	    std::equal(colors, colors + 8, tile.colors)) {
+		return tile;
+	}
+
+	std::copy_n(pattern, 8, tile.pattern);
+	std::copy_n(colors, 8, tile.colors);
+	for (int charRow = 0; charRow < 8; ++charRow) {
+		QRgb fg = getColor(colors[charRow] >> 4);
+		QRgb bg = getColor(colors[charRow] & 15);
+		for (int charCol = 0; charCol < 8; ++charCol) {
+			tile.pixels[charRow][charCol] = pattern[charRow] & (0x80 >> charCol) ? fg : bg;
+		}
+	}
+	tile.valid = true;
+	return tile;
+}
+
 void VramTiledView::drawCharAt(int character, int x, int y)
 {
+	const Tile& tile = getTile(character, isBlinking(x, y));
+	bool narrow = screenMode == 80 && tableToShow > 0;
 	for (int charRow = 0; charRow < 8; ++charRow) {
-		uint8_t patternByte = vramBase[patternTableAddress + 8 * character + charRow];
-		for (int charCol = 0; charCol < charWidth; ++charCol) {
-			uint8_t mask = 1 << (7 - charCol);
-			uint8_t colors = getCharColorByte(character, x, y, charRow);
-			QRgb col = getColor(patternByte & mask ? (colors >> 4) : (colors & 15));
-			if (screenMode == 80 && tableToShow > 0) {
-				setPixel1x2(x * charWidth + charCol, 8 * y + charRow, col);
-			} else {
-				setPixel2x2(x * charWidth + charCol, 8 * y + charRow, col);
+		auto* line0 = reinterpret_cast<QRgb*>(image.scanLine(2 * (8 * y + charRow)));
+		auto* line1 = reinterpret_cast<QRgb*>(image.scanLine(2 * (8 * y + charRow) + 1));
+		const QRgb* src = tile.pixels[charRow];
+		if (narrow) {
+			QRgb* dst = line0 + x * charWidth;
+			std::copy_n(src, charWidth, dst);
+			std::copy_n(dst, charWidth, line1 + x * charWidth);
+		} else {
+			QRgb* dst = line0 + 2 * x * charWidth;
+			for (int charCol = 0; charCol < charWidth; ++charCol) {
+				dst[2 * charCol + 0] = src[charCol];
+				dst[2 * charCol + 1] = src[charCol];
 			}
+			std::copy_n(dst, 2 * charWidth, line1 + 2 * x * charWidth);
 		}
 	}
 }
@@ -398,14 +484,14 @@ void VramTiledView::setTabletoShow(int value)
 {
 	if (tableToShow == value) return;
 	tableToShow = value;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setDrawGrid(bool value)
 {
 	if (drawGrid == value) return;
 	drawGrid = value;
-	decode();
+	scheduleDecode();
 }
 
 unsigned VramTiledView::getColorTableAddress() const
@@ -430,11 +516,61 @@ void VramTiledView::paintEvent(QPaintEvent* /*event*/)
 	QPainter qp(this);
 	//qp.drawImage(rect(), image, srcRect);
 	qp.drawPixmap(dstRect, pixImage, srcRect);
+	if (VramWriteMap::instance().isRunning()) drawWriteOverlay(qp);
+}
+
+float VramTiledView::cellHeat(int character, unsigned nameAddress) const
+{
+	// a block holds 8 patterns, so one lookup covers the 8 bytes of a character
+	const auto& writeMap = VramWriteMap::instance();
+	float heat = writeMap.heat(patternTableAddress + 8 * character);
+	if (tableToShow > 0) {
+		heat = std::max(heat, writeMap.heat(nameAddress));
+	}
+	switch (screenMode) {
+	case 2:
+	case 4:
+		heat = std::max(heat, writeMap.heat(colorTableAddress + 8 * character));
+		break;
+	case 1:
+		heat = std::max(heat, writeMap.heat(colorTableAddress + (character >> 3)));
+		break;
+	}
+	return heat;
+}
+
+void VramTiledView::drawWriteOverlay(QPainter& qp) const
+{
+	// characters whose name, pattern or color bytes were recently written, in red
+	if (!vramBase) return;
+	switch (screenMode) {
+	case 0: case 1: case 2: case 3: case 4: case 80:
+		break;
+	default:
+		return;
+	}
+	float width = float(horiStep) * zoomFactor;
+	float height = 16.0f * zoomFactor;
+	for (int y = 0; y < screenHeight; ++y) {
+		for (int x = 0; x < screenWidth; ++x) {
+			unsigned nameAddress = nameTableAddress + x + y * screenWidth;
+			int character = x + y * screenWidth;
+			if (tableToShow > 0) {
+				character = vramBase[nameAddress];
+				if (screenMode == 2 || screenMode == 4) character += 256 * (y / 8);
+			} else if (!(screenMode == 2 || screenMode == 4)) {
+				character &= 255;
+			}
+			float heat = cellHeat(character, nameAddress);
+			if (heat <= 0.0f) continue;
+			qp.fillRect(QRectF(float(x) * width, float(y) * height, width, height),
+			            QColor(255, 0, 0, int(160.0f * heat)));
+		}
+	}
 }
 
 void VramTiledView::refresh()
 {
-	decodePalette();
 	decode();
 }
 
@@ -455,10 +591,7 @@ QString VramTiledView::textInfo(int x, int y, int character)
 	// Now the initial color data to be displayed
 	const auto* regs = VDPDataStore::instance().getRegsPointer();
 	QString colordata = QString("- VDP reg 7 is %1").arg(hexValue(regs[7], 2));
-	// If blink bit set then show alternate colors
-	if (screenMode == 80 && useBlink && (tableToShow > 0) &&
-	    (vramBase[colorTableAddress + (x >> 3) + 10 * y] & (1 << (7 - (7 & x)))))
-	{
+	if (isBlinking(x, y)) {
 		colordata = QString("- VDP reg 12 is %1").arg(hexValue(regs[12], 2));
 	} else if (screenMode == 1) {
 		colordata = QString("- %1: %2").arg(
@@ -484,6 +617,15 @@ QString VramTiledView::textInfo(int x, int y, int character)
 			colordata));
 		colordata.clear();
 	}
+
+	if (character < analysis.patterns()) {
+		info.append(QString("\nUsed %1 times in the name table").arg(analysis.usage(character)));
+		int original = analysis.original(character);
+		if (original != character) {
+			info.append(QString(", same pattern and colors as %1").arg(hexValue(original, 2)));
+		}
+		info.append('\n');
+	}
 	return info;
 }
 
@@ -534,43 +676,46 @@ std::optional<VramTiledView::MouseEventInfo> VramTiledView::infoFromMouseEvent(Q
 
 void VramTiledView::setBorderColor(int value)
 {
-	borderColor = std::clamp(value, 0, 15);
-	refresh();
+	value = std::clamp(value, 0, 15);
+	if (borderColor == value) return;
+	borderColor = value;
+	scheduleDecode();
 }
 
 void VramTiledView::setScreenMode(int mode)
 {
 	screenMode = mode;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setVramSource(const uint8_t* adr)
 {
 	vramBase = adr;
-	refresh();
+	scheduleDecode();
 }
 
 void VramTiledView::setNameTableAddress(int adr)
 {
 	nameTableAddress = adr;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setPatternTableAddress(int adr)
 {
 	patternTableAddress = adr;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setColorTableAddress(int adr)
 {
 	colorTableAddress = adr;
-	decode();
+	scheduleDecode();
 }
 
 void VramTiledView::setPaletteSource(const uint8_t* adr)
 {
 	if (palette == adr) return;
 	palette = adr;
-	refresh();
+	// another source with the same colors doesn't change the image
+	if (decodePalette()) scheduleDecode();
 }
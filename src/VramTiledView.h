@@ -1,6 +1,7 @@
 #ifndef VRAMBITMAPPEDVIEW
 #define VRAMBITMAPPEDVIEW
 
+#include "TileAnalysis.h"
 #include <QString>
 #include <QWidget>
 #include <QImage>
@@ -9,6 +10,9 @@
 #include <QColor>
 #include <cstdint>
 #include <optional>
+#include <vector>
+
+class QPainter;
 
 class VramTiledView : public QWidget
 {
@@ -36,6 +40,7 @@ public:
     [[nodiscard]] unsigned getPatternTableAddress() const;
     [[nodiscard]] unsigned getColorTableAddress() const;
     [[nodiscard]] int getScreenMode() const;
+    [[nodiscard]] const TileAnalysis& getAnalysis() const { return analysis; }
 
     void mousePressEvent(QMouseEvent* e) override;
     void mouseMoveEvent (QMouseEvent* e) override;
@@ -49,21 +54,29 @@ public:
     [[nodiscard]] const uint8_t* getPaletteSource() const;
 
     void refresh();
+    // the decoded image of the shown area, unzoomed
+    [[nodiscard]] QImage frame() const;
 
 signals:
     void imageHovered(int screenX, int screenY, int character);
     void imageClicked(int screenX, int screenY, int character, QString textinfo);
     void highlightCount(uint8_t character, int count);
+    void analyzed(); // getAnalysis() has new results
 
 private:
 	void paintEvent(QPaintEvent* e) override;
+	void drawWriteOverlay(QPainter& qp) const;
+	[[nodiscard]] float cellHeat(int character, unsigned nameAddress) const;
 
 	void decode();
-	void decodePalette();
+	void scheduleDecode();
+	void analyzeTiles();
+	[[nodiscard]] int nameTableRows() const;
+	[[nodiscard]] int imageWidth() const;
+	bool decodePalette(); // false when the palette didn't change
     void decodePatternTable();
     void decodeNameTable();
     void overLayNameTable();
-    void setPixel1x2(int x, int y, QRgb c);
     void setPixel2x2(int x, int y, QRgb c);
 	QRgb getColor(int c);
 
@@ -72,8 +85,25 @@ private:
     void decodeNameTableRegularChars();
     void decodeNameTableMultiColor();
     uint8_t getCharColorByte(int character, int x, int y, int row);
+    uint8_t getCharColorByte(int character, int row, bool blink);
+    bool isBlinking(int x, int y);
     void drawCharAt(int character, int x, int y); // Draw 8x8 character on given location in image
 
+    // One decoded character, together with the VRAM bytes it was decoded
+    // from. The name table is composed from these tiles, a tile is only
+    // decoded again when its pattern or color bytes changed.
+    struct Tile {
+        uint8_t pattern[8];
+        uint8_t colors[8];
+        unsigned checked = 0; // decode pass in which the bytes were compared
+        bool valid = false;
+        QRgb pixels[8][8];
+    };
+    // screen 2/4 have 768 characters, forced screen rows can reach a 4th bank
+    static constexpr int ATLAS_CHARS = 1024;
+    const Tile& getTile(int character, bool blink);
+    void validateAtlas();
+
     struct MouseEventInfo {
         int x, y;
         int character;
@@ -108,6 +138,16 @@ private:
     int highlightChar = -1; // anything outside 0-255 will do
     bool useBlink = false;
     bool tpBit = false;
+
+    std::vector<Tile> atlas; // all characters, then the same with the blink colors
+    // palette, border color and TP bit the tiles in the atlas were decoded with
+    uint32_t atlasPaletteVersion = 0;
+    int atlasBorderColor = -1;
+    bool atlasTpBit = false;
+    unsigned decodePass = 0;
+    uint32_t paletteVersion = 0; // of the colors in msxPalette
+    bool decodePending = false;
+    TileAnalysis analysis;
 };
 
 #endif // VRAMBITMAPPEDVIEW
@@ -0,0 +1,65 @@
+#include "VramWriteMap.h"
+#include "CommClient.h"
+#include "ranges.h"
+#include <QRegExp>
+#include <QStringList>
+#include <algorithm>
+
+// a few frames per batch keeps the fading smooth
+VramWriteMap::VramWriteMap()
+	: PolledCollector("vwrite", 100, nullptr)
+	, age(MAX_VRAM_SIZE >> BLOCK_SHIFT, FADE_FRAMES)
+{
+	connect(&CommClient::instance(), &CommClient::connectionTerminated,
+	        this, &VramWriteMap::connectionClosed);
+}
+
+VramWriteMap& VramWriteMap::instance()
+{
+	static VramWriteMap oneInstance;
+	return oneInstance;
+}
+
+void VramWriteMap::start()
+{
+	startCollecting(QString::number(BLOCK_SHIFT));
+}
+
+void VramWriteMap::stop()
+{
+	if (!isRunning()) return;
+	stopCollecting(false);
+	clear();
+}
+
+void VramWriteMap::clear()
+{
+	ranges::fill(age, FADE_FRAMES);
+	emit updated();
+}
+
+float VramWriteMap::heat(unsigned address) const
+{
+	unsigned block = address >> BLOCK_SHIFT;
+	if (block >= age.size()) return 0.0f;
+	return 1.0f - float(age[block]) / float(FADE_FRAMES);
+}
+
+void VramWriteMap::processReply(const QString& message)
+{
+	// a Tcl list with per frame the list of written blocks, oldest first
+	QRegExp frame("\\{([^}]*)\\}|(\\d+)");
+	int frames = 0;
+	for (int pos = 0; (pos = frame.indexIn(message, pos)) != -1; pos += frame.matchedLength()) {
+		for (auto& a : age) {
+			if (a < FADE_FRAMES) ++a;
+		}
+		QString blocks = frame.cap(2).isEmpty() ? frame.cap(1) : frame.cap(2);
+		for (const auto& b : blocks.split(' ', Qt::SplitBehaviorFlags::SkipEmptyParts)) {
+			unsigned block = b.toUInt();
+			if (block < age.size()) age[block] = 0;
+		}
+		++frames;
+	}
+	if (frames) emit updated();
+}
@@ -0,0 +1,49 @@
+#ifndef VRAMWRITEMAP_H
+#define VRAMWRITEMAP_H
+
+#include "PolledCollector.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Which blocks of VRAM the program writes, per frame. Watchpoints on the
+ * VDP data port mark the block of every written byte, openMSX closes the
+ * set of the current frame at the end of each frame. The debugger collects
+ * these sets a few times per second and turns them into a heat value per
+ * block that fades out over the following frames.
+ *
+ * openMSX also keeps the blocks written since VDPDataStore last asked for
+ * them, so its live mode can fetch only those. Starting a VDP command
+ * marks all of VRAM, since commands write without going through the port.
+ */
+class VramWriteMap : public PolledCollector
+{
+	Q_OBJECT
+public:
+	static constexpr int BLOCK_SHIFT = 6; // 64 byte blocks
+	static constexpr unsigned MAX_VRAM_SIZE = 0x30000;
+	static constexpr int FADE_FRAMES = 50;
+
+	static VramWriteMap& instance();
+
+	void start();
+	// the map is cleared instead of fetching the remaining frames
+	void stop() override;
+	void clear();
+
+	// 1 for a block written in the most recent frame, down to 0 for blocks
+	// not written in the last FADE_FRAMES frames; 'address' is physical
+	[[nodiscard]] float heat(unsigned address) const;
+
+signals:
+	void updated();
+
+private:
+	VramWriteMap();
+
+	void processReply(const QString& message) override;
+
+	std::vector<uint8_t> age; // frames since the last write, per block
+};
+
+#endif // VRAMWRITEMAP_H
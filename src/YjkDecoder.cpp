@@ -0,0 +1,31 @@
+#include "YjkDecoder.h"
+#include <algorithm>
+
+static int scale(int x)
+{
+	return (x << 3) | (x >> 2);
+}
+
+QRgb decodeYJKPixel(int y, int j, int k)
+{
+	int r = std::clamp(y + j, 0, 31);
+	int g = std::clamp(y + k, 0, 31);
+	int b = std::clamp((5 * y - 2 * j - k) / 4, 0, 31);
+	return qRgb(scale(r), scale(g), scale(b));
+}
+
+static YjkTables buildTables()
+{
+	YjkTables t;
+	for (int y = 0; y < 32; ++y) {
+		for (int jk = -32; jk < 32; ++jk) {
+			t.rg[y][jk + 32] = scale(std::clamp(y + jk, 0, 31));
+		}
+		for (int jjk = -96; jjk < 94; ++jjk) {
+			t.b[y][jjk + 96] = scale(std::clamp((5 * y - jjk) / 4, 0, 31));
+		}
+	}
+	return t;
+}
+
+const YjkTables yjkTables = buildTables();
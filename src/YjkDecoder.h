@@ -0,0 +1,45 @@
+#ifndef YJKDECODER_H
+#define YJKDECODER_H
+
+#include <QRgb>
+#include <cstdint>
+
+/**
+ * Decoding of the V9958 YJK (screen 12) and YJK+YAE (screen 10/11) pixel
+ * formats. Groups of four pixels share J and K. Instead of clamping and
+ * scaling every pixel, the color channels are looked up in small tables
+ * indexed by Y and J, K or 2J+K. Every table entry is the matching channel
+ * of decodeYJKPixel(), so the result is identical to that formula.
+ */
+struct YjkTables {
+	uint8_t rg[32][64];  // red from Y and J, green from Y and K (+32)
+	uint8_t b[32][190];  // blue from Y and 2*J+K (+96)
+};
+extern const YjkTables yjkTables;
+
+// the reference formula; 'y' is 5 bit, 'j' and 'k' are signed 6 bit values
+[[nodiscard]] QRgb decodeYJKPixel(int y, int j, int k);
+
+// four screen 12 pixels from four consecutive VRAM bytes
+inline void decodeYJK(const uint8_t p[4], QRgb out[4])
+{
+	int j = (p[2] & 7) + ((p[3] & 3) << 3) - ((p[3] & 4) << 3);
+	int k = (p[0] & 7) + ((p[1] & 3) << 3) - ((p[1] & 4) << 3);
+	int b = 2 * j + k + 96;
+	for (int n = 0; n < 4; ++n) {
+		int y = p[n] >> 3;
+		out[n] = qRgb(yjkTables.rg[y][j + 32], yjkTables.rg[y][k + 32], yjkTables.b[y][b]);
+	}
+}
+
+// four screen 10/11 pixels, bytes with bit 3 set are a palette color (YAE)
+// with only 4 bits of Y
+inline void decodeYJKYAE(const uint8_t p[4], const QRgb palette[16], QRgb out[4])
+{
+	decodeYJK(p, out);
+	for (int n = 0; n < 4; ++n) {
+		if (p[n] & 0x08) out[n] = palette[p[n] >> 4];
+	}
+}
+
+#endif // YJKDECODER_H
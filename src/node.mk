@@ -12,11 +12,17 @@ MOC_SRC_HDR:= \
 	VDPDataStore VDPStatusRegViewer VDPRegViewer InteractiveLabel \
 	InteractiveButton VDPCommandRegViewer GotoDialog SymbolTable \
 	TileViewer VramTiledView PaletteDialog VramSpriteView SpriteViewer \
-	BreakpointViewer
+	BreakpointViewer SymbolTableModel SymbolCompleter SourceViewer \
+	SampleProfiler HotSpotViewer CallProfiler CallTreeViewer \
+	AccessHeatmap CodeCoverage FrameBudget FrameBudgetViewer \
+	IoProfiler IoProfilerViewer Tracer TraceTableModel TraceViewer \
+	InstructionTrace InstructionTraceModel InstructionTraceViewer \
+	VramOverview VDPLiveControl VramWriteMap FrameRecorder PolledCollector
 
 SRC_HDR:= \
 	DockManager Dasm DasmTables DebuggerData SymbolTable Convert Version \
-	CPURegs SimpleHexRequest
+	CPURegs SimpleHexRequest LabelIndex SourceIndex SourceFile YjkDecoder \
+	SpriteCompositor PaletteLut TileAnalysis
 
 SRC_ONLY:= \
 	main